@@ -0,0 +1,299 @@
+# ----------------------------------------------------------------------------------
+#           file : make_linux.mk
+#    description : GNU/Linux makefile for the shared and static library of the controller
+#        toolbox : DotX Wind Turbine Control Software
+#         author : DotX Control Solutions, www.dotxcontrol.com
+# ----------------------------------------------------------------------------------
+#
+#   make -f make_linux.mk [PROFILE=<profile>] [PRECISION=float] [all|replay|accuracy|allocaudit|fastmath_check|farm|mcusreport|clean]
+#
+#   Builds build/linux/<profile>/libdiscon.so and libdiscon.a, the optimization
+#   profile is one of:
+#
+#     release   -O2 (default)
+#     native    -O3 -march=native, only for the machine it is built on
+#     lto       -O3 with link time optimization
+#     pgo       -O3 with profile guided optimization: an instrumented build
+#               first replays the bundled trace (build/replay) to collect the
+#               profile, after which the library is rebuilt with it
+#
+#   The target replay runs the real-time runner, linked against the library of
+#   the profile, over the bundled trace without waiting for the sample time and
+#   prints the execution times, to compare the profiles.
+#
+#   ALLOCAUDIT=1 builds the controller with the heap audit (DOTXALLOCAUDIT) in
+#   build/linux/<profile>-audit. The target allocaudit replays the bundled
+#   trace with that build and fails if the controller allocates or releases
+#   memory in any run sample.
+#
+#   The target fastmath_check sweeps the fast math kernels (suplib/fastmath.c)
+#   against the long double math library, 2*FASTMATHSWEEP+1 uniform arguments
+#   plus dense grids near zero and the poles, in double and single precision.
+#   It fails if the error exceeds the documented bound (FM_TAN_ULP).
+#
+#   The target farm measures the scaling curve of the multi-core wind farm
+#   executor (source/farm): FARMINSTANCES instances on the first sample of the
+#   bundled trace, from one up to FARMTHREADS threads. It fails if the executor
+#   or an instance reports an error.
+#
+#   The target mcusreport lists for every module of the run samples the fields
+#   of mcu_data_static it reads, including those in its initialization, and
+#   whether they are in the hot or the cold block of the struct (mcudata.h).
+#
+#   PRECISION=float builds the controller in single precision (REAL is float)
+#   in build/linux/<profile>-float. The target accuracy replays every trace of
+#   ACCURACYTRACES with every configuration of ACCURACYCFGS, in the double and 
+#   the single precision build, prints the largest error of every output and 
+#   fails if an output of any sample differs more than ACCURACYTOL times the 
+#   range of that output.
+
+# Compilation Options --------------------------------------------------------------
+# Only make changes in this section for different compilation options
+# Comment or uncomment options as needed
+
+# Wind turbine options
+OPTIONS += -DNR_BLADES=3
+OPTIONS += -DWINDDIRECTION=1
+
+# Simulation software options
+OPTIONS += -D_PHATAS_THROUGH_DISCON
+OPTIONS += -D_FAST_THROUGH_DISCON
+
+# Record histograms of the cycle time of every controller stage
+# OPTIONS += -DDOTXPROFILER
+
+# Count heap operations and report any allocation in the control loop
+# OPTIONS += -DDOTXALLOCAUDIT
+
+# Only log the fixed subset of channels marked 2 in signal_definitions_external.h
+# OPTIONS += -DDOTXLOGCORE
+
+# Use the math library instead of the fast math kernels in the control loop
+# OPTIONS += -DDOTXLIBM
+
+# Keep the floating-point mode of the host, snap subnormal filter and PID states to zero instead
+# OPTIONS += -DDOTXNOFTZ
+
+# Never use the heap: allocate from static pools sized at compile time (mcumemory.c)
+# OPTIONS += -DDOTXSTATICMEM
+
+# Read the parameter files in parallel and write their echo in the background
+OPTIONS += -DDOTXPARALLELINIT
+
+# Controller modules
+MODULES  = -D_DTDAMP
+MODULES += -D_FADAMP
+MODULES += -D_YAW
+
+# Enable/disable supervisory control
+SUPERVISORYCONTROL = 1
+MODULES += -D_SUP
+
+# Optimization profile
+PROFILE = release
+
+# Precision of REAL: double or float
+PRECISION = double
+
+# Replay trace used for the profile guided optimization and the replay target
+REPLAYCFG   = build/replay/controller.ini
+REPLAYTRACE = build/replay/trace.txt
+REPLAYSTEPS = 1000
+
+# Number of uniform arguments on each side of zero in the error sweep of the fast math kernels
+FASTMATHSWEEP = 10000000
+
+# Instances and largest number of threads of the scaling curve of the farm executor, 0 threads for all cores
+FARMINSTANCES = 16
+FARMTHREADS   = 4
+
+# Traces and tolerance of the comparison between the double and single precision build
+ACCURACYCFGS   = $(REPLAYCFG) build/replay/controller_all.ini
+ACCURACYTRACES = $(REPLAYTRACE) build/replay/trace_ramp.txt
+ACCURACYTOL    = 1e-3
+
+
+# Makefile definitions ---------------------------------------------------------------
+
+CC      = gcc
+AR      = gcc-ar
+SRCDIR  = source
+OUTDIR  = build/linux/$(PROFILE)$(SUFFIX)
+OBJDIR  = $(OUTDIR)/obj
+LIB     = -lpthread -lm -ldl
+
+ifeq ($(PROFILE),release)
+	OPT = -O2
+endif
+ifeq ($(PROFILE),native)
+	OPT = -O3 -march=native
+endif
+ifeq ($(PROFILE),lto)
+	OPT = -O3 -flto=auto -fuse-linker-plugin
+endif
+ifeq ($(PROFILE),pgo)
+	OPT = -O3 -fprofile-use -fprofile-correction -Wno-missing-profile
+endif
+ifeq ($(PROFILE),pgo-train)
+	OPT = -O3 -fprofile-generate
+	OUTDIR = build/linux/pgo$(SUFFIX)
+endif
+ifndef OPT
+$(error Unknown PROFILE $(PROFILE), use release, native, lto or pgo)
+endif
+
+ifeq ($(PRECISION),float)
+	OPTIONS += -DFLOATPRECISION
+	SUFFIX = -float
+endif
+
+ifeq ($(ALLOCAUDIT),1)
+	OPTIONS += -DDOTXALLOCAUDIT
+	SUFFIX := $(SUFFIX)-audit
+endif
+
+# The entry points are called through the library, calls inside it can be inlined
+FLAGS   = $(OPT) -fPIC -fno-semantic-interposition -fcommon -pthread
+
+mcu     = maincontrollerunit readconfiguration mcumemory
+SRC     = $(addprefix $(SRCDIR)/, $(mcu:%=%.c))
+
+support = matrix system filter pid par_readline par_readstruct par_echo bicubic hp_pid checkpoint debugger allocaudit profiler platform fastmath health arena staticmem
+SRC     += $(addprefix $(SRCDIR)/suplib/, $(support:%=%.c))
+
+mcudata = mcudatastatic mcudatadynamic mcureadfile mcushed mcuschedule mcuderive
+SRC     += $(addprefix $(SRCDIR)/turbine/, $(mcudata:%=%.c))
+
+logdata = logdata
+SRC     += $(addprefix $(SRCDIR)/logdata/, $(logdata:%=%.c))
+
+interface = phataswrapper matlabwrapper bladedwrapper bladedlogsignals
+SRC     += $(addprefix $(SRCDIR)/interface/, $(interface:%=%.c))
+
+controller = basecontroller base_rotorspeed base_fa_damping base_dt_damping  base_yaw_control
+SRC     += $(addprefix $(SRCDIR)/basecontrol/, $(controller:%=%.c))
+
+operation = operation powerproduction fastshutdown
+SRC     += $(addprefix $(SRCDIR)/operation/, $(operation:%=%.c))
+
+farm    = mcufarm
+SRC     += $(addprefix $(SRCDIR)/farm/, $(farm:%=%.c))
+
+ifdef SUPERVISORYCONTROL
+	supervisor = supdatastatic supdatadynamic supreadfile supervisory triggerdetection postprocedure
+	SRC     += $(addprefix $(SRCDIR)/supervisor/, $(supervisor:%=%.c))
+endif
+
+# Modules of the run samples, for the report of the fields of mcu_data_static
+STEPSRC = $(SRCDIR)/maincontrollerunit.c $(SRCDIR)/turbine/mcushed.c
+STEPSRC += $(addprefix $(SRCDIR)/basecontrol/, $(controller:%=%.c))
+STEPSRC += $(addprefix $(SRCDIR)/operation/, $(operation:%=%.c))
+ifdef SUPERVISORYCONTROL
+	STEPSRC += $(SRCDIR)/supervisor/supervisory.c $(SRCDIR)/supervisor/triggerdetection.c $(SRCDIR)/supervisor/postprocedure.c
+endif
+
+rt      = rtrunner rtmain
+RTSRC   = $(addprefix $(SRCDIR)/rt/, $(rt:%=%.c))
+
+OBJ     = $(addprefix $(OBJDIR)/, $(notdir $(SRC:%.c=%.o)))
+RTOBJ   = $(addprefix $(OBJDIR)/, $(notdir $(RTSRC:%.c=%.o)))
+
+SO      = $(OUTDIR)/libdiscon.so
+AS      = $(OUTDIR)/libdiscon.a
+RUNNER  = $(OUTDIR)/dotx_replay
+
+vpath %.c $(sort $(dir $(SRC) $(RTSRC)))
+
+
+# Compile and Link
+
+all: $(SO) $(AS)
+
+$(OBJDIR)/%.o : %.c
+	@mkdir -p $(OBJDIR)
+	$(CC) -c $< $(FLAGS) $(MODULES) $(OPTIONS) -o $@
+
+$(SO) : $(OBJ)
+	$(CC) -shared $(FLAGS) $(OBJ) $(LIB) -o $@
+
+$(AS) : $(OBJ)
+	rm -f $@
+	$(AR) rcs $@ $(OBJ)
+
+$(RUNNER) : $(RTOBJ) $(AS)
+	$(CC) $(FLAGS) $(RTOBJ) $(AS) $(LIB) -o $@
+
+replay: all $(RUNNER)
+	@mkdir -p build/replay/out
+	./$(RUNNER) -r -p 0 -c $(REPLAYCFG) -i $(REPLAYTRACE) -n $(REPLAYSTEPS) 2>/dev/null
+
+# Profile guided optimization: train an instrumented build on the replay trace
+# in the same object directory, so the profile matches the objects of the final build
+ifeq ($(PROFILE),pgo)
+$(OBJ) $(RTOBJ) : $(OUTDIR)/profile.stamp
+
+$(OUTDIR)/profile.stamp : $(SRC) $(RTSRC) $(REPLAYTRACE)
+	rm -rf $(OBJDIR)
+	$(MAKE) -f make_linux.mk PROFILE=pgo-train PRECISION=$(PRECISION) replay
+	rm -f $(OBJDIR)/*.o $(SO) $(AS) $(RUNNER)
+	touch $@
+endif
+
+# Compare the outputs of the single precision build with the double precision build
+accuracy:
+	$(MAKE) -f make_linux.mk PROFILE=$(PROFILE) PRECISION=double runner
+	$(MAKE) -f make_linux.mk PROFILE=$(PROFILE) PRECISION=float runner
+	@mkdir -p build/replay/out
+	@for cfg in $(ACCURACYCFGS); do for trace in $(ACCURACYTRACES); do \
+		./build/linux/$(PROFILE)/dotx_replay       -r -p 0 -c $$cfg -i $$trace -n `grep -vc '^#' $$trace` -o build/replay/out/double.txt 2>/dev/null >/dev/null; \
+		./build/linux/$(PROFILE)-float/dotx_replay -r -p 0 -c $$cfg -i $$trace -n `grep -vc '^#' $$trace` -o build/replay/out/float.txt  2>/dev/null >/dev/null; \
+		paste build/replay/out/double.txt build/replay/out/float.txt | awk -v tol=$(ACCURACYTOL) -v run="`basename $$cfg .ini` `basename $$trace .txt`" ' \
+			{ n = NF/2; for ( k = 1; k <= n; ++k ) { \
+				d = $$k - $$(k+n); if ( d < 0 ) d = -d; if ( d > err[k] ) err[k] = d; \
+				if ( NR == 1 || $$k < lo[k] ) lo[k] = $$k; if ( NR == 1 || $$k > hi[k] ) hi[k] = $$k; } } \
+			END { fail = ( NR == 0 ); for ( k = 1; k <= n; ++k ) { \
+				rng = hi[k] - lo[k]; if ( rng < 1e-12 ) rng = ( hi[k] > -hi[k] ? hi[k] : -hi[k] ); if ( rng < 1e-12 ) rng = 1; \
+				printf( "[acc]  %s output %2d : max error %.3e, %.3e of range%s\n", run, k-1, err[k], err[k]/rng, err[k]/rng > tol ? "  <err>" : "" ); \
+				if ( err[k]/rng > tol ) fail = 1; } exit fail }' || exit 1; \
+	done; done
+
+runner: all $(RUNNER)
+
+# Replay the trace with the heap audit, fails on any heap operation of the controller in a run sample
+allocaudit:
+	$(MAKE) -f make_linux.mk PROFILE=$(PROFILE) PRECISION=$(PRECISION) ALLOCAUDIT=1 runner
+	@mkdir -p build/replay/out
+	./build/linux/$(PROFILE)$(SUFFIX)-audit/dotx_replay -r -p 0 -c $(REPLAYCFG) -i $(REPLAYTRACE) -n $(REPLAYSTEPS) 2>/dev/null
+
+# Error sweep of the fast math kernels in both precisions, fails above the documented bound
+fastmath_check:
+	@mkdir -p $(OUTDIR)
+	$(CC) $(FLAGS) $(filter-out -DFLOATPRECISION,$(OPTIONS)) $(SRCDIR)/suplib/fastmath_check.c $(SRCDIR)/suplib/fastmath.c -lm -o $(OUTDIR)/fastmath_check
+	$(CC) $(FLAGS) $(filter-out -DFLOATPRECISION,$(OPTIONS)) -DFLOATPRECISION $(SRCDIR)/suplib/fastmath_check.c $(SRCDIR)/suplib/fastmath.c -lm -o $(OUTDIR)/fastmath_check-float
+	./$(OUTDIR)/fastmath_check       $(FASTMATHSWEEP)
+	./$(OUTDIR)/fastmath_check-float $(FASTMATHSWEEP)
+
+farm: all $(RUNNER)
+	./$(RUNNER) -c $(REPLAYCFG) -i $(REPLAYTRACE) -n $(REPLAYSTEPS) -m $(FARMINSTANCES) -j $(FARMTHREADS) 2>/dev/null
+
+# Fields of mcu_data_static read by the modules of the run samples, per block of the struct
+mcusreport:
+	@mkdir -p build/linux
+	@awk '/Hot block/ { b = "hot" } /Cold block/ { b = "cold" } /} mcu_data_static;/ { b = "" } \
+		b != "" && $$1 ~ /^(int|REAL|char)$$/ { f = $$2; sub( /\[.*/, "", f ); print f, b }' \
+		$(SRCDIR)/turbine/mcudata.h > build/linux/mcus_blocks.txt
+	@for src in $(STEPSRC); do \
+		grep -o 'MCUS->[A-Za-z0-9_]*' $$src | sed 's/MCUS->//' | sort -u | \
+		awk -v mod=`basename $$src .c` 'NR == FNR { blk[$$1] = $$2; next } \
+			{ n[blk[$$1]]++; f[blk[$$1]] = f[blk[$$1]] " " $$1 } \
+			END { printf( "[mcus] %-20s hot  %3d :%s\n", mod, n["hot"], f["hot"] ); \
+			      printf( "[mcus] %-20s cold %3d :%s\n", mod, n["cold"], f["cold"] ) }' build/linux/mcus_blocks.txt -; \
+	done | tee build/linux/mcus_report.txt
+	@grep -ho 'MCUS->[A-Za-z0-9_]*' $(STEPSRC) | sed 's/MCUS->//' | sort -u | \
+		awk 'NR == FNR { blk[$$1] = $$2; if ( $$2 == "hot" ) ++nhot; next } blk[$$1] == "hot" { ++nread } \
+		END { printf( "[mcus] %d of %d fields of the hot block are read\n", nread, nhot ) }' build/linux/mcus_blocks.txt - | tee -a build/linux/mcus_report.txt
+
+clean:
+	rm -rf $(OUTDIR) build/replay/out
+
+.PHONY: all replay accuracy allocaudit fastmath_check runner farm mcusreport clean
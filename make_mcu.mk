@@ -23,6 +23,27 @@ OPTIONS += -D_DOTX_GLOG_
 # Enable (new) debugging
 # OPTIONS += -DDOTXDEBUGGER
 
+# Count heap operations and report any allocation in the control loop
+# OPTIONS += -DDOTXALLOCAUDIT
+
+# Only log the fixed subset of channels marked 2 in signal_definitions_external.h
+# OPTIONS += -DDOTXLOGCORE
+
+# Use the math library instead of the fast math kernels in the control loop
+# OPTIONS += -DDOTXLIBM
+
+# Keep the floating-point mode of the host, snap subnormal filter and PID states to zero instead
+# OPTIONS += -DDOTXNOFTZ
+
+# Never use the heap: allocate from static pools sized at compile time (mcumemory.c)
+# OPTIONS += -DDOTXSTATICMEM
+
+# Record histograms of the cycle time of every controller stage
+# OPTIONS += -DDOTXPROFILER
+
+# Single precision controller (REAL is float), for targets with a single precision FPU only
+# OPTIONS += -DFLOATPRECISION
+
 # Controller modules
 MODULES  = -D_DTDAMP
 MODULES += -D_FADAMP 
@@ -42,6 +63,12 @@ MODULES += -D_SUP
 TXTLOGGING = 1
 #SQLLOGGING = 1
 
+# Enable the multi-core wind farm executor (requires pthreads)
+#FARMEXECUTOR = 1
+
+# Read the parameter files in parallel and write their echo in the background (requires pthreads)
+#PARALLELINIT = 1
+
 
 # Makefile definitions ---------------------------------------------------------------
 
@@ -56,15 +83,15 @@ F90SRC  = $(addprefix $(SRCDIR)/interface/, fastwrapper_fortran.f90)
 F90OBJ  = fastwrapper_fortran.o
 F90OPT  = -cpp -mrtd -fno-underscoring -fmessage-length=0 -ffree-line-length-none -fno-automatic -ffloat-store
 
-mcu     = maincontrollerunit readconfiguration
+mcu     = maincontrollerunit readconfiguration mcumemory
 SRC     = $(addprefix $(SRCDIR)/, $(mcu:%=%.c))
 OBJ     = $(mcu:%=%.o)
 
-support = matrix system filter pid par_readline par_readstruct bicubic hp_pid debugger
+support = matrix system filter pid par_readline par_readstruct par_echo bicubic hp_pid checkpoint debugger allocaudit profiler platform fastmath health arena staticmem
 SRC     += $(addprefix $(SRCDIR)/suplib/, $(support:%=%.c))
 OBJ     += $(support:%=%.o)
 
-mcudata = mcudatastatic mcudatadynamic mcureadfile
+mcudata = mcudatastatic mcudatadynamic mcureadfile mcushed mcuschedule mcuderive
 SRC     += $(addprefix $(SRCDIR)/turbine/, $(mcudata:%=%.c))
 OBJ     += $(mcudata:%=%.o)
 
@@ -105,6 +132,18 @@ ifdef SIMULATIONMODULE
 	OBJ     += $(simulation:%=%.o)
 endif
 
+ifdef FARMEXECUTOR
+	farm = mcufarm
+	SRC     += $(addprefix $(SRCDIR)/farm/, $(farm:%=%.c))
+	OBJ     += $(farm:%=%.o)
+	LIB     += -lpthread
+endif
+
+ifdef PARALLELINIT
+	OPTIONS += -DDOTXPARALLELINIT
+	LIB     += -lpthread
+endif
+
 
 
 # Compile and Link
@@ -0,0 +1,107 @@
+# ----------------------------------------------------------------------------------
+#           file : make_rt.mk
+#    description : GNU/Linux makefile for the real-time runner of the controller
+#        toolbox : DotX Wind Turbine Control Software
+#         author : DotX Control Solutions, www.dotxcontrol.com
+# ----------------------------------------------------------------------------------
+
+# Compilation Options --------------------------------------------------------------
+# Only make changes in this section for different compilation options
+# Comment or uncomment options as needed
+
+# Wind turbine options
+OPTIONS += -DNR_BLADES=3
+OPTIONS += -DWINDDIRECTION=1
+
+# Record histograms of the cycle time of every controller stage
+# OPTIONS += -DDOTXPROFILER
+
+# Single precision controller (REAL is float), for targets with a single precision FPU only
+# OPTIONS += -DFLOATPRECISION
+
+# Count heap operations and report any allocation in the control loop
+# OPTIONS += -DDOTXALLOCAUDIT
+
+# Only log the fixed subset of channels marked 2 in signal_definitions_external.h
+# OPTIONS += -DDOTXLOGCORE
+
+# Use the math library instead of the fast math kernels in the control loop
+# OPTIONS += -DDOTXLIBM
+
+# Keep the floating-point mode of the host, snap subnormal filter and PID states to zero instead
+# OPTIONS += -DDOTXNOFTZ
+
+# Never use the heap: allocate from static pools sized at compile time (mcumemory.c)
+# OPTIONS += -DDOTXSTATICMEM
+
+# Read the parameter files in parallel and write their echo in the background
+OPTIONS += -DDOTXPARALLELINIT
+
+# Controller modules
+MODULES  = -D_DTDAMP
+MODULES += -D_FADAMP 
+MODULES += -D_YAW 
+
+# Enable/disable supervisory control
+SUPERVISORYCONTROL = 1
+MODULES += -D_SUP
+
+
+# Makefile definitions ---------------------------------------------------------------
+
+CC      = gcc
+SRCDIR  = source
+FLAGS   = -O2 -fcommon -pthread
+OUT     = build/dotx_rt
+OBJDIR  = build/obj_rt
+LIB     = -lpthread -lm -ldl
+
+mcu     = maincontrollerunit readconfiguration mcumemory
+SRC     = $(addprefix $(SRCDIR)/, $(mcu:%=%.c))
+
+support = matrix system filter pid par_readline par_readstruct par_echo bicubic hp_pid checkpoint allocaudit profiler platform fastmath health arena staticmem
+SRC     += $(addprefix $(SRCDIR)/suplib/, $(support:%=%.c))
+
+mcudata = mcudatastatic mcudatadynamic mcureadfile mcushed mcuschedule mcuderive
+SRC     += $(addprefix $(SRCDIR)/turbine/, $(mcudata:%=%.c))
+
+logdata = logdata
+SRC     += $(addprefix $(SRCDIR)/logdata/, $(logdata:%=%.c))
+
+controller = basecontroller base_rotorspeed base_fa_damping base_dt_damping  base_yaw_control
+SRC     += $(addprefix $(SRCDIR)/basecontrol/, $(controller:%=%.c))
+
+operation = operation powerproduction fastshutdown
+SRC     += $(addprefix $(SRCDIR)/operation/, $(operation:%=%.c))
+
+ifdef SUPERVISORYCONTROL
+	supervisor = supdatastatic supdatadynamic supreadfile supervisory triggerdetection postprocedure
+	SRC     += $(addprefix $(SRCDIR)/supervisor/, $(supervisor:%=%.c))
+endif
+
+farm    = mcufarm
+SRC     += $(addprefix $(SRCDIR)/farm/, $(farm:%=%.c))
+
+rt      = rtrunner rtmain
+SRC     += $(addprefix $(SRCDIR)/rt/, $(rt:%=%.c))
+
+OBJ     = $(addprefix $(OBJDIR)/, $(notdir $(SRC:%.c=%.o)))
+
+vpath %.c $(sort $(dir $(SRC)))
+
+
+# Compile and Link
+
+all: $(OUT)
+
+$(OBJDIR)/%.o : %.c
+	@mkdir -p $(OBJDIR)
+	$(CC) -c $< $(FLAGS) $(MODULES) $(OPTIONS) -o $@
+
+$(OUT) : $(OBJ)
+	$(CC) $(FLAGS) $(OBJ) $(LIB) -o $@
+
+clean:
+	rm -rf $(OBJDIR) $(OUT)
+
+.PHONY: all clean
@@ -50,32 +50,9 @@ int base_dt_damping (
     /* Filter the rotor speed */
     
     OmR_DT[ 0 ] = OmR;
-    for ( k = 0; k < N_FILTERS; ++k ) 
-        filter_output_sca ( MCUD->DTrtsp[k] , OmR_DT+k , OmR_DT+k+1 , iStatus );
+    filter_chain_output ( MCUD->DTrtsp , N_FILTERS , &MCUD->DTrtsp_Chain , OmR_DT , iStatus );
     
-    /* Set PID */
-    
-    pid_setGains_sca (  
-    
-        MCUD->PID_DTdamp     , 
-        MCUS->DTdamp_Kp      ,
-        MCUS->DTdamp_Ki      ,
-        MCUS->DTdamp_Kd      ,
-        MCUS->Ts
-        
-    );
-    
-    pid_setConstraints_sca (   
-    
-        MCUD->PID_DTdamp     , 
-        MCUS->DTdamp_Min     ,
-        MCUS->DTdamp_Max     ,
-        MCUS->DTdamp_RateMin ,
-        MCUS->DTdamp_RateMax  
-        
-    );
-    
-    /* Obtain PID output */
+    /* Obtain PID output, the gains and constraints are set by mcu_derive() */
 
     pid_output_sca ( MCUD->PID_DTdamp, &OmR_DT[ N_FILTERS ], &MCUD->DTdamp_Dem_Torq, dTorq_dt, iStatus );
     
@@ -94,23 +71,23 @@ int base_dt_damping (
     
     /* Store signals */ 
     
-    pLogdata [ BASE_DTD_OMR           ] = OmR                         ;
-    pLogdata [ BASE_DTD_OMR_HPF       ] = OmR_DT[ N_HPF_FILTERS ];
-    pLogdata [ BASE_DTD_OMR_NFP       ] = OmR_DT[ N_HPF_FILTERS+N_NFP_FILTERS ];   
-    pLogdata [ BASE_DTD_OMR_NFF       ] = OmR_DT[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS ];
-    pLogdata [ BASE_DTD_OMR_LPF       ] = OmR_DT[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS+N_LPF_FILTERS ];
-    pLogdata [ BASE_DTD_MIN           ] = MCUS->DTdamp_Min            ;
-    pLogdata [ BASE_DTD_MAX           ] = MCUS->DTdamp_Max            ;
-    pLogdata [ BASE_DTD_MIN_SPD       ] = MCUS->DTdamp_RateMin        ;
-    pLogdata [ BASE_DTD_MAX_SPD       ] = MCUS->DTdamp_RateMax        ;
-    pLogdata [ BASE_DTD_KP            ] = MCUS->DTdamp_Kp             ;
-    pLogdata [ BASE_DTD_KI            ] = MCUS->DTdamp_Ki             ;
-    pLogdata [ BASE_DTD_KD            ] = MCUS->DTdamp_Kd             ;
-    pLogdata [ BASE_DTD_ERROR         ] = OmR_DT[ N_FILTERS ]         ;
-    pLogdata [ BASE_DTD_SETPOINT      ] = R_(0.0)                     ;
-    pLogdata [ BASE_DTD_PIDOUT        ] = *dTorq_dt                   ;
-    pLogdata [ BASE_DTD_DEM_TORQ      ] = MCUD->DTdamp_Dem_Torq       ;
-    pLogdata [ BASE_DTD_DEM_TORQ_FILT ] = MCUD->DTdamp_Dem_Torq_FILT  ;
+    LOG_STORE( pLogdata, BASE_DTD_OMR           , OmR                          );
+    LOG_STORE( pLogdata, BASE_DTD_OMR_HPF       , OmR_DT[ N_HPF_FILTERS ] );
+    LOG_STORE( pLogdata, BASE_DTD_OMR_NFP       , OmR_DT[ N_HPF_FILTERS+N_NFP_FILTERS ] );
+    LOG_STORE( pLogdata, BASE_DTD_OMR_NFF       , OmR_DT[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS ] );
+    LOG_STORE( pLogdata, BASE_DTD_OMR_LPF       , OmR_DT[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS+N_LPF_FILTERS ] );
+    LOG_STORE( pLogdata, BASE_DTD_MIN           , MCUS->DTdamp_Min             );
+    LOG_STORE( pLogdata, BASE_DTD_MAX           , MCUS->DTdamp_Max             );
+    LOG_STORE( pLogdata, BASE_DTD_MIN_SPD       , MCUS->DTdamp_RateMin         );
+    LOG_STORE( pLogdata, BASE_DTD_MAX_SPD       , MCUS->DTdamp_RateMax         );
+    LOG_STORE( pLogdata, BASE_DTD_KP            , MCUS->DTdamp_Kp              );
+    LOG_STORE( pLogdata, BASE_DTD_KI            , MCUS->DTdamp_Ki              );
+    LOG_STORE( pLogdata, BASE_DTD_KD            , MCUS->DTdamp_Kd              );
+    LOG_STORE( pLogdata, BASE_DTD_ERROR         , OmR_DT[ N_FILTERS ]          );
+    LOG_STORE( pLogdata, BASE_DTD_SETPOINT      , R_(0.0)                      );
+    LOG_STORE( pLogdata, BASE_DTD_PIDOUT        , *dTorq_dt                    );
+    LOG_STORE( pLogdata, BASE_DTD_DEM_TORQ      , MCUD->DTdamp_Dem_Torq        );
+    LOG_STORE( pLogdata, BASE_DTD_DEM_TORQ_FILT , MCUD->DTdamp_Dem_Torq_FILT   );
     
     /* Report error code */
     
@@ -49,7 +49,6 @@ int base_fa_damping(
 	fa_pitch_max        ,
 	fa_HPLP				,
 	fa_HP				;
-	REAL Tfade;
 	REAL    Kp, Ki, Kd;
 
 	/* Set transfer function of variable speed notch filters */
@@ -62,8 +61,7 @@ int base_fa_damping(
 
 	/* Filter the fore-aft acceleration */
 	Afa_F[ 0 ] = Afa+R_(0.0);
-	for ( k = 0; k < N_FILTERS; ++k )
-		filter_output_sca ( MCUD->FAAcc[k] , Afa_F+k , Afa_F+k+1 , iStatus );
+	filter_chain_output ( MCUD->FAAcc , N_FILTERS , &MCUD->FAAcc_Chain , Afa_F , iStatus );
 
 	/* FA collective pitch angle limits as function of power */
 	*AmplFA = interp1 ( MCUS->FAdamp_AmpSchedule, MCUS->FAdamp_Amplitude, MCUS->FAdamp_AmpSched_N, Powf );
@@ -86,19 +84,17 @@ int base_fa_damping(
 	Kd = interp1 ( MCUS->FAdamp_Schedule , MCUS->FAdamp_Kd , MCUS->FAdamp_Sched_N , Pitf );
 
 	/* Apply PID */
-	pid_setGains_sca (  MCUD->PID_FAdamp, Kp, 0.02*Ki, Kd, MCUS->Ts );
+	pid_setGains_sca (  MCUD->PID_FAdamp, Kp, R_(0.02)*Ki, Kd, MCUS->Ts );
 
 	// Second order highpass filter
-	static Filter * pFiltHP ;
 	if ( iStatus == MCU_STATUS_INIT ) {
 		REAL wn1;
-		wn1 = R_(0.04)*(2.0)*M_PI;
+		wn1 = R_(0.04)*R_(2.0)*R_(M_PI);
 
-		pFiltHP = filter_initEmpty();
-		filter_setHighPass_sca( pFiltHP, R_(2.0), wn1, MCUS->Ts );
+		filter_setHighPass_sca( MCUD->FAdamp_HPF, R_(2.0), wn1, MCUS->Ts );
 	}
 
-	filter_output_sca ( pFiltHP , &Afa_F[ N_FILTERS ] , &Afa_F[ N_FILTERS ] , iStatus ); // The Highpass filter must be the last filter used due to the nonlinear effects of the P-filters to ensure a zero-mean output.
+	filter_output_sca ( MCUD->FAdamp_HPF , &Afa_F[ N_FILTERS ] , &Afa_F[ N_FILTERS ] , iStatus ); // The Highpass filter must be the last filter used due to the nonlinear effects of the P-filters to ensure a zero-mean output.
 
 
 	pid_setConstraints_sca (
@@ -122,8 +118,7 @@ int base_fa_damping(
 	pid_output_sca ( MCUD->PID_FAdamp, &Afa_Act, &MCUD->FAdamp_Dem_Pitch, dPit_fa, iStatus );
 
 	/* Update the control output and apply a highpass filter to ensure a zero-mean output. */
-	Tfade = R_(50.0) ;
-	MCUD->FAdamp_Dem_Pitch =  exp((-MCUS->Ts)/Tfade) * MCUD->FAdamp_Dem_Pitch + *dPit_fa;
+	MCUD->FAdamp_Dem_Pitch =  MCUS->FAdamp_Fade * MCUD->FAdamp_Dem_Pitch + *dPit_fa;
 
 	/* Overload output if open loop damping is required */
 	if ( REC->iFAdampingOpenLoop ) {
@@ -149,27 +144,27 @@ int base_fa_damping(
 	}
 
 	/* Store signals */
-	pLogdata [ BASE_FAD_FOREAFTACC      ] =   Afa                       ;
-	pLogdata [ BASE_FAD_FOREAFTACC_HPF  ] =   Afa_F [ N_HPF_FILTERS ];
-	pLogdata [ BASE_FAD_FOREAFTACC_NFP  ] =   Afa_F [ N_HPF_FILTERS+N_NFP_FILTERS ];
-	pLogdata [ BASE_FAD_FOREAFTACC_NFF  ] =   Afa_F [ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS ];
-	pLogdata [ BASE_FAD_FOREAFTACC_LPF  ] =   Afa_F [ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS+N_LPF_FILTERS ];
-	pLogdata [ BASE_FAD_PITSPD_MIN      ] =   fa_speed_min              ;
-	pLogdata [ BASE_FAD_PITSPD_MAX      ] =   fa_speed_max              ;
-	pLogdata [ BASE_FAD_PITSPD_MIN_LPF  ] =   fa_speed_min_LPF          ;
-	pLogdata [ BASE_FAD_PITSPD_MAX_LPF  ] =   fa_speed_max_LPF          ;
-	pLogdata [ BASE_FAD_MIN             ] =   fa_pitch_min              ;
-	pLogdata [ BASE_FAD_MAX             ] =   fa_pitch_max              ;
-	pLogdata [ BASE_FAD_MIN_SPD         ] =   fa_speed_min_LPF  * (*AmplFA) ;
-	pLogdata [ BASE_FAD_MAX_SPD         ] =   fa_speed_max_LPF  * (*AmplFA)  ;
-	pLogdata [ BASE_FAD_KP              ] =   Kp                        ;
-	pLogdata [ BASE_FAD_KI              ] =   Ki                        ;
-	pLogdata [ BASE_FAD_KD              ] =   Kd                        ;
-	pLogdata [ BASE_FAD_ERROR           ] =   Afa_Act			        ;
-	pLogdata [ BASE_FAD_SETPOINT        ] =   R_(0.0)                   ;
-	pLogdata [ BASE_FAD_PIDOUT          ] =  *dPit_fa                   ;
-	pLogdata [ BASE_FAD_AMPLITUDE       ] =   (*AmplFA)                     ;
-	pLogdata [ BASE_FAD_DEM_PIT         ] =   MCUD->FAdamp_Dem_Pitch     ;
+	LOG_STORE( pLogdata, BASE_FAD_FOREAFTACC      , Afa                        );
+	LOG_STORE( pLogdata, BASE_FAD_FOREAFTACC_HPF  , Afa_F [ N_HPF_FILTERS ] );
+	LOG_STORE( pLogdata, BASE_FAD_FOREAFTACC_NFP  , Afa_F [ N_HPF_FILTERS+N_NFP_FILTERS ] );
+	LOG_STORE( pLogdata, BASE_FAD_FOREAFTACC_NFF  , Afa_F [ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS ] );
+	LOG_STORE( pLogdata, BASE_FAD_FOREAFTACC_LPF  , Afa_F [ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS+N_LPF_FILTERS ] );
+	LOG_STORE( pLogdata, BASE_FAD_PITSPD_MIN      , fa_speed_min               );
+	LOG_STORE( pLogdata, BASE_FAD_PITSPD_MAX      , fa_speed_max               );
+	LOG_STORE( pLogdata, BASE_FAD_PITSPD_MIN_LPF  , fa_speed_min_LPF           );
+	LOG_STORE( pLogdata, BASE_FAD_PITSPD_MAX_LPF  , fa_speed_max_LPF           );
+	LOG_STORE( pLogdata, BASE_FAD_MIN             , fa_pitch_min               );
+	LOG_STORE( pLogdata, BASE_FAD_MAX             , fa_pitch_max               );
+	LOG_STORE( pLogdata, BASE_FAD_MIN_SPD         , fa_speed_min_LPF  * (*AmplFA)  );
+	LOG_STORE( pLogdata, BASE_FAD_MAX_SPD         , fa_speed_max_LPF  * (*AmplFA)   );
+	LOG_STORE( pLogdata, BASE_FAD_KP              , Kp                         );
+	LOG_STORE( pLogdata, BASE_FAD_KI              , Ki                         );
+	LOG_STORE( pLogdata, BASE_FAD_KD              , Kd                         );
+	LOG_STORE( pLogdata, BASE_FAD_ERROR           , Afa_Act			         );
+	LOG_STORE( pLogdata, BASE_FAD_SETPOINT        , R_(0.0)                    );
+	LOG_STORE( pLogdata, BASE_FAD_PIDOUT          , *dPit_fa                    );
+	LOG_STORE( pLogdata, BASE_FAD_AMPLITUDE       , (*AmplFA)                      );
+	LOG_STORE( pLogdata, BASE_FAD_DEM_PIT         , MCUD->FAdamp_Dem_Pitch      );
 
 
 
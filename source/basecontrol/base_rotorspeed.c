@@ -41,31 +41,43 @@ int base_rotorspeed (
     REAL    Ts      = MCUS->Ts       ;
     
     /* Local variables */
-    REAL    KI           ,
-            KD           ,
-            Error_torque ,
+    REAL    Error_torque ,
             Error_pitch  ;
 
-    static int stepfinished = 0;
     /* --------------------------------------------------------------------------
      Rotor speed control by Generator Torque
     -------------------------------------------------------------------------- */
 
-    /* Compute speed controller parameters from schedule */
-    REAL KP_Torq = interp1( MCUS->RotSpd_Torq_Schedule, MCUS->RotSpd_Torq_Kp, MCUS->RotSpd_Torq_Sched_N, Powf );
-    REAL TI_Torq = interp1( MCUS->RotSpd_Torq_Schedule, MCUS->RotSpd_Torq_Ti, MCUS->RotSpd_Torq_Sched_N, Powf );
-    REAL TD_Torq = interp1( MCUS->RotSpd_Torq_Schedule, MCUS->RotSpd_Torq_Td, MCUS->RotSpd_Torq_Sched_N, Powf );
-    
-    /* Convert to proper format */
-    KI    = KP_Torq * Ts / TI_Torq ;
-    KD    = KP_Torq * TD_Torq / Ts;
-    
+    /* Update the gain and fine pitch schedules, in between the PIDs keep the gains of the last lookup */
+    if ( RATE_DUE( MCUS->RotSpd_SchedRate, MCUD->iSample, iStatus ) ) {
+    
+        REAL KP = interp1( MCUS->RotSpd_Torq_Schedule, MCUS->RotSpd_Torq_Kp, MCUS->RotSpd_Torq_Sched_N, Powf );
+        REAL TI = interp1( MCUS->RotSpd_Torq_Schedule, MCUS->RotSpd_Torq_Ti, MCUS->RotSpd_Torq_Sched_N, Powf );
+        REAL TD = interp1( MCUS->RotSpd_Torq_Schedule, MCUS->RotSpd_Torq_Td, MCUS->RotSpd_Torq_Sched_N, Powf );
+        
+        /* Convert to proper format */
+        MCUD->RotSpd_Torq_Gains[0] = KP ;
+        MCUD->RotSpd_Torq_Gains[1] = KP * Ts / TI ;
+        MCUD->RotSpd_Torq_Gains[2] = KP * TD / Ts ;
+        
+        KP = interp1( MCUS->RotSpd_Pit_Schedule, MCUS->RotSpd_Pit_Kp, MCUS->RotSpd_Pit_Sched_N, Pitf );
+        TI = interp1( MCUS->RotSpd_Pit_Schedule, MCUS->RotSpd_Pit_Ti, MCUS->RotSpd_Pit_Sched_N, Pitf );
+        TD = interp1( MCUS->RotSpd_Pit_Schedule, MCUS->RotSpd_Pit_Td, MCUS->RotSpd_Pit_Sched_N, Pitf );
+        
+        MCUD->RotSpd_Pit_Gains[0]  = KP ;
+        MCUD->RotSpd_Pit_Gains[1]  = KP * Ts / TI ;
+        MCUD->RotSpd_Pit_Gains[2]  = KP * TD / Ts ;
+        
+        pid_setGains_sca( MCUD->PID_RotSpd_Torq , MCUD->RotSpd_Torq_Gains[0], MCUD->RotSpd_Torq_Gains[1], MCUD->RotSpd_Torq_Gains[2], Ts );
+        pid_setGains_sca( MCUD->PID_RotSpd_Pitch, MCUD->RotSpd_Pit_Gains[0] , MCUD->RotSpd_Pit_Gains[1] , MCUD->RotSpd_Pit_Gains[2] , Ts );
+        
+        MCUD->RotSpd_FinePitch     = interp1( MCUS->RotSpd_FinePit_Schedule, MCUS->RotSpd_FinePit_Angle, MCUS->RotSpd_FinePit_Sched_N, Powf );
+    }
+
     /* Compute error */
     Error_torque  = OmegaRf_T - REC->dRotSpdSetTorque ;
     
-    /* Set gains and constraints */
-    pid_setGains_sca( MCUD->PID_RotSpd_Torq, KP_Torq, KI, KD, Ts );
-    
+    /* Set constraints */
     pid_setConstraints_sca( 
         MCUD->PID_RotSpd_Torq       ,
         REC->dRotSpdMinTorque       ,
@@ -78,33 +90,21 @@ int base_rotorspeed (
     pid_output_sca( MCUD->PID_RotSpd_Torq, &Error_torque, &MCUD->RotSpd_Dem_Torq, dTorq, iStatus );
     
     /* Log key signals of torque PID */
-    pLogdata [ BASE_SPD_TORQ_MIN        ] = REC->dRotSpdMinTorque       ;
-    pLogdata [ BASE_SPD_TORQ_MAX        ] = REC->dRotSpdMaxTorque       ;
-    pLogdata [ BASE_SPD_TORQ_MIN_SPD    ] = REC->dRotSpdMinTorqueRate   ;
-    pLogdata [ BASE_SPD_TORQ_MAX_SPD    ] = REC->dRotSpdMaxTorqueRate   ;
-    pLogdata [ BASE_SPD_TORQ_KP         ] = KP_Torq                     ;
-    pLogdata [ BASE_SPD_TORQ_KI         ] = KI                          ;
-    pLogdata [ BASE_SPD_TORQ_KD         ] = KD                          ;
-    pLogdata [ BASE_SPD_TORQ_ERROR      ] = Error_torque                ;
-    pLogdata [ BASE_SPD_TORQ_SETPOINT   ] = REC->dRotSpdSetTorque       ;
-    pLogdata [ BASE_SPD_TORQ_PIDOUT     ] = *dTorq                      ;
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_MIN        , REC->dRotSpdMinTorque        );
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_MAX        , REC->dRotSpdMaxTorque        );
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_MIN_SPD    , REC->dRotSpdMinTorqueRate    );
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_MAX_SPD    , REC->dRotSpdMaxTorqueRate    );
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_KP         , MCUD->RotSpd_Torq_Gains[0]   );
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_KI         , MCUD->RotSpd_Torq_Gains[1]   );
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_KD         , MCUD->RotSpd_Torq_Gains[2]   );
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_ERROR      , Error_torque                 );
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_SETPOINT   , REC->dRotSpdSetTorque        );
+    LOG_STORE( pLogdata, BASE_SPD_TORQ_PIDOUT     , *dTorq                       );
     
     /* --------------------------------------------------------------------------
      Rotor speed control by Collective Pitch
     -------------------------------------------------------------------------- */
     
-    /* Compute speed controller parameters from schedule */
-    REAL KP_pitch = interp1( MCUS->RotSpd_Pit_Schedule, MCUS->RotSpd_Pit_Kp, MCUS->RotSpd_Pit_Sched_N, Pitf );
-    REAL TI_pitch = interp1( MCUS->RotSpd_Pit_Schedule, MCUS->RotSpd_Pit_Ti, MCUS->RotSpd_Pit_Sched_N, Pitf );
-    REAL TD_pitch = interp1( MCUS->RotSpd_Pit_Schedule, MCUS->RotSpd_Pit_Td, MCUS->RotSpd_Pit_Sched_N, Pitf );
-    
-    /* Compute fine pitch schedule */
-    MCUD->RotSpd_FinePitch = interp1( MCUS->RotSpd_FinePit_Schedule, MCUS->RotSpd_FinePit_Angle, MCUS->RotSpd_FinePit_Sched_N, Powf );
-
-	int k;
-
-
-
     /* Enforce fine pitch angle */
 	 if( iStatus == MCU_STATUS_INIT ) {
         MCUD->PID_RotSpd_Pitch->ulast->Mat[0] = MCUD->RotSpd_Dem_Pitch;
@@ -114,16 +114,10 @@ int base_rotorspeed (
         MCUD->RotSpd_Dem_Pitch                = MAX( MCUD->RotSpd_Dem_Pitch, MCUD->RotSpd_FinePitch );
     }
     
-    /* Convert to proper format */
-    KI = KP_pitch * Ts / TI_pitch;
-    KD = KP_pitch * TD_pitch / Ts;    
-    
     /* Compute error */
     Error_pitch = OmegaRf_P - REC->dRotSpdSetPitch;
     
-    /* Set pid gains and constraints */
-    pid_setGains_sca( MCUD->PID_RotSpd_Pitch, KP_pitch, KI, KD, Ts );
-    
+    /* Set pid constraints */
     pid_setConstraints_sca( 
         MCUD->PID_RotSpd_Pitch       , 
 		MCUD->RotSpd_FinePitch          ,
@@ -137,27 +131,27 @@ int base_rotorspeed (
     
 
 	if ( MCUS->StepResponse_Mode == MCU_STEP_COLL ) {
-    	if (stepfinished == 1)
+    	if (MCUD->RotSpd_StepFinished == 1)
     	           	   *dPit = R_(0.0);
-           if ( time > MCUS->StepResponse_Time && stepfinished == 0 )
+           if ( time > MCUS->StepResponse_Time && MCUD->RotSpd_StepFinished == 0 )
            	   {
         	   *dPit = MCUS->StepResponse_Amplitude;
-           	   //stepfinished = 1;
+           	   //MCUD->RotSpd_StepFinished = 1;
            	   }
 
     }
 
     /* Log key signals of pitch PID */
-    pLogdata [ BASE_SPD_PIT_MIN      ] = MCUD->RotSpd_FinePitch           ;
-    pLogdata [ BASE_SPD_PIT_MAX      ] = REC->dRotSpdMaxPitchAngle ;
-    pLogdata [ BASE_SPD_PIT_MIN_SPD  ] = REC->dRotSpdMinPitchSpeed ;
-    pLogdata [ BASE_SPD_PIT_MAX_SPD  ] = REC->dRotSpdMaxPitchSpeed ;
-    pLogdata [ BASE_SPD_PIT_KP       ] = KP_pitch                  ;
-    pLogdata [ BASE_SPD_PIT_KI       ] = KI                        ;
-    pLogdata [ BASE_SPD_PIT_KD       ] = KD                        ;
-    pLogdata [ BASE_SPD_PIT_ERROR    ] = Error_pitch               ;
-    pLogdata [ BASE_SPD_PIT_SETPOINT ] = REC->dRotSpdSetPitch ; 
-    pLogdata [ BASE_SPD_PIT_PIDOUT   ] = *dPit                     ;
+    LOG_STORE( pLogdata, BASE_SPD_PIT_MIN      , MCUD->RotSpd_FinePitch            );
+    LOG_STORE( pLogdata, BASE_SPD_PIT_MAX      , REC->dRotSpdMaxPitchAngle  );
+    LOG_STORE( pLogdata, BASE_SPD_PIT_MIN_SPD  , REC->dRotSpdMinPitchSpeed  );
+    LOG_STORE( pLogdata, BASE_SPD_PIT_MAX_SPD  , REC->dRotSpdMaxPitchSpeed  );
+    LOG_STORE( pLogdata, BASE_SPD_PIT_KP       , MCUD->RotSpd_Pit_Gains[0]  );
+    LOG_STORE( pLogdata, BASE_SPD_PIT_KI       , MCUD->RotSpd_Pit_Gains[1]  );
+    LOG_STORE( pLogdata, BASE_SPD_PIT_KD       , MCUD->RotSpd_Pit_Gains[2]  );
+    LOG_STORE( pLogdata, BASE_SPD_PIT_ERROR    , Error_pitch                );
+    LOG_STORE( pLogdata, BASE_SPD_PIT_SETPOINT , REC->dRotSpdSetPitch  );
+    LOG_STORE( pLogdata, BASE_SPD_PIT_PIDOUT   , *dPit                      );
     
     /* --------------------------------------------------------------------------
      Select between torque AND/OR pitch action 
@@ -198,7 +192,7 @@ int base_rotorspeed (
     MCUD->PID_RotSpd_Pitch->ulast->Mat[0] = MCUD->RotSpd_Dem_Pitch ;
     
     /* Log key variables */
-    pLogdata [ BASE_TP_SELECT        ] = tOrPselect              ;
+    LOG_STORE( pLogdata, BASE_TP_SELECT        , tOrPselect               );
     
     return iError;
     
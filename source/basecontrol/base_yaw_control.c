@@ -36,6 +36,9 @@ int base_yaw_control(
     /* Local variables */
     int iError = MCU_OK;
     
+    /* The controller runs once every Yaw_Rate[0] samples */
+    REAL    Ts = MCUS->Yaw_Ts ;
+    
     REAL    YawErrIPC          ,
             YawErrIPC_LPF      , 
             YawErrMot          ,
@@ -60,12 +63,12 @@ int base_yaw_control(
         Ti = interp1 ( MCUS->YawIPC_Schedule , MCUS->YawIPC_Ti , MCUS->YawIPC_Sched_N , Powf );
         Td = interp1 ( MCUS->YawIPC_Schedule , MCUS->YawIPC_Td , MCUS->YawIPC_Sched_N , Powf );
 
-        Ki = Kp * MCUS->Ts / Ti;
-        Kd = Kp * Td / MCUS->Ts;
+        Ki = Kp * Ts / Ti;
+        Kd = Kp * Td / Ts;
         
         /* Apply PID */
     
-        pid_setGains_sca (  MCUD->PID_YawIPC, Kp, Ki, Kd, MCUS->Ts );
+        pid_setGains_sca (  MCUD->PID_YawIPC, Kp, Ki, Kd, Ts );
     
         pid_setConstraints_sca ( 
         
@@ -136,22 +139,22 @@ int base_yaw_control(
     
     /* Store signals */
 
-    pLogdata [ BASE_YAWIPC_ERR          ] = YawErrIPC               ;
-    pLogdata [ BASE_YAWIPC_ERR_LPF      ] = YawErrIPC_LPF           ;
-    pLogdata [ BASE_YAWIPC_MAX          ] = MCUS->YawIPC_Max        ;
-    pLogdata [ BASE_YAWIPC_MIN          ] = MCUS->YawIPC_Min        ;
-    pLogdata [ BASE_YAWIPC_RATEMAX      ] = MCUS->YawIPC_RateMax    ;
-    pLogdata [ BASE_YAWIPC_RATEMIN      ] = MCUS->YawIPC_RateMin    ;
-    pLogdata [ BASE_YAWIPC_KP           ] = Kp                      ;
-    pLogdata [ BASE_YAWIPC_KI           ] = Ki                      ;
-    pLogdata [ BASE_YAWIPC_KD           ] = Kd                      ;
-    pLogdata [ BASE_YAWMOT_ERR          ] = YawErrMot               ;
-    pLogdata [ BASE_YAWMOT_ERR_LPF      ] = YawErrMot_LPF           ;
-    pLogdata [ BASE_YAWMOT_ACTIVE       ] = R_(MCUD->YawActive)     ;
-    pLogdata [ BASE_YAW_SETPOINT        ] = REC->dYawSet            ;
-    pLogdata [ BASE_YAW_MODE            ] = R_(MCUS->Yaw_Mode)      ;
-    pLogdata [ BASE_YAW_DEMYAWRATE      ] = MCUD->DemYawRate        ;
-    pLogdata [ BASE_YAW_DEMYAWMOMENT    ] = MCUD->DemYawMoment      ;
+    LOG_STORE( pLogdata, BASE_YAWIPC_ERR          , YawErrIPC                );
+    LOG_STORE( pLogdata, BASE_YAWIPC_ERR_LPF      , YawErrIPC_LPF            );
+    LOG_STORE( pLogdata, BASE_YAWIPC_MAX          , MCUS->YawIPC_Max         );
+    LOG_STORE( pLogdata, BASE_YAWIPC_MIN          , MCUS->YawIPC_Min         );
+    LOG_STORE( pLogdata, BASE_YAWIPC_RATEMAX      , MCUS->YawIPC_RateMax     );
+    LOG_STORE( pLogdata, BASE_YAWIPC_RATEMIN      , MCUS->YawIPC_RateMin     );
+    LOG_STORE( pLogdata, BASE_YAWIPC_KP           , Kp                       );
+    LOG_STORE( pLogdata, BASE_YAWIPC_KI           , Ki                       );
+    LOG_STORE( pLogdata, BASE_YAWIPC_KD           , Kd                       );
+    LOG_STORE( pLogdata, BASE_YAWMOT_ERR          , YawErrMot                );
+    LOG_STORE( pLogdata, BASE_YAWMOT_ERR_LPF      , YawErrMot_LPF            );
+    LOG_STORE( pLogdata, BASE_YAWMOT_ACTIVE       , R_(MCUD->YawActive)      );
+    LOG_STORE( pLogdata, BASE_YAW_SETPOINT        , REC->dYawSet             );
+    LOG_STORE( pLogdata, BASE_YAW_MODE            , R_(MCUS->Yaw_Mode)       );
+    LOG_STORE( pLogdata, BASE_YAW_DEMYAWRATE      , MCUD->DemYawRate         );
+    LOG_STORE( pLogdata, BASE_YAW_DEMYAWMOMENT    , MCUD->DemYawMoment       );
     
     /* Report success */
     
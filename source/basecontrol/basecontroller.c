@@ -18,6 +18,19 @@
 #include "./basecontroller.h"
 
 
+/* ------------------------------------------------------------------------------
+ Set the transfer function of the variable speed notch filters
+------------------------------------------------------------------------------ */
+static void base_controller_notch( const mcu_data_static * MCUS, mcu_data_dynamic * MCUD, const REAL OmR_SCHED )
+{
+    int k;
+    
+    for ( k = 0; k < N_NFP_FILTERS; ++k ) {
+        filter_setNotch_sca ( MCUD->RotSpd_Pit[ N_HPF_FILTERS + k ], MCUS->RotSpd_Pit_damp[ k ], (k+R_(1.0))*OmR_SCHED , MCUS->Ts );
+        filter_setNotch_sca ( MCUD->RotSpd_Tor[ N_HPF_FILTERS + k ], MCUS->RotSpd_Tor_damp[ k ], (k+R_(1.0))*OmR_SCHED , MCUS->Ts );
+    }
+}
+
 /* ------------------------------------------------------------------------------
  The base controller
 ------------------------------------------------------------------------------ */
@@ -40,9 +53,8 @@ int base_controller(
     -------------------------------------------------------------------------- */
     
     const REAL NofB = (REAL)NR_BLADES;
-    REAL debugVar[MAXLOG] = {0.0};
     int iError = MCU_OK;
-    int i,k;
+    int i;
     
     /* --------------------------------------------------------------------------
      Obtain measured quantities
@@ -59,37 +71,25 @@ int base_controller(
     REAL  Ts           = pInputs[ I_MCU_IN_TIMESTEP            ]  ;
     REAL  DemGridCont  = pInputs[ I_MCU_IN_DEM_GRIDCONTACTOR   ]  ;
     REAL  ActType      = pInputs[ I_MCU_IN_ACTUATORTYPE        ]  ;
-    matrix * Mb;
 
 #if NR_BLADES == 3
     REAL   PitchMeas[NR_BLADES] = { pInputs[ I_MCU_IN_MEAS_PITCHANGLE1 ], 
                                     pInputs[ I_MCU_IN_MEAS_PITCHANGLE2 ], 
                                     pInputs[ I_MCU_IN_MEAS_PITCHANGLE3 ] };    
-
-    REAL   Mb_array[NR_BLADES]  = { pInputs[ I_MCU_IN_MEAS_ROOTOUTBENDM1 ], 
-                                    pInputs[ I_MCU_IN_MEAS_ROOTOUTBENDM2 ], 
-                                    pInputs[ I_MCU_IN_MEAS_ROOTOUTBENDM3 ] };
-
-    REAL   Mb_array_2[NR_BLADES]= { cos(PitchMeas[0]) * pInputs[ I_MCU_IN_MEAS_ROOTOUTBENDM1 ] + sin(PitchMeas[0]) * pInputs[ I_MCU_IN_MEAS_ROOTINBENDM1 ],
-    								cos(PitchMeas[1]) * pInputs[ I_MCU_IN_MEAS_ROOTOUTBENDM2 ] + sin(PitchMeas[1]) * pInputs[ I_MCU_IN_MEAS_ROOTINBENDM2 ],
-    								cos(PitchMeas[2]) * pInputs[ I_MCU_IN_MEAS_ROOTOUTBENDM3 ] + sin(PitchMeas[2]) * pInputs[ I_MCU_IN_MEAS_ROOTINBENDM3 ]} ;
-
 #else
     REAL   PitchMeas[NR_BLADES] = { pInputs[ I_MCU_IN_MEAS_PITCHANGLE1 ], 
                                     pInputs[ I_MCU_IN_MEAS_PITCHANGLE2 ] };    
-
-    REAL   Mb_array[NR_BLADES]  = { pInputs[ I_MCU_IN_MEAS_ROOTOUTBENDM1 ], 
-                                    pInputs[ I_MCU_IN_MEAS_ROOTOUTBENDM2 ] };
 #endif
     
 
 
-	Mb = mat_init( Mb_array, NR_BLADES, 1 );
-
+    DotxProfBegin( PROF_BASECONTROLLER );
 
     /* --------------------------------------------------------------------------
      Filter input signals
     -------------------------------------------------------------------------- */
+    DotxProfBegin( PROF_FILTERS );
+
     REAL    OmR_P[ N_FILTERS + 1 ],
             OmR_T[ N_FILTERS + 1 ];
             
@@ -99,7 +99,8 @@ int base_controller(
             Pit        ,
             Pit_LPF    ;
             
-    static REAL OmR_SCHED ;
+    /* Scheduling speed of the previous sample */
+    REAL    OmR_SCHED = MCUD->RotSpd_SchedSpd ;
    
     /* Compute rotor speed */
     OmR = OmegaG / MCUS->iGB;
@@ -111,7 +112,7 @@ int base_controller(
         OmR_SCHED = MAX( MCUS->Wmin / MCUS->iGB, OmR );
         
         /* Demanded generator torque for rotor speed controller */
-        if ( MCUS->ToptCoef > 0.0 ) 
+        if ( MCUS->ToptCoef > R_(0.0) ) 
             MCUD->RotSpd_Dem_Torq = TgenMeas ;
         else {
             MCUD->RotSpd_Dem_Torq = interp1 ( MCUS->ToptCurveOmg, MCUS->ToptCurveTor, MCUS->ToptCurveN, OmegaG * MCUS->iGB );        
@@ -132,28 +133,45 @@ int base_controller(
 
     }
     
-    /* Set transfer function of variable speed notch filters */
-    for ( k = 0; k < N_NFP_FILTERS; ++k ) {
-        filter_setNotch_sca ( MCUD->RotSpd_Pit[ N_HPF_FILTERS + k ], MCUS->RotSpd_Pit_damp[ k ], (k+1.0)*OmR_SCHED , MCUS->Ts );
-        filter_setNotch_sca ( MCUD->RotSpd_Tor[ N_HPF_FILTERS + k ], MCUS->RotSpd_Tor_damp[ k ], (k+1.0)*OmR_SCHED , MCUS->Ts );
+    if ( MCUD->Pre_Batch ) {
+    
+        /* Batch: the rotor speed of this sample has been filtered by base_controller_batch() */
+        memcpy( OmR_P, MCUD->Pre_OmR_P, sizeof(OmR_P) );
+        memcpy( OmR_T, MCUD->Pre_OmR_T, sizeof(OmR_T) );
+        MCUD->Pre_Batch = FALSE;
     }
+    else if ( MCUD->Pre_Lead != NULL ) {
     
-    /* Filter the rotor speed */
-    OmR_P[ 0 ] = OmR;
-    OmR_T[ 0 ] = OmR;
-    for ( k = 0; k < N_FILTERS; ++k ) {
-        filter_output_sca ( MCUD->RotSpd_Pit[k] , OmR_P+k , OmR_P+k+1 , iStatus );
-        filter_output_sca ( MCUD->RotSpd_Tor[k] , OmR_T+k , OmR_T+k+1 , iStatus );
+        /* Shadow controller: the lead filtered the same rotor speed with the same filters */
+        memcpy( OmR_P, MCUD->Pre_Lead->Pre_OmR_P, sizeof(OmR_P) );
+        memcpy( OmR_T, MCUD->Pre_Lead->Pre_OmR_T, sizeof(OmR_T) );
+        OmR_SCHED             = MCUD->Pre_Lead->RotSpd_SchedSpd;
+        MCUD->RotSpd_FdbckSpd = MCUD->Pre_Lead->RotSpd_FdbckSpd;
     }
-
-    /* Scheduling filters */
-    filter_output_sca( MCUD->RotSpd_SCHED , &OmR_T[ N_FILTERS ] , &OmR_SCHED              , iStatus ); 
-    filter_output_sca( MCUD->RotSpd_FDBCK , &OmR_T[ N_FILTERS ] , &(MCUD->RotSpd_FdbckSpd), iStatus ); 
+    else {
     
-    OmR_SCHED = MAX( MCUS->Wmin / MCUS->iGB, OmR_SCHED ); 
+        /* Set transfer function of variable speed notch filters */
+        base_controller_notch( MCUS, MCUD, OmR_SCHED );
+        
+        /* Filter the rotor speed, by the active filters of the sequences */
+        OmR_P[ 0 ] = OmR;
+        OmR_T[ 0 ] = OmR;
+        filter_chain_output ( MCUD->RotSpd_Pit , N_FILTERS , &MCUD->RotSpd_Pit_Chain , OmR_P , iStatus );
+        filter_chain_output ( MCUD->RotSpd_Tor , N_FILTERS , &MCUD->RotSpd_Tor_Chain , OmR_T , iStatus );
+
+        /* Scheduling filters */
+        filter_output_sca( MCUD->RotSpd_SCHED , &OmR_T[ N_FILTERS ] , &OmR_SCHED              , iStatus ); 
+        filter_output_sca( MCUD->RotSpd_FDBCK , &OmR_T[ N_FILTERS ] , &(MCUD->RotSpd_FdbckSpd), iStatus ); 
+        
+        OmR_SCHED = MAX( MCUS->Wmin / MCUS->iGB, OmR_SCHED ); 
+    }
     
     MCUD->RotSpd_SchedSpd = OmR_SCHED;
     
+    /* Filtered rotor speed of this sample, for a shadow controller */
+    memcpy( MCUD->Pre_OmR_P, OmR_P, sizeof(OmR_P) );
+    memcpy( MCUD->Pre_OmR_T, OmR_T, sizeof(OmR_T) );
+    
     /* Compute key quantities */
     Pow = MAX( R_(1.0), MCUD->RotSpd_Dem_Torq * OmR_T[ N_FILTERS ] * MCUS->iGB ) ; 
     Pit = MCUD->RotSpd_Dem_Pitch;
@@ -162,6 +180,8 @@ int base_controller(
     filter_output_sca( MCUD->Power_LPF , &Pow , &Pow_LPF , iStatus );
     filter_output_sca( MCUD->Pitch_LPF , &Pit , &Pit_LPF , iStatus );
     
+    DotxProfEnd( PROF_FILTERS );
+    
     /* --------------------------------------------------------------------------
      Rotor speed controller
     -------------------------------------------------------------------------- */
@@ -169,6 +189,8 @@ int base_controller(
     REAL   dPit_rtsp   ,
            dTor_rtsp   ;
 
+    DotxProfBegin( PROF_ROTORSPEED );
+
     base_rotorspeed (    
     
         OmR_T[ N_FILTERS ]  ,
@@ -186,23 +208,27 @@ int base_controller(
         Time
 		);
 
-    /* Store values */
-    pLogdata [ BASE_SPD_RTSP        ] = OmR                     ;
-    pLogdata [ BASE_SPD_RTSP_P_HPF  ] = OmR_P[ N_HPF_FILTERS ];
-    pLogdata [ BASE_SPD_RTSP_P_NFP  ] = OmR_P[ N_HPF_FILTERS+N_NFP_FILTERS ];   
-    pLogdata [ BASE_SPD_RTSP_P_NFF  ] = OmR_P[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS ];
-    pLogdata [ BASE_SPD_RTSP_P_LPF  ] = OmR_P[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS+N_LPF_FILTERS ];
-    pLogdata [ BASE_SPD_RTSP_T_HPF  ] = OmR_T[ N_HPF_FILTERS ];
-    pLogdata [ BASE_SPD_RTSP_T_NFP  ] = OmR_T[ N_HPF_FILTERS+N_NFP_FILTERS ];   
-    pLogdata [ BASE_SPD_RTSP_T_NFF  ] = OmR_T[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS ];
-    pLogdata [ BASE_SPD_RTSP_T_LPF  ] = OmR_T[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS+N_LPF_FILTERS ];
-    pLogdata [ BASE_SPD_RTSP_SCHED  ] = OmR_SCHED               ;
-    pLogdata [ BASE_SPD_POW         ] = Pow                     ;
-    pLogdata [ BASE_SPD_POW_LPF     ] = Pow_LPF                 ;
-    pLogdata [ BASE_SPD_PITCH       ] = Pit                     ;
-    pLogdata [ BASE_SPD_PITCH_LPF   ] = Pit_LPF                 ;
-    pLogdata [ BASE_SPD_DEM_TORQ    ] = MCUD->RotSpd_Dem_Torq   ;
-    pLogdata [ BASE_SPD_DEM_PITCH   ] = MCUD->RotSpd_Dem_Pitch  ;
+    DotxProfEnd( PROF_ROTORSPEED );
+
+    /* Store values, only when the log array is read. The channels are listed in LOGB_BASE_LOG of mcuschedule.c */
+    if ( mcu_block( MCUD, MCU_BLOCK_BASE_LOG, iStatus ) ) {
+        LOG_STORE( pLogdata, BASE_SPD_RTSP        , OmR                      );
+        LOG_STORE( pLogdata, BASE_SPD_RTSP_P_HPF  , OmR_P[ N_HPF_FILTERS ] );
+        LOG_STORE( pLogdata, BASE_SPD_RTSP_P_NFP  , OmR_P[ N_HPF_FILTERS+N_NFP_FILTERS ] );
+        LOG_STORE( pLogdata, BASE_SPD_RTSP_P_NFF  , OmR_P[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS ] );
+        LOG_STORE( pLogdata, BASE_SPD_RTSP_P_LPF  , OmR_P[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS+N_LPF_FILTERS ] );
+        LOG_STORE( pLogdata, BASE_SPD_RTSP_T_HPF  , OmR_T[ N_HPF_FILTERS ] );
+        LOG_STORE( pLogdata, BASE_SPD_RTSP_T_NFP  , OmR_T[ N_HPF_FILTERS+N_NFP_FILTERS ] );
+        LOG_STORE( pLogdata, BASE_SPD_RTSP_T_NFF  , OmR_T[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS ] );
+        LOG_STORE( pLogdata, BASE_SPD_RTSP_T_LPF  , OmR_T[ N_HPF_FILTERS+N_NFP_FILTERS+N_NFF_FILTERS+N_LPF_FILTERS ] );
+        LOG_STORE( pLogdata, BASE_SPD_RTSP_SCHED  , OmR_SCHED                );
+        LOG_STORE( pLogdata, BASE_SPD_POW         , Pow                      );
+        LOG_STORE( pLogdata, BASE_SPD_POW_LPF     , Pow_LPF                  );
+        LOG_STORE( pLogdata, BASE_SPD_PITCH       , Pit                      );
+        LOG_STORE( pLogdata, BASE_SPD_PITCH_LPF   , Pit_LPF                  );
+        LOG_STORE( pLogdata, BASE_SPD_DEM_TORQ    , MCUD->RotSpd_Dem_Torq    );
+        LOG_STORE( pLogdata, BASE_SPD_DEM_PITCH   , MCUD->RotSpd_Dem_Pitch   );
+    }
     
 
 
@@ -214,17 +240,30 @@ int base_controller(
     
 #ifdef _DTDAMP
 
-    base_dt_damping (        
+    if ( mcu_block( MCUD, MCU_BLOCK_DTDAMP, iStatus ) ) {
 
-        OmR             ,
-        OmR_SCHED       ,
-        iStatus         ,
-        MCUS            ,                     
-        MCUD            ,
-       &dTorq_dt        ,
-        pLogdata
-        
-    );
+        DotxProfBegin( PROF_DTDAMP );
+
+        base_dt_damping (        
+
+            OmR             ,
+            OmR_SCHED       ,
+            iStatus         ,
+            MCUS            ,                     
+            MCUD            ,
+           &dTorq_dt        ,
+            pLogdata
+            
+        );
+
+        DotxProfEnd( PROF_DTDAMP );
+    }
+    else {
+    
+        /* Removed from the schedule: switched off and not logged */
+        MCUD->DTdamp_Dem_Torq = R_(0.0);
+        dTorq_dt = R_(0.0);
+    }
     
 #else
 
@@ -244,22 +283,36 @@ int base_controller(
     
 #ifdef _FADAMP    
 
-    base_fa_damping(        
+    if ( mcu_block( MCUD, MCU_BLOCK_FADAMP, iStatus ) ) {
+
+        DotxProfBegin( PROF_FADAMP );
+
+        base_fa_damping(        
+            
+            Pow_LPF      ,
+            OmR_SCHED    ,
+            dPit_rtsp    ,
+            Pit_LPF      ,
+            Afa          ,
+            iStatus      ,
+            MCUS         ,                     
+            MCUD         ,
+           &dPit_fa      ,
+           &AmplFA       ,
+            pLogdata     ,
+            REC
         
-        Pow_LPF      ,
-        OmR_SCHED    ,
-        dPit_rtsp    ,
-        Pit_LPF      ,
-        Afa          ,
-        iStatus      ,
-        MCUS         ,                     
-        MCUD         ,
-       &dPit_fa      ,
-       &AmplFA       ,
-        pLogdata     ,
-        REC
-    
-    );
+        );
+
+        DotxProfEnd( PROF_FADAMP );
+    }
+    else {
+    
+        /* Removed from the schedule: switched off and not logged */
+        MCUD->FAdamp_Dem_Pitch = R_(0.0) ;
+        dPit_fa = R_(0.0) ;
+        AmplFA  = R_(0.0) ;
+    }
     
 #else
 
@@ -277,18 +330,29 @@ int base_controller(
     
 #ifdef _YAW
 
-    base_yaw_control(      
-    
-        MeaYawErr   ,
-        Pow_LPF     ,
-        Az          ,
-        iStatus     ,
-        MCUS        ,                     
-        MCUD        ,                          
-        pLogdata    ,
-        REC
+    DotxProfBegin( PROF_YAW );
+
+    /* The yaw demands are held between two executions of the yaw controller, 
+       and while the yaw controller is deferred by the load shedding. Removed 
+       from the schedule, the demands remain zero from the initialization. */
+    if ( RATE_DUE( MCUS->Yaw_Rate, MCUD->iSample, iStatus ) && !mcu_shed( MCUD, MCU_SHED_YAW, iStatus ) && 
+         mcu_block( MCUD, MCU_BLOCK_YAW, iStatus ) ) {
+
+        base_yaw_control(      
+        
+            MeaYawErr   ,
+            Pow_LPF     ,
+            Az          ,
+            iStatus     ,
+            MCUS        ,                     
+            MCUD        ,                          
+            pLogdata    ,
+            REC
+
+        );
+    }
 
-    );
+    DotxProfEnd( PROF_YAW );
 
     
 #else
@@ -358,7 +422,7 @@ int base_controller(
     }
     if ( REC->iOpenLoopPitch1 || REC->iOpenLoopPitch2 ) // Fix for aligning internal RSPD pitch
     {
-    	MCUD->RotSpd_Dem_Pitch = (REC->dOpenLoopPitch1 + REC->dOpenLoopPitch2)/2.0;
+    	MCUD->RotSpd_Dem_Pitch = (REC->dOpenLoopPitch1 + REC->dOpenLoopPitch2)/R_(2.0);
     }
 
     /* --------------------------------------------------------------------------
@@ -412,10 +476,7 @@ int base_controller(
     pOutputs [ I_MCU_OUT_DEM_GENTORQUE  ] = DemTgen     ;
     pOutputs [ I_MCU_OUT_DEM_YAWRATE    ] = DemYawRate  ;
 
-    /* --------------------------------------------------------------------------   
-     Release allocated memory  
-    -------------------------------------------------------------------------- */   
-    mat_free( Mb );
+    DotxProfEnd( PROF_BASECONTROLLER );
 
     /* --------------------------------------------------------------------------
      Report succesful computation
@@ -423,6 +484,154 @@ int base_controller(
     return iError;
 }
 
+/* ------------------------------------------------------------------------------
+ Reuse the filtered rotor speed of a lead controller
+------------------------------------------------------------------------------ */
+int base_controller_share( 
+
+        const  mcu_data_static   * MCUS                , // IN      Data struct of the shadow
+               mcu_data_dynamic  * MCUD                , // IN/OUT  Data struct of the shadow
+        const  mcu_data_static   * LeadS               , // IN      Data struct of the lead
+        const  mcu_data_dynamic  * LeadD                 // IN      Data struct of the lead
+        
+) {
+
+    int k, iSame;
+    
+    /* Parameters of the rotor speed filtering */
+    iSame = ( MCUS->iGB == LeadS->iGB && MCUS->Wmin == LeadS->Wmin && MCUS->Ts == LeadS->Ts && 
+              MCUD->RotSpd_SchedSpd == LeadD->RotSpd_SchedSpd );
+    
+    for ( k = 0; k < N_NFP_FILTERS; ++k ) 
+        iSame = iSame && MCUS->RotSpd_Pit_damp[ k ] == LeadS->RotSpd_Pit_damp[ k ] 
+                      && MCUS->RotSpd_Tor_damp[ k ] == LeadS->RotSpd_Tor_damp[ k ];
+    
+    /* The filters themselves, including their state after the initialization */
+    for ( k = 0; k < N_FILTERS; ++k ) 
+        iSame = iSame && filter_equal( MCUD->RotSpd_Pit[k], LeadD->RotSpd_Pit[k] )
+                      && filter_equal( MCUD->RotSpd_Tor[k], LeadD->RotSpd_Tor[k] );
+    
+    iSame = iSame && filter_equal( MCUD->RotSpd_SCHED, LeadD->RotSpd_SCHED )
+                  && filter_equal( MCUD->RotSpd_FDBCK, LeadD->RotSpd_FDBCK );
+    
+    MCUD->Pre_Lead = iSame ? LeadD : NULL;
+    
+    return iSame;
+}
+
+/* ------------------------------------------------------------------------------
+ Run a series of filters of a tile of controllers, filter by filter
+------------------------------------------------------------------------------ */
+static int base_controller_bank( 
+
+               Filter            * const * series[]    , // IN/OUT  Series of filters of each controller of the tile
+        const  int                 n                   , // IN      Number of controllers in the tile
+        const  int                 bUse[]              , // IN      Flag per controller: filtered in the tile
+        const  int                 nStages             , // IN      Number of filters in each series
+               mcu_data_dynamic  * MCUD[]              , // IN/OUT  Data structs of the tile, for the health counters
+        const  int                 bSnap               , // IN      Snap subnormal states, see health_select()
+               REAL                x[][ FILTER_BANK_WIDTH ] // IN/OUT Signal before and after each filter of the series [nStages+1]
+        
+) {
+
+    int i, k, bActive, iError = MCU_OK;
+    FilterBank bank;
+    
+    for ( k = 0; k < nStages; ++k ) {
+    
+        /* A filter which is switched off in all controllers only passes its input */
+        for ( i = 0, bActive = FALSE; i < n; ++i ) bActive = bActive || ( bUse[i] && series[i][k]->active );
+        if ( !bActive ) {
+            memcpy( x[k+1], x[k], n*sizeof(REAL) );
+            continue;
+        }
+        
+        for ( i = 0; i < n; ++i ) filter_bank_load( &bank, i, bUse[i] ? series[i][k] : NULL );
+        
+        filter_bank_output( &bank, n, x[k], x[k+1] );
+        
+        for ( i = 0; i < n; ++i ) {
+            if ( !bUse[i] ) continue;
+            health_select( MCUD[i]->Health_Count, bSnap );
+            iError += filter_bank_store( &bank, i, series[i][k], x[k][i] );
+        }
+    }
+    
+    return iError;
+}
+
+/* ------------------------------------------------------------------------------
+ Filter the rotor speed of a tile of controllers of a batch
+------------------------------------------------------------------------------ */
+int base_controller_batch( 
+
+        const  REAL              * pInputs             , // IN      Input arrays of the tile [n][MCU_NR_INPUTS]
+        const  int                 n                   , // IN      Number of controllers in the tile
+        const  mcu_data_static   * MCUS[]              , // IN      Data structs of the tile
+               mcu_data_dynamic  * MCUD[]              , // IN/OUT  Data structs of the tile
+        const  int                 bSnap                 // IN      Snap subnormal states, see health_select()
+        
+) {
+
+    int i, k, bUse[ FILTER_BANK_WIDTH ] = { 0 }, iError = MCU_OK;
+    
+    /* Signals of the tile, one row per filter */
+    REAL    OmR_P[ N_FILTERS + 1 ][ FILTER_BANK_WIDTH ],
+            OmR_T[ N_FILTERS + 1 ][ FILTER_BANK_WIDTH ],
+            OmR_S[ 2 ][ FILTER_BANK_WIDTH ],
+            OmR_F[ 2 ][ FILTER_BANK_WIDTH ];
+    
+    Filter * const * seriesP[ FILTER_BANK_WIDTH ];
+    Filter * const * seriesT[ FILTER_BANK_WIDTH ];
+    Filter * const * seriesS[ FILTER_BANK_WIDTH ];
+    Filter * const * seriesF[ FILTER_BANK_WIDTH ];
+    
+    if ( n > FILTER_BANK_WIDTH ) return MCU_ERR;
+    
+    for ( i = 0; i < n; ++i ) {
+    
+        /* A shadow controller reuses the filtered rotor speed of its lead */
+        bUse[i] = ( MCUD[i]->Pre_Lead == NULL );
+        
+        seriesP[i] = MCUD[i]->RotSpd_Pit;
+        seriesT[i] = MCUD[i]->RotSpd_Tor;
+        seriesS[i] = &MCUD[i]->RotSpd_SCHED;
+        seriesF[i] = &MCUD[i]->RotSpd_FDBCK;
+        
+        /* Set transfer function of variable speed notch filters, at the scheduling speed of the previous sample */
+        if ( bUse[i] ) base_controller_notch( MCUS[i], MCUD[i], MCUD[i]->RotSpd_SchedSpd );
+        
+        OmR_P[0][i] = pInputs[ i*MCU_NR_INPUTS + I_MCU_IN_MEAS_GENSPEED ] / MCUS[i]->iGB;
+        OmR_T[0][i] = OmR_P[0][i];
+    }
+    
+    /* The filter series of base_controller(), each filter for all controllers of the tile */
+    iError += base_controller_bank( seriesP, n, bUse, N_FILTERS, MCUD, bSnap, OmR_P );
+    iError += base_controller_bank( seriesT, n, bUse, N_FILTERS, MCUD, bSnap, OmR_T );
+    
+    /* Scheduling filters */
+    memcpy( OmR_S[0], OmR_T[ N_FILTERS ], n*sizeof(REAL) );
+    memcpy( OmR_F[0], OmR_T[ N_FILTERS ], n*sizeof(REAL) );
+    iError += base_controller_bank( seriesS, n, bUse, 1, MCUD, bSnap, OmR_S );
+    iError += base_controller_bank( seriesF, n, bUse, 1, MCUD, bSnap, OmR_F );
+    
+    for ( i = 0; i < n; ++i ) {
+    
+        if ( !bUse[i] ) continue;
+        
+        for ( k = 0; k <= N_FILTERS; ++k ) {
+            MCUD[i]->Pre_OmR_P[k] = OmR_P[k][i];
+            MCUD[i]->Pre_OmR_T[k] = OmR_T[k][i];
+        }
+        
+        MCUD[i]->RotSpd_SchedSpd = MAX( MCUS[i]->Wmin / MCUS[i]->iGB, OmR_S[1][i] );
+        MCUD[i]->RotSpd_FdbckSpd = OmR_F[1][i];
+        MCUD[i]->Pre_Batch       = TRUE;
+    }
+    
+    return iError;
+}
+
 /* ---------------------------------------------------------------------------------
   end basecontroller.c
 --------------------------------------------------------------------------------- */
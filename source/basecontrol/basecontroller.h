@@ -176,6 +176,66 @@ int base_controller(
                mcu_data_dynamic  * MCUD                   , 
                base_contr_recipe * REC         
                
+);
+
+//! Reuse the filtered rotor speed of a lead controller.
+/*!
+    A shadow controller which runs on the same inputs, directly after its 
+    lead, does not need to filter the rotor speed again when its filter 
+    series are identical to the ones of the lead: base_controller() then 
+    copies the filtered rotor speed of the lead. This is only the case when 
+    the gearbox ratio, the minimum generator speed, the sample time, the 
+    damping of the variable speed notch filters and the transfer functions 
+    and states of all rotor speed filters are the same, which is checked 
+    here after both controllers have been initialized on the same inputs.
+    The filters of the shadow itself are no longer updated.
+
+    \param MCUS         [in]        The static data of the shadow controller.
+    \param MCUD         [in/out]    The dynamic data of the shadow controller.
+    \param LeadS        [in]        The static data of the lead controller.
+    \param LeadD        [in]        The dynamic data of the lead controller.
+    \return             1 if the filtered rotor speed is shared, 0 if the shadow filters it itself.
+*/
+int base_controller_share( 
+
+        const  mcu_data_static   * MCUS                , 
+               mcu_data_dynamic  * MCUD                , 
+        const  mcu_data_static   * LeadS               , 
+        const  mcu_data_dynamic  * LeadD                
+               
+);
+
+//! Filter the rotor speed of a tile of controllers of a batch.
+/*!
+    The rotor speed filters of base_controller() (the pitch and torque 
+    controller series and the scheduling and feedback filters) are run 
+    filter by filter for all controllers of the tile, with the coefficients 
+    and states of the same filter of all controllers next to each other in a 
+    FilterBank. A filter which is switched off in all controllers of the tile 
+    is skipped. The outputs are identical to those of base_controller().
+    
+    The filtered rotor speed is stored in the dynamic data of each controller 
+    and mcu_data_dynamic::Pre_Batch is set, after which base_controller() uses it in this 
+    sample instead of filtering the rotor speed itself. A shadow controller 
+    which reuses the rotor speed of its lead (see base_controller_share()) 
+    is left out. Only for run samples.
+
+    \param pInputs      [in]        The input arrays of the tile [n][MCU_NR_INPUTS].
+    \param n            [in]        Number of controllers in the tile, at most #FILTER_BANK_WIDTH.
+    \param MCUS         [in]        The static data of each controller [n].
+    \param MCUD         [in/out]    The dynamic data of each controller [n].
+    \param bSnap        [in]        Flag indicating that subnormal states are snapped, see health_select().
+    \return             A non zero int will be returned in the case an error occurred.
+    \sa mcu_run_batch
+*/
+int base_controller_batch( 
+
+        const  REAL              * pInputs             , 
+        const  int                 n                   , 
+        const  mcu_data_static   * MCUS[]              , 
+               mcu_data_dynamic  * MCUD[]              , 
+        const  int                 bSnap                
+               
 );
 #endif
 
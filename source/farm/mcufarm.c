@@ -0,0 +1,408 @@
+/* ---------------------------------------------------------------------------------
+ *          file : mcufarm.c                                                      *
+ *   description : C-source file, multi-core executor for many MCU instances      *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#define _DOTX_HOST_     // Host of the controller: keeps the heap of the process, see staticmem.h
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "./../signals/signal_definitions_internal.h"
+#include "./../signals/signal_definitions_custom.h"
+#include "./../signals/signal_definitions_external.h"
+
+#include "./../suplib/suplib.h"
+
+#include "./../turbine/mcudata.h"
+
+#ifdef _SUP
+#include "./../supervisor/supdata.h"
+#endif
+
+#ifdef _SIM
+#include "./../simulation/evmdata.h"
+#include "./../simulation/simdata.h"
+#endif
+
+#include "./../basecontrol/basecontroller.h"
+
+#include "./../maincontrollerunit.h"
+#include "./../mcuinstance.h"
+
+#include "./mcufarm.h"
+
+
+/* ---------------------------------------------------------------------------------
+ Private data of the executor
+--------------------------------------------------------------------------------- */
+
+/* I/O of a single instance, each slot starts at its own cache line */
+typedef struct farm_slot {
+    mcu_instance  * pMCU                            ;
+    int             iError                          ;
+    REAL            pOutputs[ MCU_NR_OUTPUTS ]      ;
+    REAL            pDebug  [ MCUFARM_DEBUGSIZE ]   ;
+    REAL            pLogdata[ MAXLOG ]              ;
+    char            cMessage[ MCUFARM_MSGSIZE ]     ;
+} farm_slot;
+
+/* A worker thread and the range of instances it owns, the next index is taken
+   atomically so other workers can steal from the range */
+typedef struct farm_worker {
+    atomic_int      iNext                           ;
+    int             iBegin                          ;
+    int             iEnd                            ;
+    int             id                              ;
+    pthread_t       thread                          ;
+    mcu_farm      * farm                            ;
+} farm_worker;
+
+struct mcu_farm {
+    int                 N                           ;
+    int                 nThreads                    ;
+    size_t              slotStride                  ;
+    size_t              workerStride                ;
+    char              * slots                       ;
+    char              * workers                     ;
+    void              * vpSlotsBase                 ;
+    void              * vpWorkersBase               ;
+    int                 nStarted                    ;
+    int                 iGate                       ;
+    pthread_mutex_t     mtxGate                     ;
+    pthread_cond_t      cndGate                     ;
+    pthread_barrier_t   barStart                    ;
+    pthread_barrier_t   barEnd                      ;
+    const REAL        * pInputs                     ;
+    int                 iStatus                     ;
+    int                 iDevice                     ;
+    char              * cRunname                    ;
+    int                 iShutdown                   ;
+    char                cConfig[ FILENAMESIZE ]     ;
+};
+
+#define FARM_SLOT( farm, i )    ( (farm_slot*)   ( (farm)->slots   + (size_t)(i) * (farm)->slotStride   ) )
+#define FARM_WORKER( farm, i )  ( (farm_worker*) ( (farm)->workers + (size_t)(i) * (farm)->workerStride ) )
+
+
+/* ---------------------------------------------------------------------------------
+ Allocate n cache line aligned elements of the given size
+--------------------------------------------------------------------------------- */
+static char * farm_calloc_aligned( const int n, const size_t size, size_t * stride, void ** vpBase )
+{
+    *stride = ( size + MCU_CACHELINE - 1 ) & ~( (size_t)MCU_CACHELINE - 1 );
+    *vpBase = calloc( 1, (size_t)n * (*stride) + 2*MCU_CACHELINE );
+    if ( *vpBase == NULL ) return NULL;
+
+    return (char*) ( ( (size_t)(*vpBase) + MCU_CACHELINE ) & ~( (size_t)MCU_CACHELINE - 1 ) );
+}
+
+/* ---------------------------------------------------------------------------------
+ Step a single instance
+--------------------------------------------------------------------------------- */
+static void farm_stepone( mcu_farm * farm, const int i )
+{
+    farm_slot * slot = FARM_SLOT( farm, i );
+
+    slot->iError = mcu_instance_step( slot->pMCU, farm->pInputs + (size_t)i * MCU_NR_INPUTS,
+                        slot->pOutputs, slot->pDebug, slot->pLogdata, farm->iStatus,
+                        farm->iDevice, slot->cMessage, farm->cRunname );
+}
+
+/* ---------------------------------------------------------------------------------
+ Step the own range of a worker, followed by whatever is left of the other ranges
+--------------------------------------------------------------------------------- */
+static void farm_work( mcu_farm * farm, const int id )
+{
+    int k, i;
+
+    for ( k = 0; k < farm->nThreads; ++k ) {
+
+        farm_worker * W = FARM_WORKER( farm, ( id + k ) % farm->nThreads );
+
+        while ( ( i = atomic_fetch_add_explicit( &W->iNext, 1, memory_order_relaxed ) ) < W->iEnd )
+            farm_stepone( farm, i );
+    }
+}
+
+/* ---------------------------------------------------------------------------------
+ Main loop of a worker thread
+--------------------------------------------------------------------------------- */
+static void * farm_thread( void * vpWorker )
+{
+    farm_worker * W    = (farm_worker*) vpWorker;
+    mcu_farm    * farm = W->farm;
+
+    /* The barriers count all workers, they are only used once every worker has started */
+    pthread_mutex_lock( &farm->mtxGate );
+    while ( !farm->iGate ) pthread_cond_wait( &farm->cndGate, &farm->mtxGate );
+    pthread_mutex_unlock( &farm->mtxGate );
+    if ( farm->iShutdown ) return NULL;
+
+    for ( ;; ) {
+
+        pthread_barrier_wait( &farm->barStart );
+        if ( farm->iShutdown ) break;
+
+        farm_work( farm, W->id );
+
+        pthread_barrier_wait( &farm->barEnd );
+    }
+
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------------------
+ Number of cores available to the process
+--------------------------------------------------------------------------------- */
+int mcufarm_ncores( void )
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    return (int) info.dwNumberOfProcessors;
+#else
+    return MAX( 1, (int) sysconf( _SC_NPROCESSORS_ONLN ) );
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+ Create the executor
+--------------------------------------------------------------------------------- */
+mcu_farm * mcufarm_init( const int N, const int nThreads, const char * cConfig )
+{
+    int i, iError = MCU_OK;
+
+    mcu_farm * farm = (mcu_farm*) calloc( 1, sizeof(mcu_farm) );
+    if ( farm == NULL ) return NULL;
+
+    farm->N        = N;
+    farm->nThreads = nThreads > 0 ? nThreads : mcufarm_ncores( );
+    strncpy( farm->cConfig, cConfig, FILENAMESIZE-1 );
+
+    /* Instances and their I/O */
+    farm->slots   = farm_calloc_aligned( N, sizeof(farm_slot), &farm->slotStride, &farm->vpSlotsBase );
+    farm->workers = farm_calloc_aligned( farm->nThreads, sizeof(farm_worker), &farm->workerStride, &farm->vpWorkersBase );
+    if ( farm->slots == NULL || farm->workers == NULL ) {
+        free( farm->vpSlotsBase );
+        free( farm->vpWorkersBase );
+        free( farm );
+        return NULL;
+    }
+
+    for ( i = 0; i < N; ++i ) {
+        FARM_SLOT( farm, i )->pMCU = mcu_instance_create( );
+        if ( FARM_SLOT( farm, i )->pMCU == NULL ) ++iError;
+    }
+
+    /* Contiguous ranges of (almost) equal size */
+    for ( i = 0; i < farm->nThreads; ++i ) {
+        farm_worker * W = FARM_WORKER( farm, i );
+        W->id     = i;
+        W->farm   = farm;
+        W->iBegin = (int) ( ( (long)N *  i      ) / farm->nThreads );
+        W->iEnd   = (int) ( ( (long)N * (i + 1) ) / farm->nThreads );
+        atomic_init( &W->iNext, W->iEnd );
+    }
+
+    /* The calling thread acts as worker 0, the others wait at the gate until all have started */
+    pthread_mutex_init( &farm->mtxGate, NULL );
+    pthread_cond_init ( &farm->cndGate, NULL );
+    pthread_barrier_init( &farm->barStart, NULL, farm->nThreads );
+    pthread_barrier_init( &farm->barEnd  , NULL, farm->nThreads );
+    for ( i = 1; i < farm->nThreads && iError == MCU_OK; ++i ) {
+        farm_worker * W = FARM_WORKER( farm, i );
+        if ( pthread_create( &W->thread, NULL, farm_thread, W ) != 0 ) ++iError;
+        else farm->nStarted += 1;
+    }
+
+    /* Open the gate, after a failure the started workers leave without touching the barriers */
+    pthread_mutex_lock( &farm->mtxGate );
+    farm->iShutdown = ( iError > MCU_OK );
+    farm->iGate     = 1;
+    pthread_cond_broadcast( &farm->cndGate );
+    pthread_mutex_unlock( &farm->mtxGate );
+
+    if ( iError > MCU_OK ) {
+        mcufarm_free( farm );
+        return NULL;
+    }
+
+    return farm;
+}
+
+/* ---------------------------------------------------------------------------------
+ Step all instances by one sample
+--------------------------------------------------------------------------------- */
+int mcufarm_step(
+
+              mcu_farm  * farm      ,
+        const REAL      * pInputs   ,
+              REAL      * pOutputs  ,
+        const int         iStatus   ,
+        const int         iDevice   ,
+              char      * cRunname
+
+) {
+
+    int i, k, iError = MCU_OK;
+
+    farm->pInputs  = pInputs;
+    farm->iStatus  = iStatus;
+    farm->iDevice  = iDevice;
+    farm->cRunname = cRunname;
+
+    if ( iStatus == MCU_STATUS_RUN ) {
+
+        /* Reset the ranges and release the workers */
+        for ( i = 0; i < farm->nThreads; ++i ) {
+            farm_worker * W = FARM_WORKER( farm, i );
+            atomic_store_explicit( &W->iNext, W->iBegin, memory_order_relaxed );
+        }
+
+        pthread_barrier_wait( &farm->barStart );
+        farm_work( farm, 0 );
+        pthread_barrier_wait( &farm->barEnd );
+
+    }
+    else {
+
+        /* Initialization and exit are executed by the calling thread */
+        for ( i = 0; i < farm->N; ++i ) {
+            farm_slot * slot = FARM_SLOT( farm, i );
+            if ( iStatus == MCU_STATUS_INIT ) {
+                strcpy( slot->cMessage, farm->cConfig );
+                sprintf( slot->pMCU->cSimTag, "_T%03d", i );
+            }
+            farm_stepone( farm, i );
+        }
+
+    }
+
+    /* Collect the results */
+    for ( i = 0; i < farm->N; ++i ) {
+        farm_slot * slot = FARM_SLOT( farm, i );
+        for ( k = 0; k < MCU_NR_OUTPUTS; ++k ) pOutputs[ (size_t)i * MCU_NR_OUTPUTS + k ] = slot->pOutputs[k];
+        iError += slot->iError;
+    }
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Release the executor
+--------------------------------------------------------------------------------- */
+int mcufarm_free( mcu_farm * farm )
+{
+    int i, iError = MCU_OK;
+
+    if ( farm == NULL ) return iError;
+
+    /* Stop the workers, which are waiting at the start barrier unless the initialization failed */
+    if ( !farm->iShutdown ) {
+        farm->iShutdown = 1;
+        if ( farm->nStarted > 0 ) pthread_barrier_wait( &farm->barStart );
+    }
+    for ( i = 1; i <= farm->nStarted; ++i ) pthread_join( FARM_WORKER( farm, i )->thread, NULL );
+    pthread_barrier_destroy( &farm->barStart );
+    pthread_barrier_destroy( &farm->barEnd   );
+    pthread_cond_destroy ( &farm->cndGate );
+    pthread_mutex_destroy( &farm->mtxGate );
+
+    for ( i = 0; i < farm->N; ++i ) iError += mcu_instance_destroy( FARM_SLOT( farm, i )->pMCU );
+
+    free( farm->vpSlotsBase   );
+    free( farm->vpWorkersBase );
+    free( farm );
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Access the data of an instance
+--------------------------------------------------------------------------------- */
+REAL * mcufarm_logdata( mcu_farm * farm, const int i )
+{
+    return FARM_SLOT( farm, i )->pLogdata;
+}
+
+char * mcufarm_message( mcu_farm * farm, const int i )
+{
+    return FARM_SLOT( farm, i )->cMessage;
+}
+
+/* ---------------------------------------------------------------------------------
+ Measure the scaling curve of the executor
+--------------------------------------------------------------------------------- */
+int mcufarm_scaling(
+
+        const int         N             ,
+        const int         nSamples      ,
+        const int         nThreadsMax   ,
+        const char      * cConfig       ,
+        const REAL      * pInputs       ,
+              FILE      * fid
+
+) {
+
+    int i, k, n, iError = MCU_OK;
+    int nMax = nThreadsMax > 0 ? nThreadsMax : mcufarm_ncores( );
+    double dTime, dTime1 = 0.0;
+    struct timespec t0, t1;
+    char cRunname[ FILENAMESIZE ] = "";
+
+    REAL * pIn  = (REAL*) calloc( (size_t)N * MCU_NR_INPUTS , sizeof(REAL) );
+    REAL * pOut = (REAL*) calloc( (size_t)N * MCU_NR_OUTPUTS, sizeof(REAL) );
+    if ( pIn == NULL || pOut == NULL ) {
+        free( pIn );
+        free( pOut );
+        return MCU_ERR;
+    }
+    for ( i = 0; i < N; ++i )
+        for ( k = 0; k < MCU_NR_INPUTS; ++k ) pIn[ (size_t)i * MCU_NR_INPUTS + k ] = pInputs[k];
+
+    fprintf( fid, "%8s %12s %16s %10s %10s\n", "threads", "time [s]", "turbine-steps/s", "speed-up", "efficiency" );
+
+    for ( n = 1; n <= nMax; ++n ) {
+
+        mcu_farm * farm = mcufarm_init( N, n, cConfig );
+        if ( farm == NULL ) { ++iError; break; }
+
+        iError += mcufarm_step( farm, pIn, pOut, MCU_STATUS_INIT, PLC, cRunname );
+
+        clock_gettime( CLOCK_MONOTONIC, &t0 );
+        for ( k = 0; k < nSamples; ++k ) {
+            for ( i = 0; i < N; ++i ) pIn[ (size_t)i * MCU_NR_INPUTS + I_MCU_IN_CURRENTTIME ] = pInputs[ I_MCU_IN_CURRENTTIME ] + (k+1) * pInputs[ I_MCU_IN_TIMESTEP ];
+            iError += mcufarm_step( farm, pIn, pOut, MCU_STATUS_RUN, PLC, cRunname );
+        }
+        clock_gettime( CLOCK_MONOTONIC, &t1 );
+
+        iError += mcufarm_step( farm, pIn, pOut, MCU_STATUS_EXIT, PLC, cRunname );
+        iError += mcufarm_free( farm );
+
+        dTime = (double)( t1.tv_sec - t0.tv_sec ) + 1e-9 * (double)( t1.tv_nsec - t0.tv_nsec );
+        if ( n == 1 ) dTime1 = dTime;
+
+        fprintf( fid, "%8d %12.4f %16.0f %10.2f %10.2f\n", n, dTime, (double)N * nSamples / dTime,
+                    dTime1 / dTime, dTime1 / dTime / n );
+        fflush( fid );
+    }
+
+    free( pIn );
+    free( pOut );
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ end mcufarm.c
+--------------------------------------------------------------------------------- */
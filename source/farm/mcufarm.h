@@ -0,0 +1,141 @@
+/* ---------------------------------------------------------------------------------
+ *          file : mcufarm.h                                                      *
+ *   description : C-header file, multi-core executor for many MCU instances      *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _MCUFARM_H_
+#define _MCUFARM_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup moduleMCU
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup moduleFarm Wind farm executor
+
+    The wind farm executor runs a large number of controller instances (see
+    mcu_instance_create()) on a fixed pool of POSIX threads. All instances are
+    stepped in lockstep: mcufarm_step() releases the workers with a barrier,
+    every worker steps the instances of its own range and the calling thread
+    waits at a second barrier until all instances completed the sample.
+
+    Every worker owns a contiguous range of instances. A worker which finished
+    its own range takes the remaining instances of the other workers (work
+    stealing), so an instance which is slow during some samples (e.g. during
+    a start-up transient or while running the DNPC) does not stall the sample
+    on its own thread. The instances and the per-instance I/O slots are aligned
+    to cache lines, so threads never write to the same cache line.
+
+    Initialization and exit involve file I/O and are executed sequentially by
+    the calling thread.
+
+    \sa mcu_instance_step, mcu_run_batch
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  mcufarm.h
+    \brief This header file contains the functions of the wind farm executor.
+*/
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+#define MCUFARM_DEBUGSIZE       200             //!< Size of the debug array of each instance.
+#define MCUFARM_MSGSIZE         (10*BUFSIZE)    //!< Size of the message of each instance.
+
+//! Opaque handle of the wind farm executor.
+typedef struct mcu_farm mcu_farm;
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+//! Create an executor with N controller instances and a pool of threads.
+/*!
+    \param N            [in]    Number of controller instances.
+    \param nThreads     [in]    Number of threads (including the calling thread), a value smaller than one selects all cores.
+    \param cConfig      [in]    Configuration file (controller.ini) used for the initialization of each instance.
+    \return             A pointer to the executor, NULL in case of an error.
+*/
+mcu_farm * mcufarm_init( const int N, const int nThreads, const char * cConfig );
+
+//! Step all instances by one sample.
+/*!
+    \param farm         [in+out]    The executor.
+    \param pInputs      [in]        Inputs of all instances [N][MCU_NR_INPUTS].
+    \param pOutputs     [out]       Outputs of all instances [N][MCU_NR_OUTPUTS].
+    \param iStatus      [in]        Simulation status (#MCU_STATUS_INIT, #MCU_STATUS_RUN and #MCU_STATUS_EXIT).
+    \param iDevice      [in]        System which is running the simulation.
+    \param cRunname     [in+out]    The name of the current simulation, shared by all instances.
+    \return             The sum of the error codes of all instances.
+*/
+int mcufarm_step(
+
+              mcu_farm  * farm      ,
+        const REAL      * pInputs   ,
+              REAL      * pOutputs  ,
+        const int         iStatus   ,
+        const int         iDevice   ,
+              char      * cRunname
+
+);
+
+//! Stop the threads and release the executor and all its instances.
+/*!
+    \param farm         [in]    The executor.
+    \return             A non zero int will be returned in the case an error occurred.
+*/
+int mcufarm_free( mcu_farm * farm );
+
+//! Access the log array of an instance, valid until the next call to mcufarm_step().
+REAL * mcufarm_logdata( mcu_farm * farm, const int i );
+
+//! Access the message of an instance, valid until the next call to mcufarm_step().
+char * mcufarm_message( mcu_farm * farm, const int i );
+
+//! Number of cores available to the process.
+int mcufarm_ncores( void );
+
+//! Measure the scaling curve of the executor from 1 to nThreadsMax threads.
+/*!
+    For each number of threads an executor with N instances is created,
+    initialized and run for nSamples samples with the same input for every
+    instance. The wall clock time of the run samples, the throughput and the
+    speed-up and efficiency with respect to a single thread are written to fid.
+
+    \param N            [in]    Number of controller instances.
+    \param nSamples     [in]    Number of run samples to time.
+    \param nThreadsMax  [in]    Largest number of threads, a value smaller than one selects all cores.
+    \param cConfig      [in]    Configuration file (controller.ini) of the instances.
+    \param pInputs      [in]    Inputs of a single instance [MCU_NR_INPUTS].
+    \param fid          [in]    Stream to write the table to.
+    \return             A non zero int will be returned in the case an error occurred.
+*/
+int mcufarm_scaling(
+
+        const int         N             ,
+        const int         nSamples      ,
+        const int         nThreadsMax   ,
+        const char      * cConfig       ,
+        const REAL      * pInputs       ,
+              FILE      * fid
+
+);
+
+#endif
+
+/** @}*/
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _MCUFARM_H_
+--------------------------------------------------------------------------------- */
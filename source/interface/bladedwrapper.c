@@ -5,6 +5,7 @@
  *        author : DotX Control Solutions, www.dotxcontrol.com                    *
 --------------------------------------------------------------------------------- */
 
+#define _DOTX_HOST_     // Host of the controller: keeps the heap of the process, see staticmem.h
 
 #include "./../signals/signal_definitions_internal.h"
 #include "./../signals/signal_definitions_custom.h"
@@ -19,7 +20,7 @@
  standard function call. This function handles the data exchange with 
  GH Bladed, and calls the controller functions.
 ------------------------------------------------------------------------------ */
-void __declspec(dllexport) __cdecl DISCON(
+void DOTX_EXPORT DOTX_CDECL DISCON(
         
         float * pBladedData    , // Data array shared with GH Bladed   
         int   * pBladedFail    , // Indicator of correct computation
@@ -141,14 +142,16 @@ void __declspec(dllexport) __cdecl DISCON(
     if ( (iStatus == MCU_STATUS_INIT) && (pBladedData [ BLD_ControllerType ] == 0.0F) )
         strcat( cMessage, "\n[bld]  Calling DLL with Collective pitch! rec #28 == 0\n" );
         
-    /* Print message to status file */
-    strcpy( tmp, cOutName );
-    strcat( tmp, ".STATUS" );
-    FILE * fid;
-    if (iStatus == MCU_STATUS_INIT) fid = fopen( tmp, "w"  );
-    else                            fid = fopen( tmp, "a+" );
-    fprintf(fid, "%s", cMessage );
-    fclose(fid);
+    /* Print message to status file, an empty message is not written while deferred by the load shedding */
+    if ( iStatus != MCU_STATUS_RUN || cMessage[0] != '\0' || !mcu_run_shedding( MCU_SHED_STATUS ) ) {
+        strcpy( tmp, cOutName );
+        strcat( tmp, ".STATUS" );
+        FILE * fid;
+        if (iStatus == MCU_STATUS_INIT) fid = fopen( tmp, "w"  );
+        else                            fid = fopen( tmp, "a+" );
+        fprintf(fid, "%s", cMessage );
+        fclose(fid);
+    }
     
 #ifndef _FAST_THROUGH_DISCON
     /* Set logged values in Bladed */
@@ -111,7 +111,7 @@
 //! The entry point off controller. 
 /*! For GH Bladed it is required that the access function is DISCON().
 */
-void __declspec(dllexport) __cdecl DISCON( float*, int*, char*, char*, char* );
+void DOTX_EXPORT DOTX_CDECL DISCON( float*, int*, char*, char*, char* );
 
 /* Automatically generated function (from MATLAB script genconfig.m). Sets signals definitions for GH Bladed. */
 int bladedlogsignals ( float * pBladedData, char * cOutname, const REAL * pLogdata, const int iLogIndex, const int iLogNrVariables  );
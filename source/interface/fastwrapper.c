@@ -5,6 +5,7 @@
  *        author : DotX Control Solutions, www.dotxcontrol.com                    *
 --------------------------------------------------------------------------------- */
 
+#define _DOTX_HOST_     // Host of the controller: keeps the heap of the process, see staticmem.h
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -108,14 +109,16 @@ void discon_ansi_c (
     if ( (iStatus == MCU_STATUS_INIT) && (pBladedData [ BLD_ControllerType ] == 0.0F) )
         strcat( cMessage, "\n[bld]  Calling DLL with Collective pitch! rec #28 == 0\n" );
     
-    /* Print message to status file */
-    strcpy( tmp, cOutName );
-    strcat( tmp, ".STATUS" );
-    FILE * fid;
-    if (iStatus == MCU_STATUS_INIT) fid = fopen( tmp, "w"  );
-    else                            fid = fopen( tmp, "a+" );
-    fprintf(fid, "%s", cMessage );
-    fclose(fid);
+    /* Print message to status file, an empty message is not written while deferred by the load shedding */
+    if ( iStatus != MCU_STATUS_RUN || cMessage[0] != '\0' || !mcu_run_shedding( MCU_SHED_STATUS ) ) {
+        strcpy( tmp, cOutName );
+        strcat( tmp, ".STATUS" );
+        FILE * fid;
+        if (iStatus == MCU_STATUS_INIT) fid = fopen( tmp, "w"  );
+        else                            fid = fopen( tmp, "a+" );
+        fprintf(fid, "%s", cMessage );
+        fclose(fid);
+    }
     
     /* Report error to blaed */
     *pBladedFail = -iFail;
@@ -5,12 +5,14 @@
  *        author : DotX Control Solutions, www.dotxcontrol.com                    *
 --------------------------------------------------------------------------------- */
 
+#define _DOTX_HOST_     // Host of the controller: keeps the heap of the process, see staticmem.h
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "./../signals/signal_definitions_internal.h"
+#include "./../signals/signal_definitions_custom.h"
 #include "./../signals/signal_definitions_external.h"
 
 #include "./../maincontrollerunit.h"
@@ -22,7 +24,7 @@
  * Main entry point of the DLL for the MATLAB toolbox. 
 --------------------------------------------------------------------------------- */
 
-int __declspec(dllexport) __cdecl mcu ( 
+int DOTX_EXPORT DOTX_CDECL mcu ( 
     
         const double * pInputs  , /* [in]     Measurement input */
               double * pOutputs , /* [out]    Controller output */
@@ -45,6 +47,24 @@ int __declspec(dllexport) __cdecl mcu (
     }
     
     /* Call MCU */
+#ifdef FLOATPRECISION
+    /* The toolbox exchanges doubles, convert for the single precision controller */
+    REAL rInputs[ MCU_NR_INPUTS ], rOutputs[ MCU_NR_OUTPUTS ], rDebug[ 200 ], rLogdata[ MAXLOG ];
+    int k, iError;
+
+    for ( k = 0; k < MCU_NR_INPUTS; ++k ) rInputs[k]  = (REAL) pInputs[k];
+    for ( k = 0; k < 200;           ++k ) rDebug[k]   = (REAL) pDebug[k];
+    for ( k = 0; k < MAXLOG;        ++k ) rLogdata[k] = (REAL) pLogdata[k];
+
+    iError = mcu_run( rInputs, rOutputs, rDebug, rLogdata, iStatus, MATLAB, cMessage, NULL );
+
+    for ( k = 0; k < MCU_NR_OUTPUTS; ++k ) pOutputs[k] = (double) rOutputs[k];
+    for ( k = 0; k < 200;            ++k ) pDebug[k]   = (double) rDebug[k];
+    for ( k = 0; k < MAXLOG;         ++k ) pLogdata[k] = (double) rLogdata[k];
+
+    return iError;
+#else
     return mcu_run( pInputs, pOutputs, pDebug, pLogdata, iStatus, MATLAB, cMessage, NULL );
+#endif
     
 } /* end matlabwrapper() */
\ No newline at end of file
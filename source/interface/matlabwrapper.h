@@ -39,7 +39,7 @@
     \return        A non zero int will be returned in the case an error occurred.
 
 */
-int __declspec(dllexport) __cdecl mcu( 
+int DOTX_EXPORT DOTX_CDECL mcu( 
 
         const double * pInputs, 
               double * pOutputs, 
@@ -7,6 +7,7 @@
  *                   Phatas" and "IO_list.pdf"                                    *
 --------------------------------------------------------------------------------- */
 
+#define _DOTX_HOST_     // Host of the controller: keeps the heap of the process, see staticmem.h
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -25,7 +26,7 @@
  * Main entry point of the DLL for phatas. This function must rename this name.
 --------------------------------------------------------------------------------- */
 
-int __declspec(dllexport) _fullxs2control (
+int DOTX_EXPORT _fullxs2control (
 
 /* The first 'const' column states that the value at the address pointed to will
  * not be changed by this function (this is true for DLL inputs).
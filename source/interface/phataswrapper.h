@@ -31,7 +31,7 @@
     For phatas it is required that dll file is called controller.dll and 
     the access function _fullxs2control.
 */
-int __declspec(dllexport) _fullxs2control(
+int DOTX_EXPORT _fullxs2control(
         
               double        * const pdThdtset1,      
               double        * const pdThdtset2,      
@@ -25,7 +25,8 @@ int logdata(
 		char   * cMessage   ,
 		const char   * cSimID     ,
 		const char   * cOutputDir ,
-		const int      iActive
+		const int      iActive    ,
+		      void  ** vpHandle
 
 ) {
 // 	JUAN'S VERSION OF LOGGING, EASIER TO USE, JUST ADD NEW VARIABLES TO SIGNALS_DEFINITIONS_EXTERNAL.H
@@ -34,24 +35,39 @@ int logdata(
 	int k, i;
 	int iError = MCU_OK;
 
-	static char cLog[200];
-	static FILE * fidLog = NULL;
+	char cLog[200];
+#ifdef DOTXSTATICMEM
+	log_stream * pStream = (log_stream*) *vpHandle;
+	FILE * fidLog = ( pStream != NULL ) ? pStream->fid : NULL;
+#else
+	FILE * fidLog = (FILE*) *vpHandle;
+#endif
 
 	// If not active, return
 	if ( !iActive ) return iError;
 
-	// If first call, create file path and name
-	if (iStatus == MCU_STATUS_INIT)
+	// If file not open, create file path and name and open
+	if ( fidLog == NULL  )
 	{
 		strcpy( cLog, cOutputDir );
 		if (iDevice != BLADED) strcat( cLog, cSimID );
 		strcat( cLog, ".tsv" );
-	}
 
-	// If file not open, then open
-	if ( fidLog == NULL  )
-	{
 		fidLog = fopen( cLog, "a+"); // TODO: [JGB] is "a+" OK? I think so.
+#ifdef DOTXSTATICMEM
+		pStream = ( fidLog != NULL ) ? (log_stream*) calloc( 1, sizeof(log_stream) ) : NULL;
+		if ( pStream != NULL ) {
+			pStream->fid = fidLog;
+			setvbuf( fidLog, pStream->cBuffer, _IOFBF, LOG_BUFSIZE );
+		}
+		else if ( fidLog != NULL ) {
+			fclose( fidLog );
+			fidLog = NULL;
+		}
+		*vpHandle = (void*) pStream;
+#else
+		*vpHandle = (void*) fidLog;
+#endif
 	}
 
 	// If file failed to open, return
@@ -63,24 +79,18 @@ int logdata(
 	// If first call, create header
 	if (iStatus == MCU_STATUS_INIT)
 	{
-		for ( k = 0; k < MAXLOG; ++k )
+		for ( k = 0; k < LOG_NR_PACKED; ++k )
 		{
-			if ( dotxLogflags[k] == I_ENABLE )
-			{
-				fprintf( fidLog, "%s\t", tableNames[k] );
-			}
+			fprintf( fidLog, "%s\t", tableNames[ logPacked[k] ] );
 		}
 		fprintf( fidLog, "\n" );
 		fflush(fidLog);
 	}
 
-	// Write log line
-	for ( k = 0; k < MAXLOG; ++k )
+	// Write log line, only the packed channels of this build
+	for ( k = 0; k < LOG_NR_PACKED; ++k )
 	{
-		if ( dotxLogflags[k] == I_ENABLE )
-		{
-			fprintf( fidLog, "%.7e\t", (REAL)pData[k] );
-		}
+		fprintf( fidLog, "%.7e\t", (REAL)pData[ logPacked[k] ] );
 	}
 	fprintf( fidLog, "\n" );
 	fflush(fidLog);
@@ -88,9 +98,28 @@ int logdata(
 	// If exit, close file
 	if (iStatus == MCU_STATUS_EXIT)
 	{
-		fclose( fidLog );
+		logdata_close( vpHandle );
 	}
 
 	return iError;
 
 } /* end logdata() */
+
+/* ---------------------------------------------------------------------------------
+    Close the log file of an aborted simulation
+--------------------------------------------------------------------------------- */
+int logdata_close( void ** vpHandle )
+{
+#ifdef DOTXSTATICMEM
+	if ( *vpHandle != NULL ) {
+		fclose( ( (log_stream*) *vpHandle )->fid );
+		free( *vpHandle );
+	}
+#else
+	if ( *vpHandle != NULL ) fclose( (FILE*) *vpHandle );
+#endif
+	*vpHandle = NULL;
+
+	return MCU_OK;
+
+} /* end logdata_close() */
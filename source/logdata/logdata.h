@@ -26,11 +26,37 @@
 */
 #endif
 
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_STRUCTS
+
+#ifdef DOTXSTATICMEM
+
+#define LOG_BUFSIZE     (4*BUFSIZE)     //!< Size of the stream buffer of the log file [bytes].
+
+/*! \struct log_stream
+    \brief  Handle of a log file in a static memory build, which allocates the stream buffer from the static pools instead of the C library.
+ */
+typedef struct log_stream {
+
+    FILE      * fid                     ;   //!< The log file.
+    char        cBuffer[ LOG_BUFSIZE ]  ;   //!< Its stream buffer.
+
+} log_stream;
+
+#endif
+
+#endif
+
 /* ------------------------------------------------------------------------------ */
 #ifndef DXG_SKIP_FUNCTIONS
 
 //! Store a data array to disc
 /*!
+    The log file (or database) is opened at #MCU_STATUS_INIT and closed at 
+    #MCU_STATUS_EXIT. Its handle is owned by the calling controller instance, 
+    so several instances can log to separate files within one process.
+
+    \param vpHandle [in+out]    Per-instance log handle, must point to NULL before the first call.
     \sa suplib
 */ 
 int logdata( 
@@ -41,10 +67,18 @@ int logdata(
               char   * cMessage   ,
         const char   * cSimID     ,
         const char   * cOutputDir ,
-        const int      iActive     
+        const int      iActive    ,
+              void  ** vpHandle    
         
 );
 
+//! Close a log handle which was not closed by an #MCU_STATUS_EXIT call.
+/*!
+    \param vpHandle [in+out]    Per-instance log handle, set to NULL on return.
+    \return         A non zero int will be returned in the case an error occurred.
+*/ 
+int logdata_close( void ** vpHandle );
+
 #endif
 
 /** @}*/
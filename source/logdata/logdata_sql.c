@@ -16,6 +16,13 @@
 #include "./sqlite3.h"
 #include "logstrings.h"
 
+/* Per-instance state of the database logger */
+typedef struct sql_log_handle {
+    sqlite3      * db   ;
+    sqlite3_stmt * stmt ;
+    int            flag ;
+} sql_log_handle;
+
 /* ---------------------------------------------------------------------------------
     Main call of the log functionaility.
 --------------------------------------------------------------------------------- */
@@ -29,18 +36,18 @@ int logdata(
               char   * cMessage   ,
         const char   * cSimID     ,
         const char   * cOutputDir ,
-        const int      iActive
+        const int      iActive    ,
+              void  ** vpHandle
 
 ) {
 
     int k;
     int iError = MCU_OK;
     
-    static char cLog[200];
-//    static FILE * fidLog;
-    static sqlite3 *db;
-    static sqlite3_stmt* stmt;
-    static int flag = 0;
+    char cLog[200];
+    sql_log_handle * hLog;
+    sqlite3 *db = NULL;
+    sqlite3_stmt* stmt = NULL;
 	int sqlerror;
 	char stmt_text[100];
 	char stmt_large[100000];
@@ -64,6 +71,16 @@ int logdata(
     
     if ( !iActive ) return iError;
     
+    /* Retrieve the handle of this instance, created at the first call */
+    if ( *vpHandle == NULL ) *vpHandle = calloc( 1, sizeof(sql_log_handle) );
+    if ( *vpHandle == NULL ) {
+        strcat( cMessage, "[mcu]  <err> cannot allocate the handle of the logfile\t\n" );
+        return MCU_ERR;
+    }
+    hLog = (sql_log_handle*) *vpHandle;
+    db   = hLog->db;
+    stmt = hLog->stmt;
+    
     switch (iStatus) {
     
         case MCU_STATUS_INIT: {
@@ -76,9 +93,11 @@ int logdata(
             sqlite3_initialize();
 			// Open Database
 			int error = sqlite3_open_v2( cLog, &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL );
+			hLog->db = db;
 			if (error)
 			{
-				sqlite3_close(db);
+				// Close the database and release the handle, the exit or the destruction of the instance finds nothing to close
+				logdata_close( vpHandle );
 				strcat( cMessage, "[mcu]  <err> cannot open logfile <");
 				strcat( cMessage, cLog );
 				strcat( cMessage, ">\t\n" );
@@ -99,7 +118,8 @@ int logdata(
 			sqlerror = sqlite3_prepare_v2(db,stmt_text,-1,&stmt,NULL);
 			if (sqlerror != SQLITE_OK)
 			{
-				sqlite3_close(db);
+				sqlite3_finalize(stmt);
+				logdata_close( vpHandle );
 				strcat( cMessage, "[mcu]  <err> cannot prepare stmt for table creation <");
 				strcat( cMessage, stmt_text );
 				strcat( cMessage, ">\t\n" );
@@ -109,7 +129,8 @@ int logdata(
 			sqlerror = sqlite3_step(stmt);
 			if (sqlerror != SQLITE_DONE)
 			{
-				sqlite3_close(db);
+				sqlite3_finalize(stmt);
+				logdata_close( vpHandle );
 				strcat( cMessage, "[mcu]  <err> cannot execute stmt for table creation <");
 				strcat( cMessage, stmt_text );
 				strcat( cMessage, ">\t\n" );
@@ -132,7 +153,8 @@ int logdata(
 				sqlerror = sqlite3_prepare_v2(db,stmt_text,-1,&stmt,NULL);
 				if (sqlerror != SQLITE_OK)
 				{
-					sqlite3_close(db);
+					sqlite3_finalize(stmt);
+					logdata_close( vpHandle );
 					strcat( cMessage, "[mcu]  <err> cannot prepare stmt for table loop creation <");
 					strcat( cMessage, stmt_text );
 					strcat( cMessage, ">\t\n" );
@@ -142,7 +164,8 @@ int logdata(
 				sqlerror = sqlite3_step(stmt);
 				if (sqlerror != SQLITE_DONE)
 				{
-					sqlite3_close(db);
+					sqlite3_finalize(stmt);
+					logdata_close( vpHandle );
 					strcat( cMessage, "[mcu]  <err> cannot execute stmt for table loop creation <");
 					strcat( cMessage, stmt_text );
 					strcat( cMessage, ">\t\n" );
@@ -181,12 +204,14 @@ int logdata(
 			sqlerror = sqlite3_prepare_v2(db,stmt_large,-1,&stmt,NULL);
 			if (sqlerror != SQLITE_OK)
 			{
-				sqlite3_close(db);
+				sqlite3_finalize(stmt);
+				logdata_close( vpHandle );
 				strcat( cMessage, "[mcu]  <err> cannot prepare stmt for inserting values <");
 				strcat( cMessage, stmt_large );
 				strcat( cMessage, ">\t\n" );
 				return MCU_ERR;
 			}
+			hLog->stmt = stmt;
 
             break;
         }
@@ -194,7 +219,7 @@ int logdata(
 		// -----------------------------------------------------------------------------------
         case MCU_STATUS_RUN: {
 
-        	if (flag == 0)
+        	if (hLog->flag == 0)
         	{
 				// Bind parameters to Reseted Large Statement
 				for ( k = 0; k < MAXLOG; ++k )
@@ -211,7 +236,7 @@ int logdata(
 				sqlerror = sqlite3_step(stmt);
 				if (sqlerror != SQLITE_DONE)
 				{
-					sqlite3_close(db);
+					logdata_close( vpHandle );
 					strcat( cMessage, "[mcu]  <err> cannot EXECUTE stmt for inserting values  <");
 					strcat( cMessage, ">\t\n" );
 					return MCU_ERR;
@@ -221,12 +246,12 @@ int logdata(
         	}
 
 			// Increase flag
-			flag += 1;
+			hLog->flag += 1;
 
 			// Reset flag <--------------------
-        	if (flag > 0)
+        	if (hLog->flag > 0)
         	{
-        		flag = 0;
+        		hLog->flag = 0;
         	}
 
 
@@ -239,6 +264,8 @@ int logdata(
             //fclose( fidLog );
         	sqlite3_finalize(stmt);
         	sqlite3_close(db);
+        	free( hLog );
+        	*vpHandle = NULL;
         
             break;
         }
@@ -247,3 +274,21 @@ int logdata(
     return iError;
     
 } /* end logdata() */
+
+/* ---------------------------------------------------------------------------------
+    Close the database of an aborted simulation
+--------------------------------------------------------------------------------- */
+int logdata_close( void ** vpHandle )
+{
+    sql_log_handle * hLog = (sql_log_handle*) *vpHandle;
+
+    if ( hLog != NULL ) {
+        sqlite3_finalize( hLog->stmt );
+        sqlite3_close( hLog->db );
+        free( hLog );
+    }
+    *vpHandle = NULL;
+
+    return MCU_OK;
+
+} /* end logdata_close() */
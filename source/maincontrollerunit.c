@@ -8,6 +8,10 @@
 
 //#include <windows.h>
 
+#ifdef DOTXPARALLELINIT
+#include <pthread.h>
+#endif
+
 #include "./signals/signal_definitions_internal.h"
 #include "./signals/signal_definitions_custom.h"
 #include "./signals/signal_definitions_external.h"
@@ -34,19 +38,815 @@
 #include "./logdata/logdata.h"
 
 #include "./maincontrollerunit.h"
+#include "./mcuinstance.h"
 
 
 // Place the two line below where you want to access the global pointers.
 //extern mcu_data_static   * g_MCUS;
 //extern mcu_data_dynamic  * g_MCUD;
+// Note that these point to the data of the single instance run by mcu_run().
 mcu_data_static  * g_MCUS = NULL;
 mcu_data_dynamic * g_MCUD = NULL;
 
+/* The single instance used by the simulation packages through mcu_run(), it is kept 
+between the calls so that subsequent calls use the same allocated memory */
+static mcu_instance * pRunMCU = NULL;
+
+#ifdef _DNPC_EXTERNAL
+/* Entry point of the external DNPC library, shared by all instances */
+ImportFunctionDNPC dnpc = NULL;
+static void * vpDnpcLib  = NULL;
+static int    nDnpcUsers = 0;
+
 /* ---------------------------------------------------------------------------------
- Run the MCU to generate output based on the given measurement input
+ Load the external DNPC library at the first initialization
 --------------------------------------------------------------------------------- */
-int mcu_run( 
+static int mcu_dnpc_load( const mcu_data_static * MCUS, char * cMessage )
+{
+	if ( nDnpcUsers++ > 0 ) return MCU_OK;
+
+	vpDnpcLib = plat_library_open( MCUS->dllDNPC );
+	dnpc = (ImportFunctionDNPC) plat_library_symbol( vpDnpcLib, "dnpc" );
+
+	/* The operation module skips the DNPC module if it was not loaded */
+	if ( dnpc == NULL )
+		sprintf( cMessage + strlen( cMessage ), "[mcu]  <wrn> Failed to load the DNPC library %s (%s)\t\n", 
+					MCUS->dllDNPC, plat_library_error( ) );
+
+	return MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Release the external DNPC library at the last exit
+--------------------------------------------------------------------------------- */
+static int mcu_dnpc_release( void )
+{
+	if ( nDnpcUsers == 0 || --nDnpcUsers > 0 ) return MCU_OK;
+
+	dnpc = NULL;
+	int iError = plat_library_close( vpDnpcLib );
+	vpDnpcLib = NULL;
+
+	return iError;
+}
+#endif
+
+/* ---------------------------------------------------------------------------------
+ Parameter files, read in parallel at the initialization with DOTXPARALLELINIT
+--------------------------------------------------------------------------------- */
+enum mcu_initfiles { INIT_MCU, INIT_SUP, INIT_SIM, INIT_EVM, MCU_NR_INITFILES };
+
+static const char * cInitFile[ MCU_NR_INITFILES ] = { "mcu", "sup", "sim", "evm" };
+
+typedef struct mcu_initjob {
+	mcu_instance       * pMCU                  ;
+	int                  iFile                 ;
+	int                  iDevice               ;
+	int                  iError                ;
+	unsigned long long   tElapsed              ;
+	char                 cMessage[ BUFSIZE ]   ;
+} mcu_initjob;
+
+/* ---------------------------------------------------------------------------------
+ Read a single parameter file, the message is collected in the job
+--------------------------------------------------------------------------------- */
+static void * mcu_initfile( void * vpJob )
+{
+	mcu_initjob  * job  = (mcu_initjob*) vpJob;
+	mcu_instance * pMCU = job->pMCU;
+
+	unsigned long long tStart = prof_clock( );
+
+	job->cMessage[0] = '\0';
+	job->iError = MCU_OK;
+
+	DotxAllocModule( cInitFile[ job->iFile ] );
+
+	switch ( job->iFile ) {
+		case INIT_MCU : job->iError = mcu_readfile( pMCU->cSimID, job->iDevice, job->cMessage, pMCU->MCUS, pMCU->MCUD ); break;
+#ifdef _SUP
+		case INIT_SUP : job->iError = sup_readfile( pMCU->cSimID, job->iDevice, job->cMessage, pMCU->SUPS, pMCU->SUPD ); break;
+#endif
+#ifdef _SIM
+		case INIT_SIM : job->iError = sim_readfile( pMCU->cSimID, job->iDevice, job->cMessage, pMCU->SIMS, pMCU->SIMD ); break;
+		case INIT_EVM : job->iError = evm_readfile( pMCU->cSimID, job->iDevice, job->cMessage, pMCU->EVMS, pMCU->EVMD ); break;
+#endif
+		default : break;
+	}
+
+	DotxAllocModule( NULL );
+
+	job->tElapsed = prof_clock( ) - tStart;
+
+	return NULL;
+}
+
+/* ---------------------------------------------------------------------------------
+ Read the parameter files of all modules, the files are independent of each other
+--------------------------------------------------------------------------------- */
+static int mcu_initfiles( mcu_instance * pMCU, const int iDevice, char * cMessage, unsigned long long * tFile )
+{
+	int iError = MCU_OK, k, nFiles = 0;
+	int iFiles[ MCU_NR_INITFILES ];
+	mcu_initjob job[ MCU_NR_INITFILES ];
+
+	/* Files of the modules in this build, in the order of the messages */
+	iFiles[ nFiles++ ] = INIT_MCU;
+#ifdef _SUP
+	iFiles[ nFiles++ ] = INIT_SUP;
+#endif
+#ifdef _SIM
+	iFiles[ nFiles++ ] = INIT_SIM;
+	iFiles[ nFiles++ ] = INIT_EVM;
+#endif
+
+	for ( k = 0; k < nFiles; ++k ) {
+		job[k].pMCU    = pMCU;
+		job[k].iFile   = iFiles[k];
+		job[k].iDevice = iDevice;
+	}
+
+#ifdef DOTXPARALLELINIT
+	/* The first file is read by the calling thread, the others by a thread per file. A file 
+	is read by the calling thread if its thread can not be started. */
+	pthread_t      thread[ MCU_NR_INITFILES ];
+	int            bThread[ MCU_NR_INITFILES ];
+	pthread_attr_t attr;
+
+	/* A small stack, the default stack is committed completely when the memory is locked */
+	pthread_attr_init( &attr );
+	pthread_attr_setstacksize( &attr, PAR_THREAD_STACK );
+
+	for ( k = 1; k < nFiles; ++k ) 
+		bThread[k] = ( pthread_create( &thread[k], &attr, mcu_initfile, &job[k] ) == 0 );
+
+	pthread_attr_destroy( &attr );
+
+	mcu_initfile( &job[0] );
+
+	for ( k = 1; k < nFiles; ++k ) {
+		if ( bThread[k] ) pthread_join( thread[k], NULL );
+		else              mcu_initfile( &job[k] );
+	}
+#else
+	for ( k = 0; k < nFiles; ++k ) mcu_initfile( &job[k] );
+#endif
+
+	for ( k = 0; k < MCU_NR_INITFILES; ++k ) tFile[k] = 0ULL;
+
+	for ( k = 0; k < nFiles; ++k ) {
+		strcat( cMessage, job[k].cMessage );
+		tFile[ job[k].iFile ] = job[k].tElapsed;
+		iError += job[k].iError;
+	}
+
+	return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Report the time spent in the stages of the initialization
+--------------------------------------------------------------------------------- */
+static void mcu_initreport( const mcu_data_static * MCUS, const unsigned long long * tStage, 
+	const unsigned long long * tFile, char * cMessage )
+{
+	int k;
+	REAL dTotal = R_(1e-9) * (REAL)( tStage[0] + tStage[1] + tStage[2] + tStage[3] );
+
+	if ( MCUS->Init_Budget > R_(0.0) && dTotal > MCUS->Init_Budget ) 
+		sprintf( cMessage + strlen( cMessage ), "[mcu]  <wrn> Initialization took %.1f ms, exceeds the budget of %.1f ms\t\n", 
+			R_(1e3) * dTotal, R_(1e3) * MCUS->Init_Budget );
+	else if ( MCUS->Init_Budget > R_(0.0) )
+		sprintf( cMessage + strlen( cMessage ), "[mcu]  Initialization took %.1f ms, budget %.1f ms\t\n", 
+			R_(1e3) * dTotal, R_(1e3) * MCUS->Init_Budget );
+	else
+		sprintf( cMessage + strlen( cMessage ), "[mcu]  Initialization took %.1f ms\t\n", R_(1e3) * dTotal );
+
+	sprintf( cMessage + strlen( cMessage ), "[mcu]  Data structs %.2f ms, configuration %.2f ms, parameter files %.2f ms (", 
+		1e-6 * tStage[0], 1e-6 * tStage[1], 1e-6 * tStage[2] );
+	for ( k = 0; k < MCU_NR_INITFILES; ++k ) 
+		if ( tFile[k] > 0ULL ) sprintf( cMessage + strlen( cMessage ), " %s %.2f", cInitFile[k], 1e-6 * tFile[k] );
+	sprintf( cMessage + strlen( cMessage ), " ), modules %.2f ms\t\n", 1e-6 * tStage[3] );
+
+#ifdef DOTXALLOCAUDIT
+	/* Memory per module of all instances in the process */
+	alloc_report( cMessage );
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+ Construct the data structs of all modules in the arena of an instance, the dynamic
+ data of the MCU last. An arena without memory only counts the bytes.
+--------------------------------------------------------------------------------- */
+static void mcu_instance_carve( mcu_instance * pMCU, mem_arena * a, const REAL * pInputs )
+{
+	pMCU->MCUS = init_mcudatastatic  ( a, pInputs             );
+#ifdef _SUP
+	pMCU->SUPS = init_supdatastatic  ( a, pInputs             );
+	pMCU->SUPD = init_supdatadynamic ( a, pMCU->SUPS, pInputs );
+#endif
+#ifdef _SIM
+	pMCU->SIMS = init_simdatastatic  ( a, pInputs             );
+	pMCU->SIMD = init_simdatadynamic ( a, pMCU->SIMS          );
+	pMCU->EVMS = init_evmdatastatic  ( a, pInputs             );
+	pMCU->EVMD = init_evmdatadynamic ( a, pMCU->EVMS          );
+#endif
+	pMCU->MCUD = init_mcudatadynamic ( a, pMCU->MCUS, pInputs );
+}
+
+/* ---------------------------------------------------------------------------------
+ Allocate the arena of an instance for the objects of all blocks, and construct the
+ data structs of all modules in it
+--------------------------------------------------------------------------------- */
+static int mcu_instance_alloc( mcu_instance * pMCU, const REAL * pInputs )
+{
+	mem_arena a = { NULL, 0, 0 };
+
+	mcu_instance_carve( pMCU, &a, pInputs );
+
+	a.pBase = (char*) plat_aligned_calloc( a.nUsed );
+	if ( a.pBase == NULL ) return MCU_ERR;
+
+	a.nSize = a.nUsed;
+	a.nUsed = 0;
+	mcu_instance_carve( pMCU, &a, pInputs );
+	pMCU->MEM = a;
+
+	return MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Copy a data struct to the next cache line of an arena, the struct stays where it is
+ when the arena only counts
+--------------------------------------------------------------------------------- */
+static void * mcu_instance_copy( mem_arena * a, void * vpStruct, const size_t nBytes )
+{
+	void * vpNew = arena_carve_line( a, nBytes );
+
+	return ( vpNew != NULL ) ? memcpy( vpNew, vpStruct, nBytes ) : vpStruct;
+}
+
+/* ---------------------------------------------------------------------------------
+ Copy the data structs of all modules to an arena in the order of construction, the
+ dynamic data of the MCU without the objects of the removed blocks
+--------------------------------------------------------------------------------- */
+static void mcu_instance_move( mcu_instance * pMCU, mem_arena * a )
+{
+	mcu_data_dynamic * MCUD;
+
+	pMCU->MCUS = mcu_instance_copy( a, pMCU->MCUS, sizeof(mcu_data_static)  );
+#ifdef _SUP
+	pMCU->SUPS = mcu_instance_copy( a, pMCU->SUPS, sizeof(sup_data_static)  );
+	pMCU->SUPD = mcu_instance_copy( a, pMCU->SUPD, sizeof(sup_data_dynamic) );
+#endif
+#ifdef _SIM
+	pMCU->SIMS = mcu_instance_copy( a, pMCU->SIMS, sizeof(sim_data_static)  );
+	pMCU->SIMD = mcu_instance_copy( a, pMCU->SIMD, sizeof(sim_data_dynamic) );
+	pMCU->EVMS = mcu_instance_copy( a, pMCU->EVMS, sizeof(evm_data_static)  );
+	pMCU->EVMD = mcu_instance_copy( a, pMCU->EVMD, sizeof(evm_data_dynamic) );
+#endif
+	MCUD = compact_mcudatadynamic( a, pMCU->MCUD );
+	if ( MCUD != NULL ) pMCU->MCUD = MCUD;
+}
+
+/* ---------------------------------------------------------------------------------
+ Move the data structs of an instance to an arena without the objects of the blocks
+ which were removed from the schedule, and release the arena of all blocks
+--------------------------------------------------------------------------------- */
+static void mcu_instance_compact( mcu_instance * pMCU )
+{
+	mem_arena a = { NULL, 0, 0 };
+	char    * pOld = pMCU->MEM.pBase;
+
+	mcu_instance_move( pMCU, &a );
+
+	/* Without memory for the new arena, or without removed objects, the current one stays in use */
+	if ( a.nUsed >= pMCU->MEM.nUsed ) return;
+	a.pBase = (char*) plat_aligned_calloc( a.nUsed );
+	if ( a.pBase == NULL ) return;
+
+	a.nSize = a.nUsed;
+	a.nUsed = 0;
+	mcu_instance_move( pMCU, &a );
+	pMCU->MEM = a;
+
+	plat_aligned_free( pOld );
+}
+
+/* ---------------------------------------------------------------------------------
+ Release the data structs of all modules of an instance
+--------------------------------------------------------------------------------- */
+static int mcu_instance_release( mcu_instance * pMCU )
+{
+	int iError = MCU_OK;
+
+	/* A shadow which was not exited, it refers to the data of this instance */
+	if ( pMCU->pShadow != NULL ) {
+		iError += mcu_instance_destroy( pMCU->pShadow->pMCU );
+		free( pMCU->pShadow );
+		pMCU->pShadow = NULL;
+	}
+
+	/* The destructors only release the memory outside the arena */
+	if ( pMCU->MCUS != NULL ) iError += free_mcudatastatic(  pMCU->MCUS );
+	if ( pMCU->MCUD != NULL ) iError += free_mcudatadynamic( pMCU->MCUD );
+	pMCU->MCUS = NULL;
+	pMCU->MCUD = NULL;
+
+#ifdef _SUP
+	if ( pMCU->SUPS != NULL ) iError += free_supdatastatic(  pMCU->SUPS );
+	if ( pMCU->SUPD != NULL ) iError += free_supdatadynamic( pMCU->SUPD );
+	pMCU->SUPS = NULL;
+	pMCU->SUPD = NULL;
+#endif
+
+#ifdef _EEC
+	iError += free_eecdatastatic(  EECS );
+	iError += free_eecdatadynamic( EECD );
+#endif
+
+#ifdef _SIM
+	if ( pMCU->SIMS != NULL ) iError += free_simdatastatic(  pMCU->SIMS );
+	if ( pMCU->SIMD != NULL ) iError += free_simdatadynamic( pMCU->SIMD );
+	if ( pMCU->EVMS != NULL ) iError += free_evmdatastatic(  pMCU->EVMS );
+	if ( pMCU->EVMD != NULL ) iError += free_evmdatadynamic( pMCU->EVMD );
+	pMCU->SIMS = NULL;
+	pMCU->SIMD = NULL;
+	pMCU->EVMS = NULL;
+	pMCU->EVMD = NULL;
+#endif
+
+	/* All data structs at once */
+	plat_aligned_free( pMCU->MEM.pBase );
+	memset( &pMCU->MEM, 0, sizeof(mem_arena) );
+
+	return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Allocate an empty controller instance
+--------------------------------------------------------------------------------- */
+mcu_instance * mcu_instance_create( void )
+{
+	mcu_instance * pMCU;
+
+	/* All pointers start at NULL, the data structs are allocated at initialization. One 
+	cache line is added on both sides, so that instances which are stepped by different 
+	threads never share a cache line. */
+	DotxAllocModule( "instance" );
+	char * vpBase = (char*) calloc( 1, sizeof(mcu_instance) + 2*MCU_CACHELINE );
+	DotxAllocModule( NULL );
+	if ( vpBase == NULL ) return NULL;
+
+	pMCU = (mcu_instance*) ( ( (size_t)vpBase + MCU_CACHELINE ) & ~( (size_t)MCU_CACHELINE - 1 ) );
+	pMCU->vpBase = vpBase;
+
+	return pMCU;
+}
+
+/* ---------------------------------------------------------------------------------
+ Release a controller instance
+--------------------------------------------------------------------------------- */
+int mcu_instance_destroy( mcu_instance * pMCU )
+{
+	int iError = MCU_OK;
+
+	if ( pMCU == NULL ) return iError;
+
+	iError += mcu_instance_release( pMCU );
+
+	/* Close the log file if the simulation was aborted */
+	iError += logdata_close( &pMCU->vpLog );
+	par_echo_sync( );
+
+	free( pMCU->vpBase );
+
+	return iError;
+}
+
+#ifdef DOTXPROFILER
+/* ---------------------------------------------------------------------------------
+ Cycle times of a stage of a controller instance
+--------------------------------------------------------------------------------- */
+int mcu_instance_profile( const mcu_instance * pMCU, const int iStage, struct prof_summary * pSummary )
+{
+	return prof_summarize( &pMCU->PROF, iStage, pSummary );
+}
+#endif
+
+/* ---------------------------------------------------------------------------------
+ Load shedding counters of a controller instance
+--------------------------------------------------------------------------------- */
+int mcu_instance_shed( const mcu_instance * pMCU, long * pOverruns, long * pDeferred )
+{
+	int k;
+
+	if ( pMCU->MCUD == NULL ) return MCU_ERR;
+
+	*pOverruns = pMCU->MCUD->Shed_Overruns;
+	if ( pDeferred != NULL )
+		for ( k = 0; k < MCU_NR_SHEDTASKS; ++k ) pDeferred[k] = pMCU->MCUD->Shed_Count[k];
+
+	return MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Numerical health counters of a controller instance
+--------------------------------------------------------------------------------- */
+int mcu_instance_health( const mcu_instance * pMCU, long * pCount )
+{
+	int k;
+
+	if ( pMCU->MCUD == NULL ) return MCU_ERR;
+
+	for ( k = 0; k < HEALTH_NR_EVENTS; ++k ) pCount[k] = pMCU->MCUD->Health_Count[k];
+
+	return MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer the run-time state of an instance, the order is the layout of the checkpoint
+--------------------------------------------------------------------------------- */
+static int mcu_instance_transfer( ckpt_stream * s, mcu_instance * pMCU )
+{
+	int iError = MCU_OK;
+
+	iError += mcu_checkpoint( s, pMCU->MCUD );
+	iError += ckpt_bytes( s, &pMCU->REC, sizeof(base_contr_recipe) );
+#ifdef _SUP
+	iError += sup_checkpoint( s, pMCU->SUPD );
+#endif
+#ifdef _SIM
+	iError += ckpt_bytes( s, pMCU->SIMD, sizeof(sim_data_dynamic) );
+	iError += ckpt_bytes( s, pMCU->EVMD, sizeof(evm_data_dynamic) );
+#endif
+
+	return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Header of a checkpoint: the build which can restore it and the size and checksum 
+ of the state which follows. It is always read into local variables.
+--------------------------------------------------------------------------------- */
+static int mcu_instance_header( ckpt_stream * s, unsigned int * nState, unsigned int * iChecksum )
+{
+	char cMagic[ 8 ];
+	int  iError = MCU_OK;
+
+	memcpy( cMagic, CKPT_MAGIC, sizeof(cMagic) );
+	iError += ckpt_bytes( s, cMagic, sizeof(cMagic) );
+	if ( memcmp( cMagic, CKPT_MAGIC, sizeof(cMagic) ) != 0 ) iError += MCU_ERR;
+
+	iError += ckpt_check( s, CKPT_VERSION       );
+	iError += ckpt_check( s, (int)sizeof(REAL)  );
+	iError += ckpt_check( s, 0x01020304         );
+	iError += ckpt_check( s, NR_BLADES          );
+	iError += ckpt_check( s, N_FILTERS          );
+	iError += ckpt_check( s, MCU_NR_SHEDTASKS   );
+#ifdef _SUP
+	iError += ckpt_check( s, N_TRIGGERS         );
+#else
+	iError += ckpt_check( s, 0                  );
+#endif
+#ifdef _SIM
+	iError += ckpt_check( s, 1                  );
+#else
+	iError += ckpt_check( s, 0                  );
+#endif
+
+	iError += ckpt_bytes( s, nState,    sizeof(unsigned int) );
+	iError += ckpt_bytes( s, iChecksum, sizeof(unsigned int) );
+
+	return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Save the run-time state of a controller instance
+--------------------------------------------------------------------------------- */
+int mcu_instance_save( const mcu_instance * pMCU, void * vpBuffer, size_t * pnSize )
+{
+	ckpt_stream   s;
+	size_t        nHeader, nTotal;
+	unsigned int  nState = 0, iChecksum = 0;
+	int           iError = MCU_OK;
+
+	/* A save only reads the instance, the transfer is shared with the restore */
+	mcu_instance * pInst = (mcu_instance*) pMCU;
+
+	if ( pMCU == NULL || pMCU->MCUS == NULL || pMCU->MCUD == NULL ) return MCU_ERR;
+
+	/* Size of the header and the state */
+	ckpt_open( &s, NULL, 0, CKPT_SAVE );
+	mcu_instance_header( &s, &nState, &iChecksum );
+	nHeader = s.nPos;
+
+	ckpt_open( &s, NULL, 0, CKPT_SAVE );
+	mcu_instance_transfer( &s, pInst );
+	nState = (unsigned int) s.nPos;
+	nTotal = nHeader + nState;
+
+	if ( vpBuffer == NULL ) {
+		*pnSize = nTotal;
+		return MCU_OK;
+	}
+	if ( *pnSize < nTotal ) {
+		*pnSize = nTotal;
+		return MCU_ERR;
+	}
+
+	/* The state first, the header holds its checksum */
+	ckpt_open( &s, (char*) vpBuffer + nHeader, nState, CKPT_SAVE );
+	iError += mcu_instance_transfer( &s, pInst );
+	iChecksum = ckpt_checksum( (char*) vpBuffer + nHeader, nState );
+
+	ckpt_open( &s, vpBuffer, nHeader, CKPT_SAVE );
+	iError += mcu_instance_header( &s, &nState, &iChecksum );
+
+	*pnSize = nTotal;
+
+	return ( iError > MCU_OK ) ? MCU_ERR : MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Restore the run-time state of a controller instance
+--------------------------------------------------------------------------------- */
+int mcu_instance_restore( mcu_instance * pMCU, const void * vpBuffer, const size_t nSize )
+{
+	ckpt_stream     s;
+	size_t          nHeader;
+	unsigned int    nState = 0, iChecksum = 0;
+	unsigned char * pState;
+
+	if ( pMCU == NULL || pMCU->MCUS == NULL || pMCU->MCUD == NULL || vpBuffer == NULL ) return MCU_ERR;
+
+	/* A restore only reads the buffer */
+	ckpt_open( &s, (void*) vpBuffer, nSize, CKPT_RESTORE );
+	if ( mcu_instance_header( &s, &nState, &iChecksum ) > MCU_OK ) return MCU_ERR;
+	nHeader = s.nPos;
+	pState  = (unsigned char*) vpBuffer + nHeader;
+
+	if ( nHeader + nState != nSize || ckpt_checksum( pState, nState ) != iChecksum ) return MCU_ERR;
+
+	/* Check the complete checkpoint before the instance is modified */
+	ckpt_open( &s, pState, nState, CKPT_VERIFY );
+	mcu_instance_transfer( &s, pMCU );
+	if ( s.iError > MCU_OK || s.nPos != nState ) return MCU_ERR;
+
+	ckpt_open( &s, pState, nState, CKPT_RESTORE );
+	mcu_instance_transfer( &s, pMCU );
+
+	return ( s.iError > MCU_OK ) ? MCU_ERR : MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Save and restore the instance run by mcu_run()
+--------------------------------------------------------------------------------- */
+int mcu_run_save( void * vpBuffer, size_t * pnSize )
+{
+	return mcu_instance_save( pRunMCU, vpBuffer, pnSize );
+}
+
+int mcu_run_restore( const void * vpBuffer, const size_t nSize )
+{
+	return mcu_instance_restore( pRunMCU, vpBuffer, nSize );
+}
+
+/* ---------------------------------------------------------------------------------
+ Create an independent copy of an initialized controller instance
+--------------------------------------------------------------------------------- */
+mcu_instance * mcu_instance_clone( const mcu_instance * pSource, const char * cTag )
+{
+	mcu_instance * pMCU;
+	REAL           pInputs[ MCU_NR_INPUTS ];
+	ckpt_stream    s;
+	void         * vpState;
+	size_t         nState;
+	int            iError = MCU_OK;
+
+	if ( pSource == NULL || pSource->MCUS == NULL || pSource->MCUD == NULL ) return NULL;
+
+	pMCU = mcu_instance_create( );
+	if ( pMCU == NULL ) return NULL;
+
+	/* The constructors only need the inputs for initial values, which are overwritten below */
+	memset( pInputs, 0, sizeof(pInputs) );
+
+	if ( mcu_instance_alloc( pMCU, pInputs ) > MCU_OK ) {
+		mcu_instance_destroy( pMCU );
+		return NULL;
+	}
+
+	/* The parameter structs do not contain pointers, they are copied as a whole */
+	*pMCU->MCUS = *pSource->MCUS;
+#ifdef _SUP
+	*pMCU->SUPS = *pSource->SUPS;
+#endif
+#ifdef _SIM
+	*pMCU->SIMS = *pSource->SIMS;
+	*pMCU->EVMS = *pSource->EVMS;
+#endif
+
+	/* The schedule depends on the parameters and the simulation package, which are the same */
+	memcpy( pMCU->MCUD->Block_Active, pSource->MCUD->Block_Active, sizeof(pMCU->MCUD->Block_Active) );
+	pMCU->MCUD->Block_Count = pSource->MCUD->Block_Count;
+	mcu_instance_compact( pMCU );
+
+	/* The clone writes its own log file, which is opened at its first logged sample. A truncated 
+	tag could equal the tag of the source, the clone would then overwrite its log and echo files. */
+	if ( cTag == NULL ) cTag = "";
+	if ( snprintf( pMCU->cSimID,  sizeof(pMCU->cSimID),  "%s%s", pSource->cSimID,  cTag ) >= (int)sizeof(pMCU->cSimID)  ||
+	     snprintf( pMCU->cSimTag, sizeof(pMCU->cSimTag), "%s%s", pSource->cSimTag, cTag ) >= (int)sizeof(pMCU->cSimTag) ) {
+		mcu_instance_destroy( pMCU );
+		return NULL;
+	}
+
+#ifdef DOTXPROFILER
+	prof_reset( &pMCU->PROF );
+#endif
+
+	/* The run-time state is transferred like a checkpoint, so a clone holds exactly the 
+	members which a checkpoint holds. Both instances belong to this build, the header 
+	and the verification are not needed. */
+	ckpt_open( &s, NULL, 0, CKPT_SAVE );
+	mcu_instance_transfer( &s, (mcu_instance*) pSource );
+	nState  = s.nPos;
+	vpState = malloc( nState );
+
+	if ( vpState != NULL ) {
+		ckpt_open( &s, vpState, nState, CKPT_SAVE );
+		iError += mcu_instance_transfer( &s, (mcu_instance*) pSource );
+		ckpt_open( &s, vpState, nState, CKPT_RESTORE );
+		iError += mcu_instance_transfer( &s, pMCU );
+		free( vpState );
+	}
+	else iError += MCU_ERR;
+
+	if ( iError > MCU_OK ) {
+		mcu_instance_destroy( pMCU );
+		return NULL;
+	}
+
+#ifdef _DNPC_EXTERNAL
+	/* The clone releases the DNPC library at its exit as well */
+	nDnpcUsers++;
+#endif
+
+	return pMCU;
+}
+
+/* ---------------------------------------------------------------------------------
+ Start the shadow controller of an initialized instance
+--------------------------------------------------------------------------------- */
+static void mcu_shadow_start( mcu_instance * pMCU, const REAL * pInputs, const int iDevice, char * cMessage, char * cRunname )
+{
+	mcu_shadow * S;
+	FILE       * fid;
+	int          iError;
+
+	if ( pMCU->bShadow || strcmp( pMCU->MCUS->ShadowConfig, "none" ) == 0 ) return;
+
+	/* A missing configuration file disables the shadow, the instance itself runs */
+	fid = fopen( pMCU->MCUS->ShadowConfig, "r" );
+	if ( fid == NULL ) {
+		sprintf( cMessage + strlen( cMessage ), "[mcu]  <wrn> Shadow configuration %s not found, running without shadow\t\n", 
+					pMCU->MCUS->ShadowConfig );
+		return;
+	}
+	fclose( fid );
+
+	DotxAllocModule( "shadow" );
+	S = (mcu_shadow*) calloc( 1, sizeof(mcu_shadow) );
+	DotxAllocModule( NULL );
+	if ( S != NULL ) S->pMCU = mcu_instance_create( );
+	if ( S == NULL || S->pMCU == NULL ) {
+		free( S );
+		strcat( cMessage, "[mcu]  <wrn> Failed to allocate the shadow controller\t\n" );
+		return;
+	}
+
+	/* The shadow writes its own log and echo files, a truncated tag would overwrite those of this instance */
+	S->pMCU->bShadow = TRUE;
+	if ( snprintf( S->pMCU->cSimTag, sizeof(S->pMCU->cSimTag), "%s_SHADOW", pMCU->cSimTag ) >= (int)sizeof(S->pMCU->cSimTag) ) {
+		sprintf( cMessage + strlen( cMessage ), "[mcu]  <wrn> Simulation tag %s too long for the shadow controller, running without shadow\t\n", 
+					pMCU->cSimTag );
+		mcu_instance_destroy( S->pMCU );
+		free( S );
+		return;
+	}
+
+	strcpy( S->cMessage, pMCU->MCUS->ShadowConfig );
+	iError = mcu_instance_step( S->pMCU, pInputs, S->pOutputs, S->pDebug, S->pLogdata, 
+				MCU_STATUS_INIT, iDevice, S->cMessage, cRunname );
+
+	if ( iError > MCU_OK ) {
+		sprintf( cMessage + strlen( cMessage ), "[mcu]  <wrn> Failed to initialize the shadow controller %s, running without shadow\t\n", 
+					pMCU->MCUS->ShadowConfig );
+		mcu_instance_destroy( S->pMCU );
+		free( S );
+		return;
+	}
+
+	/* Equal rotor speed filters: the shadow takes the filtered signals of this instance */
+	S->iShared = base_controller_share( S->pMCU->MCUS, S->pMCU->MCUD, pMCU->MCUS, pMCU->MCUD );
+	pMCU->pShadow = S;
+
+	sprintf( cMessage + strlen( cMessage ), "[mcu]  Shadow controller %s started, rotor speed filters %s\t\n", 
+				pMCU->MCUS->ShadowConfig, S->iShared ? "shared" : "not shared" );
+}
+
+/* ---------------------------------------------------------------------------------
+ Run one sample of the shadow controller, on the inputs of its lead instance. The 
+ errors and outputs of the shadow are kept in the shadow, the lead only logs them.
+--------------------------------------------------------------------------------- */
+static unsigned long long mcu_shadow_step( mcu_instance * pMCU, const REAL * pInputs, const int iStatus, 
+					const int iDevice, REAL * pLogdata, char * cRunname )
+{
+	mcu_shadow * S = pMCU->pShadow;
+	unsigned long long tShadow = prof_clock( );
+
+	S->iErrors += mcu_instance_step( S->pMCU, pInputs, S->pOutputs, S->pDebug, S->pLogdata, 
+					iStatus, iDevice, S->cMessage, cRunname );
+	tShadow = prof_clock( ) - tShadow;
+
+	S->tLast  = tShadow;
+	S->tSum  += tShadow;
+	if ( tShadow > S->tMax ) S->tMax = tShadow;
+	S->nSteps++;
+
+	LOG_STORE( pLogdata, SHADOW_COST          , R_(1e-9) * (REAL) tShadow );
+	LOG_STORE( pLogdata, SHADOW_DEM_GENTORQUE , S->pOutputs[ I_MCU_OUT_DEM_GENTORQUE   ] );
+	LOG_STORE( pLogdata, SHADOW_DEM_PITCH1    , S->pOutputs[ I_MCU_OUT_DEM_PITCHANGLE1 ] );
+	LOG_STORE( pLogdata, SHADOW_DEM_PITCH2    , S->pOutputs[ I_MCU_OUT_DEM_PITCHANGLE2 ] );
+#if NR_BLADES == 3
+	LOG_STORE( pLogdata, SHADOW_DEM_PITCH3    , S->pOutputs[ I_MCU_OUT_DEM_PITCHANGLE3 ] );
+#endif
+
+	return tShadow;
+}
+
+/* ---------------------------------------------------------------------------------
+ Exit and release the shadow controller, and report its cost
+--------------------------------------------------------------------------------- */
+static int mcu_shadow_stop( mcu_instance * pMCU, const REAL * pInputs, const int iDevice, char * cMessage, char * cRunname )
+{
+	mcu_shadow * S = pMCU->pShadow;
+	int iError = MCU_OK;
+
+	S->iErrors += mcu_instance_step( S->pMCU, pInputs, S->pOutputs, S->pDebug, S->pLogdata, 
+					MCU_STATUS_EXIT, iDevice, S->cMessage, cRunname );
+
+	sprintf( cMessage + strlen( cMessage ), "[mcu]  Shadow controller: %ld samples, mean %.1f us, max %.1f us, rotor speed filters %s, %s\t\n",
+				S->nSteps, ( S->nSteps > 0 ) ? 1e-3 * (double) S->tSum / S->nSteps : 0.0, 1e-3 * (double) S->tMax, 
+				S->iShared ? "shared" : "not shared", ( S->iErrors > MCU_OK ) ? "with errors" : "no errors" );
+
+	iError += mcu_instance_destroy( S->pMCU );
+	free( S );
+	pMCU->pShadow = NULL;
+
+	return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Outputs and cost of the shadow controller of an instance
+--------------------------------------------------------------------------------- */
+int mcu_instance_shadow( const mcu_instance * pMCU, REAL * pOutputs, REAL * pCost )
+{
+	const mcu_shadow * S;
+	int k;
+
+	if ( pMCU == NULL || pMCU->pShadow == NULL ) return MCU_ERR;
+	S = pMCU->pShadow;
+
+	if ( pOutputs != NULL ) 
+		for ( k = 0; k < MCU_NR_OUTPUTS; ++k ) pOutputs[k] = S->pOutputs[k];
+
+	if ( pCost != NULL ) {
+		pCost[0] = R_(1e-9) * (REAL) S->tLast;
+		pCost[1] = ( S->nSteps > 0 ) ? R_(1e-9) * (REAL) S->tSum / (REAL) S->nSteps : R_(0.0);
+		pCost[2] = R_(1e-9) * (REAL) S->tMax;
+	}
+
+	return MCU_OK;
+}
+
+int mcu_run_shadow( REAL * pOutputs, REAL * pCost )
+{
+	return mcu_instance_shadow( pRunMCU, pOutputs, pCost );
+}
+
+/* ---------------------------------------------------------------------------------
+ Check if a task of the instance run by mcu_run() is deferred
+--------------------------------------------------------------------------------- */
+int mcu_run_shedding( const int iTask )
+{
+	return ( g_MCUD != NULL && mcu_shed( g_MCUD, iTask, MCU_STATUS_RUN ) );
+}
 
+/* ---------------------------------------------------------------------------------
+ Run one sample of a controller instance
+--------------------------------------------------------------------------------- */
+int mcu_instance_step( 
+
+			  mcu_instance * pMCU     , /* [in/out] Controller instance */
 		const REAL   * pInputs        , /* [in]     Measurement input */
 			  REAL   * pOutputs       , /* [out]    Controller output */
 			  REAL   * pDebug         , /* [in/out] Debug array */
@@ -62,31 +862,30 @@ int mcu_run(
 
 	int k;
 
-	/* Data structs for the MCU, note how they are declared static, which enables
-    subsequent calls to use the same allocated memory */
-	static mcu_data_static  * MCUS  ;
-	static mcu_data_dynamic * MCUD  ;
+	/* Time spent in the shadow controller, it does not count for the load shedding */
+	unsigned long long tShadow = 0ULL;
 
-#ifdef _SUP
-	static sup_data_static  * SUPS  ;
-	static sup_data_dynamic * SUPD  ;
-#else
-	void * SUPS, * SUPD;
+	/* Time spent in the stages of the initialization: data structs, configuration, 
+	parameter files and modules, and in reading each parameter file */
+	unsigned long long tInit = 0ULL, tStage[4] = { 0ULL, 0ULL, 0ULL, 0ULL }, tFile[ MCU_NR_INITFILES ];
+
+#ifndef _SUP
+	void * SUPS = NULL, * SUPD = NULL;
 #endif
 
+#ifndef _SIM
+	void * SIMS = NULL, * EVMS = NULL ;
+#endif
 
-#ifdef _SIM
-	static sim_data_static  * SIMS  ;
-	static sim_data_dynamic * SIMD  ;
-	static evm_data_static  * EVMS  ;
-	static evm_data_dynamic * EVMD  ;
-#else
-	void * SIMS, * SIMD, * EVMS, * EVMD ;
+#ifdef DOTXALLOCAUDIT
+	/* Heap operations of this thread before the sample */
+	long nHeapOps = alloc_count( );
 #endif
 
-	/* Par file en simulation settings */
-	char cParFile[200], cTmp2[200] ;
-	static char cSimID[200];
+	/* Only run samples are profiled, unless the statistics are deferred by the load shedding */
+	DotxProfSelect( &pMCU->PROF, iStatus == MCU_STATUS_RUN && 
+		!( pMCU->MCUD != NULL && mcu_shed( pMCU->MCUD, MCU_SHED_STATISTICS, iStatus ) ) );
+	DotxProfBegin( PROF_TOTAL );
 
 	/* In all cases initialize the output to zero */
 	for ( k = 0; k < MCU_NR_OUTPUTS; ++k ) pOutputs[k] = 0.0;
@@ -96,46 +895,120 @@ int mcu_run(
 
 	if ( iStatus == MCU_STATUS_INIT )
 	{
+		tInit = prof_clock( );
 
-		/* Initialize all parameters and structs used by the controller */
+		/* Release data of a previous simulation which was not exited */
+		iError += mcu_instance_release( pMCU );
+		iError += logdata_close( &pMCU->vpLog );
 
-		MCUS = init_mcudatastatic  ( pInputs        );
-		MCUD = init_mcudatadynamic ( MCUS, pInputs  );
-		g_MCUS = MCUS;
-		g_MCUD = MCUD;
+		/* Initialize all parameters and structs used by the controller, in one arena 
+		which is charged to the instance */
 
-#ifdef _SUP
-		SUPS = init_supdatastatic  ( pInputs        );
-		SUPD = init_supdatadynamic ( SUPS, pInputs  );
-#endif
+		DotxAllocModule( "instance" );
+		iError += mcu_instance_alloc( pMCU, pInputs );
+		DotxAllocModule( NULL );
 
 #ifdef _EEC
 		EECS = init_eecdatastatic  ( pInputs        );
 		EECD = init_eecdatadynamic ( EECS, pInputs  );
 #endif
 
+		memset( &pMCU->REC, 0, sizeof(base_contr_recipe) );
+
+#ifdef DOTXPROFILER
+		prof_reset( &pMCU->PROF );
+#endif
+
+#ifdef DOTXSTATICMEM
+		/* A static pool which is too small fails the initialization */
+		if ( mem_check( cMessage ) > MCU_OK ) {
+			mcu_instance_release( pMCU );
+			return MCU_ERR;
+		}
+#endif
+
+		tStage[0] = prof_clock( ) - tInit;
+	}
+
+	/* Local copies of the data pointers of this instance */
+	mcu_data_static  * MCUS = pMCU->MCUS ;
+	mcu_data_dynamic * MCUD = pMCU->MCUD ;
+#ifdef _SUP
+	sup_data_static  * SUPS = pMCU->SUPS ;
+	sup_data_dynamic * SUPD = pMCU->SUPD ;
+#endif
 #ifdef _SIM
-		SIMS = init_simdatastatic  ( pInputs        );
-		SIMD = init_simdatadynamic ( SIMS           );
-		EVMS = init_evmdatastatic  ( pInputs        );
-		EVMD = init_evmdatadynamic ( EVMS           );
+	sim_data_static  * SIMS = pMCU->SIMS ;
+	sim_data_dynamic * SIMD = pMCU->SIMD ;
+	evm_data_static  * EVMS = pMCU->EVMS ;
+	evm_data_dynamic * EVMD = pMCU->EVMD ;
 #endif
+
+	/* The controller has not been initialized */
+	if ( MCUS == NULL || MCUD == NULL ) return MCU_ERR;
+
+	/* Start of the sample, only required for the load shedding */
+	unsigned long long tStart = ( MCUS->Shed_Budget > R_(0.0) ) ? prof_clock( ) : 0ULL;
+
+	/* Flush subnormal numbers to zero during the sample, otherwise the states are snapped */
+	unsigned long iFpuMode;
+	int bFlush = plat_fpu_flush( &iFpuMode );
+	health_select( MCUD->Health_Count, !bFlush );
+
+	if ( iStatus == MCU_STATUS_INIT )
+	{
 		/* Read configuration in controller.ini */
 
-		iError += readconfiguration ( iDevice, cSimID, cMessage, cRunname, MCUS, SUPS, SIMS, EVMS );
-		/* Load parameter files */
+		tInit = prof_clock( );
+		iError += readconfiguration ( iDevice, pMCU->cSimID, cMessage, cRunname, MCUS, SUPS, SIMS, EVMS );
+
+		/* The tag distinguishes the log files of the instances, a truncated ID could be shared */
+		size_t nSimID = strlen( pMCU->cSimID ), nSimTag = strlen( pMCU->cSimTag );
+		if ( nSimID + nSimTag < sizeof(pMCU->cSimID) )
+			memcpy( pMCU->cSimID + nSimID, pMCU->cSimTag, nSimTag + 1 );
+		else {
+			sprintf( cMessage + strlen( cMessage ), "[mcu]  <err> Simulation ID %s with tag %s exceeds %d characters\t\n", 
+						pMCU->cSimID, pMCU->cSimTag, (int)sizeof(pMCU->cSimID) - 1 );
+			iError += MCU_ERR;
+		}
+
+#ifdef _DNPC_EXTERNAL
+		iError += mcu_dnpc_load( MCUS, cMessage );
+#endif
+		tStage[1] = prof_clock( ) - tInit;
+
+		/* Load parameter files, which are independent of each other */
 
-		iError += mcu_readfile( cSimID, iDevice, cMessage, MCUS, MCUD );
+		tInit = prof_clock( );
+		iError += mcu_initfiles( pMCU, iDevice, cMessage, tFile );
+		tStage[2] = prof_clock( ) - tInit;
 
+		/* Constants which only depend on the parameters */
+		iError += mcu_derive( MCUS, MCUD );
+
+		/* Remove the blocks which do not reach an actuator or a read log channel */
+		mcu_schedule( MCUS, MCUD, iDevice, cMessage );
+
+		/* Release the objects of the removed blocks, the data structs may move */
+		DotxAllocModule( "instance" );
+		mcu_instance_compact( pMCU );
+		DotxAllocModule( NULL );
+		MCUS = pMCU->MCUS;
+		MCUD = pMCU->MCUD;
 #ifdef _SUP
-		iError += sup_readfile( cSimID, iDevice, cMessage, SUPS, SUPD );
+		SUPS = pMCU->SUPS;
+		SUPD = pMCU->SUPD;
 #endif
-
 #ifdef _SIM
-		iError += sim_readfile( cSimID, iDevice, cMessage, SIMS, SIMD );
-		iError += evm_readfile( cSimID, iDevice, cMessage, EVMS, EVMD );
+		SIMS = pMCU->SIMS;
+		SIMD = pMCU->SIMD;
+		EVMS = pMCU->EVMS;
+		EVMD = pMCU->EVMD;
 #endif
+		health_select( MCUD->Health_Count, !bFlush );
 
+		/* Initialization of the modules */
+		tInit = prof_clock( );
 	}
 	else {
 
@@ -149,28 +1022,71 @@ int mcu_run(
 
 	/* Call the supervisory module */
 #ifdef _SUP
+	DotxProfBegin( PROF_SUPERVISORY );
 	iError += supervisory ( pInputs, pOutputs, pLogdata, iStatus, MCUS, MCUD, SUPS, SUPD );
 	iSuperState = SUPD->STATE_INTINDEX ;
+	DotxProfEnd( PROF_SUPERVISORY );
 #endif
 
 	/* Call the operation module, note that without supervisory control, the state index always
         remains at its initialized value (=OFF) */
-	iError += operation ( pInputs, pOutputs, pDebug, pLogdata, iStatus, cMessage, MCUS, MCUD, iSuperState );
+	DotxProfBegin( PROF_OPERATION );
+	iError += operation ( pInputs, pOutputs, pDebug, pLogdata, iStatus, cMessage, MCUS, MCUD, &pMCU->REC, iSuperState );
+	DotxProfEnd( PROF_OPERATION );
 
 
 	/* Call the supervisory module -> post procedure */
 #ifdef _SUP
+	DotxProfBegin( PROF_POSTPROCEDURE );
 	iError += postprocedure ( pInputs, pOutputs, pLogdata, iStatus, SUPS, SUPD );
+	DotxProfEnd( PROF_POSTPROCEDURE );
 #endif
 
 	/* Call the simulation module */
 #ifdef _SIM
+	DotxProfBegin( PROF_SIMULATION );
 	iError += simulation ( pInputs, pOutputs, pLogdata, iStatus, MCUS, MCUD, SUPS, SUPD, SIMS, SIMD, EVMS, EVMD );
+	DotxProfEnd( PROF_SIMULATION );
 #endif
 
+	/* Call the shadow controller, it uses the profiler of its own instance */
+	if ( pMCU->pShadow != NULL && iStatus == MCU_STATUS_RUN ) {
+		tShadow = mcu_shadow_step( pMCU, pInputs, iStatus, iDevice, pLogdata, cRunname );
+		DotxProfSelect( &pMCU->PROF, !mcu_shed( MCUD, MCU_SHED_STATISTICS, iStatus ) );
+		health_select( MCUD->Health_Count, !bFlush );
+	}
+
+	/* Store all logged signals to the disc, once every Log_Decimation samples */
+	DotxProfBegin( PROF_LOGDATA );
+	if ( RATE_DUE( MCUS->Log_Decimation, MCUD->iSample, iStatus ) && !mcu_shed( MCUD, MCU_SHED_LOGDATA, iStatus ) ) {
+		DotxAllocModule( "logdata" );
+		iError += logdata ( pLogdata, iStatus, iDevice, cMessage, pMCU->cSimID, MCUS->LogDir, MCUS->Log_ON, &pMCU->vpLog );
+		DotxAllocModule( NULL );
+	}
+	DotxProfEnd( PROF_LOGDATA );
+
+	if ( iStatus == MCU_STATUS_RUN ) {
 
-	/* Store all logged signals to the disc */
-	iError += logdata ( pLogdata, iStatus, iDevice, cMessage, cSimID, MCUS->LogDir, MCUS->Log_ON );
+		/* Defer low-criticality tasks in the next samples if this sample was too slow */
+		if ( MCUS->Shed_Budget > R_(0.0) ) 
+			mcu_shed_update( MCUS, MCUD, R_(1e-9) * (REAL)( prof_clock( ) - tStart - tShadow ) );
+
+		/* Next sample of the multi-rate tasks */
+		MCUD->iSample++;
+	}
+
+	DotxProfEnd( PROF_TOTAL );
+
+#ifdef DOTXALLOCAUDIT
+	/* The control loop should never touch the heap */
+	if ( iStatus == MCU_STATUS_RUN && alloc_count( ) != nHeapOps ) {
+		int iLine;
+		const char * cFile = alloc_site( &iLine );
+		sprintf( cMessage + strlen( cMessage ), "[mcu]  <err> %ld heap operation(s) during run, last at %s:%d\t\n",
+					alloc_count( ) - nHeapOps, cFile, iLine );
+		iError += MCU_ERR;
+	}
+#endif
 
 	/* Exit the controller */
 
@@ -178,26 +1094,50 @@ int mcu_run(
 
 		strcat( cMessage, "\n" );
 
-		/* Release allocated memory */
-		int iErrorTMP = iError;
-		iError += free_mcudatastatic(  MCUS );
-		iError += free_mcudatadynamic( MCUD );
-
-#ifdef _SUP
-		iError += free_supdatastatic(  SUPS );
-		iError += free_supdatadynamic( SUPD );
+		/* The echo files of the parameter files are complete after the exit */
+		par_echo_sync( );
+
+		/* Report the load shedding */
+		if ( MCUS->Shed_Budget > R_(0.0) ) {
+			sprintf( cMessage + strlen( cMessage ), "[mcu]  Load shedding: %ld overrun(s), deferred samples", MCUD->Shed_Overruns );
+			for ( k = 0; k < MCU_NR_SHEDTASKS; ++k ) sprintf( cMessage + strlen( cMessage ), " %ld", MCUD->Shed_Count[k] );
+			strcat( cMessage, "\t\n" );
+		}
+
+		/* Report the numerical health */
+		for ( k = 0; k < HEALTH_NR_EVENTS && MCUD->Health_Count[k] == 0; ++k );
+		if ( k < HEALTH_NR_EVENTS ) {
+			sprintf( cMessage + strlen( cMessage ), "[mcu]  Numerical health: non-finite state reset %ld filter(s) and %ld PID(s), subnormal state snapped %ld filter(s) and %ld PID(s)\t\n", 
+				MCUD->Health_Count[ HEALTH_FILTER_RESET ], MCUD->Health_Count[ HEALTH_PID_RESET ], 
+				MCUD->Health_Count[ HEALTH_FILTER_SNAP  ], MCUD->Health_Count[ HEALTH_PID_SNAP  ] );
+		}
+
+#ifdef DOTXPROFILER
+		/* Store the cycle times next to the log file */
+		char cProfile[ FILENAMESIZE ];
+		strcpy( cProfile, MCUS->LogDir );
+		if ( iDevice != BLADED ) strcat( cProfile, pMCU->cSimID );
+		strcat( cProfile, "_profile.tsv" );
+
+		if ( prof_write( &pMCU->PROF, cProfile ) > MCU_OK ) {
+			strcat( cMessage, "[mcu]  <err> Failed to write the cycle times\t\n" );
+			iError += MCU_ERR;
+		}
+		else
+			strcat( cMessage, "[mcu]  Cycle times written to the log directory\t\n" );
 #endif
 
-#ifdef _EEC
-		iError += free_eecdatastatic(  EECS );
-		iError += free_eecdatadynamic( EECD );
-#endif
+		/* Exit the shadow controller before the data it shares is released */
+		if ( pMCU->pShadow != NULL ) iError += mcu_shadow_stop( pMCU, pInputs, iDevice, cMessage, cRunname );
 
-#ifdef _SIM
-		iError += free_simdatastatic(  SIMS );
-		iError += free_simdatadynamic( SIMD );
-		iError += free_evmdatastatic(  EVMS );
-		iError += free_evmdatadynamic( EVMD );
+		/* The counters are released with the data */
+		health_select( NULL, FALSE );
+
+		/* Release allocated memory */
+		int iErrorTMP = iError;
+		iError += mcu_instance_release( pMCU );
+#ifdef _DNPC_EXTERNAL
+		iError += mcu_dnpc_release( );
 #endif
 
 		if ( iError-iErrorTMP > MCU_OK )
@@ -211,6 +1151,19 @@ int mcu_run(
 
 
 
+	/* Restore the floating-point mode of the host */
+	if ( bFlush ) plat_fpu_restore( iFpuMode );
+
+	/* Report the time spent in the initialization */
+
+	if ( iStatus == MCU_STATUS_INIT && pMCU->MCUS != NULL ) {
+		tStage[3] = prof_clock( ) - tInit;
+		mcu_initreport( pMCU->MCUS, tStage, tFile, cMessage );
+
+		/* The shadow controller is initialized after this instance, on the same inputs */
+		mcu_shadow_start( pMCU, pInputs, iDevice, cMessage, cRunname );
+	}
+
 	/* Cosmetic empty line in message */
 
 	if ( iStatus == MCU_STATUS_INIT ) strcat( cMessage, "\t\n" );
@@ -221,6 +1174,298 @@ int mcu_run(
 
 }
 
+/* ---------------------------------------------------------------------------------
+ Select an instance of a batch for the next module, and count its time and heap 
+ operations until mcu_batch_leave()
+--------------------------------------------------------------------------------- */
+static void mcu_batch_enter( mcu_instance * pInst, const int iStatus, const int bFlush )
+{
+	DotxProfSelect( &pInst->PROF, !mcu_shed( pInst->MCUD, MCU_SHED_STATISTICS, iStatus ) );
+	health_select( pInst->MCUD->Health_Count, !bFlush );
+
+#ifdef DOTXPROFILER
+	pInst->tBatch -= prof_clock( );
+#endif
+#ifdef DOTXALLOCAUDIT
+	pInst->nBatchHeap -= alloc_count( );
+#endif
+}
+
+static void mcu_batch_leave( mcu_instance * pInst )
+{
+#ifdef DOTXPROFILER
+	pInst->tBatch += prof_clock( );
+#endif
+#ifdef DOTXALLOCAUDIT
+	pInst->nBatchHeap += alloc_count( );
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+ Run one sample of a batch of controller instances
+--------------------------------------------------------------------------------- */
+int mcu_run_batch( 
+
+			  mcu_instance ** pMCU    , /* [in/out] Array of N controller instances */
+		const int      N              , /* [in]     Number of instances */
+		const REAL   * pInputs        , /* [in]     Measurement input [N][MCU_NR_INPUTS] */
+			  REAL   * pOutputs       , /* [out]    Controller output [N][MCU_NR_OUTPUTS] */
+			  REAL   * pDebug         , /* [in/out] Debug arrays [N][iDebugSize] */
+		const int      iDebugSize     , /* [in]     Size of a single debug array */
+			  REAL   * pLogdata       , /* [in/out] Logdata arrays [N][MAXLOG] */
+			  int    * iErrors        , /* [out]    Error code per instance [N], may be NULL */
+		const int      iStatus        , /* [in]     Simulation status, see defines */
+		const int      iDevice        , /* [in]     System which is running the simulation */
+			  char   * cMessage       , /* [in/out] System messages [N][iMessageSize] */
+		const int      iMessageSize   , /* [in]     Size of a single message */
+			  char   * cRunname         /* [in/out] Optional runname definition (bladed only) */
+
+) {
+
+	int i, i0, k, iError = MCU_OK;
+
+	/* Start of the sample, used by the load shedding, without the time of the shadow controllers */
+	unsigned long long tStart = prof_clock( ), tShadow = 0ULL;
+
+	/* Initialization and exit are executed instance by instance */
+	if ( iStatus != MCU_STATUS_RUN ) {
+
+		for ( i = 0; i < N; ++i ) {
+
+			/* Instances of a batch should not share their log files */
+			if ( iStatus == MCU_STATUS_INIT ) sprintf( pMCU[i]->cSimTag, "_T%03d", i );
+
+			int iErrorInst = mcu_instance_step( pMCU[i], 
+				pInputs  + i*MCU_NR_INPUTS , pOutputs + i*MCU_NR_OUTPUTS, 
+				pDebug   + i*iDebugSize    , pLogdata + i*MAXLOG        , 
+				iStatus, iDevice, cMessage + i*iMessageSize, cRunname );
+
+			if ( iErrors != NULL ) iErrors[i] = iErrorInst;
+			iError += iErrorInst;
+		}
+		return iError;
+	}
+
+	/* An uninitialized instance disables the complete batch */
+	for ( i = 0; i < N; ++i ) 
+		if ( pMCU[i]->MCUS == NULL || pMCU[i]->MCUD == NULL ) return MCU_ERR;
+
+	/* Flush subnormal numbers to zero during the sample, otherwise the states are snapped */
+	unsigned long iFpuMode;
+	int bFlush = plat_fpu_flush( &iFpuMode );
+
+	/* Clear outputs, messages and errors */
+	for ( i = 0; i < N; ++i ) {
+		for ( k = 0; k < MCU_NR_OUTPUTS; ++k ) pOutputs[ i*MCU_NR_OUTPUTS + k ] = 0.0;
+		cMessage[ i*iMessageSize ] = '\0';
+		if ( iErrors != NULL ) iErrors[i] = MCU_OK;
+#ifdef DOTXPROFILER
+		pMCU[i]->tBatch = 0ULL;
+#endif
+#ifdef DOTXALLOCAUDIT
+		pMCU[i]->nBatchHeap = 0L;
+#endif
+	}
+
+	/* Each module is executed for all instances before moving to the next module, so 
+	the code and parameters of one module stay in cache during the loop */
+#ifdef _SUP
+	for ( i = 0; i < N; ++i ) {
+		mcu_instance * pInst = pMCU[i];
+		mcu_batch_enter( pInst, iStatus, bFlush );
+		DotxProfBegin( PROF_SUPERVISORY );
+		k  = supervisory ( pInputs + i*MCU_NR_INPUTS, pOutputs + i*MCU_NR_OUTPUTS, pLogdata + i*MAXLOG, 
+			iStatus, pInst->MCUS, pInst->MCUD, pInst->SUPS, pInst->SUPD );
+		DotxProfEnd( PROF_SUPERVISORY );
+		mcu_batch_leave( pInst );
+		if ( iErrors != NULL ) iErrors[i] += k;
+		iError += k;
+	}
+#endif
+
+	/* The rotor speed of all instances is filtered in tiles, filter by filter with the 
+	states of the instances of a tile next to each other, see base_controller_batch() */
+	for ( i0 = 0; i0 < N; i0 += FILTER_BANK_WIDTH ) {
+
+		const mcu_data_static * TileS[ FILTER_BANK_WIDTH ];
+		mcu_data_dynamic      * TileD[ FILTER_BANK_WIDTH ];
+		const int n = MIN( FILTER_BANK_WIDTH, N - i0 );
+
+		for ( i = 0; i < n; ++i ) {
+			TileS[i] = pMCU[i0+i]->MCUS;
+			TileD[i] = pMCU[i0+i]->MCUD;
+		}
+
+		/* The time of the tile is shared by its instances, its heap operations are charged to the first one */
+#ifdef DOTXPROFILER
+		unsigned long long tTile = prof_clock( );
+#endif
+#ifdef DOTXALLOCAUDIT
+		pMCU[i0]->nBatchHeap -= alloc_count( );
+#endif
+
+		iError += base_controller_batch( pInputs + i0*MCU_NR_INPUTS, n, TileS, TileD, !bFlush );
+
+#ifdef DOTXALLOCAUDIT
+		pMCU[i0]->nBatchHeap += alloc_count( );
+#endif
+#ifdef DOTXPROFILER
+		tTile = prof_clock( ) - tTile;
+		for ( i = 0; i < n; ++i ) pMCU[i0+i]->tBatch += tTile / n;
+#endif
+	}
+
+	for ( i = 0; i < N; ++i ) {
+		mcu_instance * pInst = pMCU[i];
+#ifdef _SUP
+		int iSuperState = pInst->SUPD->STATE_INTINDEX;
+#else
+		int iSuperState = STATE_OFF;
+#endif
+		mcu_batch_enter( pInst, iStatus, bFlush );
+		DotxProfBegin( PROF_OPERATION );
+		k  = operation ( pInputs + i*MCU_NR_INPUTS, pOutputs + i*MCU_NR_OUTPUTS, pDebug + i*iDebugSize, 
+			pLogdata + i*MAXLOG, iStatus, cMessage + i*iMessageSize, pInst->MCUS, pInst->MCUD, &pInst->REC, iSuperState );
+		DotxProfEnd( PROF_OPERATION );
+		mcu_batch_leave( pInst );
+		if ( iErrors != NULL ) iErrors[i] += k;
+		iError += k;
+	}
+
+#ifdef _SUP
+	for ( i = 0; i < N; ++i ) {
+		mcu_instance * pInst = pMCU[i];
+		mcu_batch_enter( pInst, iStatus, bFlush );
+		DotxProfBegin( PROF_POSTPROCEDURE );
+		k  = postprocedure ( pInputs + i*MCU_NR_INPUTS, pOutputs + i*MCU_NR_OUTPUTS, pLogdata + i*MAXLOG, 
+			iStatus, pInst->SUPS, pInst->SUPD );
+		DotxProfEnd( PROF_POSTPROCEDURE );
+		mcu_batch_leave( pInst );
+		if ( iErrors != NULL ) iErrors[i] += k;
+		iError += k;
+	}
+#endif
+
+#ifdef _SIM
+	for ( i = 0; i < N; ++i ) {
+		mcu_instance * pInst = pMCU[i];
+		mcu_batch_enter( pInst, iStatus, bFlush );
+		DotxProfBegin( PROF_SIMULATION );
+		k  = simulation ( pInputs + i*MCU_NR_INPUTS, pOutputs + i*MCU_NR_OUTPUTS, pLogdata + i*MAXLOG, iStatus, 
+			pInst->MCUS, pInst->MCUD, pInst->SUPS, pInst->SUPD, pInst->SIMS, pInst->SIMD, pInst->EVMS, pInst->EVMD );
+		DotxProfEnd( PROF_SIMULATION );
+		mcu_batch_leave( pInst );
+		if ( iErrors != NULL ) iErrors[i] += k;
+		iError += k;
+	}
+#endif
+
+	for ( i = 0; i < N; ++i ) {
+		if ( pMCU[i]->pShadow == NULL ) continue;
+		mcu_batch_enter( pMCU[i], iStatus, bFlush );
+		tShadow += mcu_shadow_step( pMCU[i], pInputs + i*MCU_NR_INPUTS, iStatus, iDevice, pLogdata + i*MAXLOG, cRunname );
+		mcu_batch_leave( pMCU[i] );
+	}
+
+	for ( i = 0; i < N; ++i ) {
+		mcu_instance * pInst = pMCU[i];
+		mcu_batch_enter( pInst, iStatus, bFlush );
+		DotxProfBegin( PROF_LOGDATA );
+		k  = MCU_OK;
+		if ( RATE_DUE( pInst->MCUS->Log_Decimation, pInst->MCUD->iSample, iStatus ) && 
+				!mcu_shed( pInst->MCUD, MCU_SHED_LOGDATA, iStatus ) ) {
+			DotxAllocModule( "logdata" );
+			k  = logdata ( pLogdata + i*MAXLOG, iStatus, iDevice, cMessage + i*iMessageSize, pInst->cSimID, 
+				pInst->MCUS->LogDir, pInst->MCUS->Log_ON, &pInst->vpLog );
+			DotxAllocModule( NULL );
+		}
+		DotxProfEnd( PROF_LOGDATA );
+		mcu_batch_leave( pInst );
+		if ( iErrors != NULL ) iErrors[i] += k;
+		iError += k;
+	}
+
+#ifdef DOTXPROFILER
+	/* The complete sample of each instance, as in mcu_instance_step() */
+	for ( i = 0; i < N; ++i ) {
+		DotxProfSelect( &pMCU[i]->PROF, !mcu_shed( pMCU[i]->MCUD, MCU_SHED_STATISTICS, iStatus ) );
+		DotxProfRecord( PROF_TOTAL, pMCU[i]->tBatch );
+	}
+	DotxProfSelect( NULL, FALSE );
+#endif
+
+#ifdef DOTXALLOCAUDIT
+	/* The control loop should never touch the heap */
+	for ( i = 0; i < N; ++i ) {
+		if ( pMCU[i]->nBatchHeap != 0L ) {
+			int iLine;
+			const char * cFile = alloc_site( &iLine );
+			sprintf( cMessage + i*iMessageSize + strlen( cMessage + i*iMessageSize ), 
+						"[mcu]  <err> %ld heap operation(s) during run, last at %s:%d\t\n", pMCU[i]->nBatchHeap, cFile, iLine );
+			if ( iErrors != NULL ) iErrors[i] += MCU_ERR;
+			iError += MCU_ERR;
+		}
+	}
+#endif
+
+	/* In a batch the budget applies to the average time per instance */
+	REAL dElapsed = R_(1e-9) * (REAL)( prof_clock( ) - tStart - tShadow ) / N;
+
+	for ( i = 0; i < N; ++i ) {
+		mcu_instance * pInst = pMCU[i];
+
+		/* Defer low-criticality tasks in the next samples if this sample was too slow */
+		if ( pInst->MCUS->Shed_Budget > R_(0.0) ) mcu_shed_update( pInst->MCUS, pInst->MCUD, dElapsed );
+
+		/* Next sample of the multi-rate tasks */
+		pInst->MCUD->iSample++;
+	}
+
+	/* Restore the floating-point mode of the host */
+	if ( bFlush ) plat_fpu_restore( iFpuMode );
+
+	return iError;
+
+}
+
+/* ---------------------------------------------------------------------------------
+ Run the MCU to generate output based on the given measurement input
+--------------------------------------------------------------------------------- */
+int mcu_run( 
+
+		const REAL   * pInputs        , /* [in]     Measurement input */
+			  REAL   * pOutputs       , /* [out]    Controller output */
+			  REAL   * pDebug         , /* [in/out] Debug array */
+			  REAL   * pLogdata       , /* [in/out] Logdata array */
+		const int      iStatus        , /* [in]     Simulation status, see defines */
+		const int      iDevice        , /* [in]     System which is running the simulation */
+			  char   * cMessage       , /* [in/out] System message */
+			  char   * cRunname         /* [in/out] Optional runname definition (bladed only) */
+
+) {
+
+	int iError = MCU_OK;
+
+	if ( iStatus == MCU_STATUS_INIT && pRunMCU == NULL ) pRunMCU = mcu_instance_create( );
+	if ( pRunMCU == NULL ) return MCU_ERR;
+
+	iError += mcu_instance_step( pRunMCU, pInputs, pOutputs, pDebug, pLogdata, iStatus, iDevice, cMessage, cRunname );
+
+	/* Update the global pointers used by the PLC interface */
+	g_MCUS = pRunMCU->MCUS;
+	g_MCUD = pRunMCU->MCUD;
+
+	if ( iStatus == MCU_STATUS_EXIT ) {
+
+		iError += mcu_instance_destroy( pRunMCU );
+		pRunMCU = NULL;
+
+	}
+
+	return iError;
+
+}
+
 /* ---------------------------------------------------------------------------------
  end maincontrollerunit.c
 --------------------------------------------------------------------------------- */
@@ -36,15 +36,274 @@
 */
 #endif
 
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPEDEFS
+
+//! Opaque handle of one controller instance, see mcuinstance.h for its contents.
+typedef struct mcu_instance mcu_instance;
+
+#endif
+
 /* ------------------------------------------------------------------------------ */
 #ifndef DXG_SKIP_FUNCTIONS
 
+//! Allocate an empty controller instance.
+/*!
+    The data structs of the modules are allocated (and the parameter files are 
+    read) by the first call to mcu_instance_step() with #MCU_STATUS_INIT. 
+    Instances do not share any data, so several of them can be used side by 
+    side within one process.
+    
+    \return     A pointer to the new instance, NULL if no memory could be allocated.
+*/
+mcu_instance * mcu_instance_create( void );
+
+//! Run one sample of a controller instance.
+/*!
+    Identical to mcu_run(), but operating on the data of the given instance. 
+    At #MCU_STATUS_INIT the data structs are allocated and the configuration 
+    is read, at #MCU_STATUS_EXIT they are released again. The instance itself 
+    remains valid until mcu_instance_destroy() is called.
+
+    The parameter files of the modules do not depend on each other; with the 
+    compile switch DOTXPARALLELINIT they are read in parallel and their echo 
+    files are written in the background. The message of #MCU_STATUS_INIT
+    reports the time spent in each stage of the initialization, with a warning
+    if the total exceeds the budget in the parameter file (Init_Budget).
+    
+    \param pMCU         [in+out]    The controller instance.
+    \param pInputs      [in]        An array with all required inputs into the controller.
+    \param pOutputs     [out]       An array with all outputs of the controller.
+    \param pDebug       [in+out]    Pointer to an array used for debugging.
+    \param pLogdata     [in+out]    Log array used to send data to the log module and the GUI interface.
+    \param iStatus      [in]        Simulation status (#MCU_STATUS_INIT, #MCU_STATUS_RUN and #MCU_STATUS_EXIT). 
+    \param iDevice      [in]        System which is running the simulation.
+    \param cMessage     [in+out]    Output a message to the external program.
+    \param cRunname     [in+out]    The name of the current simulation
+    
+    \return     A non zero int will be returned in the case an error occurred.    
+*/
+int mcu_instance_step(     
+        
+              mcu_instance * pMCU           , 
+        const REAL         * pInputs        , 
+              REAL         * pOutputs       , 
+              REAL         * pDebug         , 
+              REAL         * pLogdata       , 
+        const int            iStatus        , 
+        const int            iDevice        , 
+              char         * cMessage       ,  
+              char         * cRunname       
+        
+) ;
+
+//! Release a controller instance.
+/*!
+    Data structs which are still allocated (i.e. when no #MCU_STATUS_EXIT call 
+    was made) are released as well.
+    
+    \param pMCU     [in]    The controller instance, may be NULL.
+    \return     A non zero int will be returned in the case an error occurred.    
+*/
+int mcu_instance_destroy( mcu_instance * pMCU );
+
+#ifdef DOTXPROFILER
+struct prof_summary;
+
+//! Cycle times of one stage of a controller instance, see profiler.h.
+/*!
+    The statistics cover all run samples since the last initialization, see
+    \ref profiler. The same statistics are written to the log directory at
+    #MCU_STATUS_EXIT.
+    
+    \param pMCU         [in]    The controller instance.
+    \param iStage       [in]    The stage, see #prof_stage.
+    \param pSummary     [out]   Number of samples, minimum, median, 99th and 99.9th percentile, maximum and mean [us].
+    \return     A non zero int will be returned in the case an error occurred.    
+*/
+int mcu_instance_profile( const mcu_instance * pMCU, const int iStage, struct prof_summary * pSummary );
+#endif
+
+//! Load shedding counters of a controller instance.
+/*!
+    When the parameter file defines a time budget (Shed_Budget), every run sample 
+    which exceeds it defers one more task of #MCU_SHEDTASKS in the next samples.
+    The counters cover all run samples since the last initialization and are 
+    reported in the message at #MCU_STATUS_EXIT.
+
+    \param pMCU         [in]    The controller instance.
+    \param pOverruns    [out]   Number of run samples which exceeded the budget.
+    \param pDeferred    [out]   Number of samples in which each task was deferred [#MCU_NR_SHEDTASKS], may be NULL.
+    \return     A non zero int will be returned in the case the instance is not initialized.
+*/
+int mcu_instance_shed( const mcu_instance * pMCU, long * pOverruns, long * pDeferred );
+
+//! Numerical health counters of a controller instance.
+/*!
+    Number of filter and PID states which were reset after a non-finite value
+    or snapped to zero because they were subnormal, see \ref health. The
+    counters cover all samples since the last initialization and are reported
+    in the message at #MCU_STATUS_EXIT if any of them is non zero.
+
+    \param pMCU         [in]    The controller instance.
+    \param pCount       [out]   Number of events [#HEALTH_NR_EVENTS], see #health_event.
+    \return     A non zero int will be returned in the case the instance is not initialized.
+*/
+int mcu_instance_health( const mcu_instance * pMCU, long * pCount );
+
+//! Check if a task of the instance run by mcu_run() is deferred in the current sample, see #MCU_SHEDTASKS.
+int mcu_run_shedding( const int iTask );
+
+//! Save the run-time state of a controller instance in a checkpoint, see \ref checkpoint.
+/*!
+    The checkpoint holds the dynamic data of all modules: filter states, PID 
+    internals, set points, the supervisory state and the sample counter. The 
+    parameters are not included, a checkpoint is restored into an instance 
+    which has been initialized with the same parameter files. 
+    
+    The save does not allocate memory, it can be called between two run 
+    samples. Call it with a NULL buffer first to obtain the required size.
+    The state of a shadow controller, see mcu_instance_shadow(), is not 
+    included.
+
+    \param pMCU     [in]        The controller instance, after its initialization.
+    \param vpBuffer [out]       Buffer for the checkpoint, NULL to query the size.
+    \param pnSize   [in+out]    Size of the buffer on input, size of the checkpoint on output [bytes].
+    \return     A non zero int will be returned in the case the instance is not initialized or the buffer is too small.
+*/
+int mcu_instance_save( const mcu_instance * pMCU, void * vpBuffer, size_t * pnSize );
+
+//! Restore the run-time state of a controller instance from a checkpoint.
+/*!
+    The next run sample continues bit-exactly where the saved instance was 
+    stopped. The checkpoint is rejected when it is damaged or was made by a 
+    build with other dimensions, modules, precision or byte order; the whole 
+    checkpoint is checked before anything is copied, so a rejected checkpoint 
+    leaves the instance untouched. 
+
+    \param pMCU     [in+out]    The controller instance, after its initialization.
+    \param vpBuffer [in]        The checkpoint written by mcu_instance_save().
+    \param nSize    [in]        Size of the checkpoint [bytes].
+    \return     A non zero int will be returned in the case the checkpoint was rejected.
+*/
+int mcu_instance_restore( mcu_instance * pMCU, const void * vpBuffer, const size_t nSize );
+
+//! Create an independent copy of an initialized controller instance.
+/*!
+    The clone holds a copy of all parameters and of the complete run-time 
+    state of the source, see mcu_instance_save(), without using the file 
+    system. Both instances continue independently: stepping the clone with 
+    the same inputs gives the same outputs as the source. One baseline 
+    simulation can thus be branched into many scenarios at the same instant 
+    without rerunning the common part.
+
+    The clone gets its own log file: the tag is appended to the simulation 
+    ID, it should differ between the clones when logging is enabled. The 
+    cycle time statistics of the clone start empty. The clone does not get 
+    the shadow controller of the source. The clone is released by 
+    mcu_instance_destroy(), or by a step with #MCU_STATUS_EXIT.
+
+    \param pSource  [in]    The controller instance, after its initialization.
+    \param cTag     [in]    Suffix of the simulation ID of the clone, may be NULL.
+    \return     The new instance, NULL in the case the source is not initialized, the tag does not fit 
+                in #MCU_SIMTAG_SIZE or the memory could not be allocated.
+*/
+mcu_instance * mcu_instance_clone( const mcu_instance * pSource, const char * cTag );
+
+//! Save the state of the instance run by mcu_run(), see mcu_instance_save().
+int mcu_run_save( void * vpBuffer, size_t * pnSize );
+
+//! Restore the state of the instance run by mcu_run(), see mcu_instance_restore().
+int mcu_run_restore( const void * vpBuffer, const size_t nSize );
+
+//! Outputs and cost of the shadow controller of an instance.
+/*!
+    A shadow controller is a candidate parameter set which runs in lockstep 
+    with the controller, on the same inputs, without ever driving the 
+    actuators. It is configured by the optional tenth line of controller.ini: 
+    the configuration file of the shadow, or "none". The shadow is 
+    initialized after the instance, stepped after its modules in every run 
+    sample, and exited with it; a shadow which fails to initialize is 
+    dropped with a warning and the instance runs on its own.
+
+    The shadow writes its own log file, with the suffix "_SHADOW". The log of 
+    the instance holds the demanded pitch and torque of the shadow and its 
+    execution time (SHADOW_COST [s]). When both use the same rotor speed 
+    filters, the shadow takes the filtered rotor speed of the instance 
+    instead of filtering it again, see base_controller_share(). The time of 
+    the shadow does not count for the load shedding of the instance; errors 
+    of the shadow are not returned by the instance. The cost is reported in 
+    the message at the exit.
+
+    \param pMCU     [in]    The controller instance.
+    \param pOutputs [out]   Outputs of the shadow in the last sample [MCU_NR_OUTPUTS], may be NULL.
+    \param pCost    [out]   Execution time of the shadow in the last sample, its mean and its maximum [s], may be NULL.
+    \return     A non zero int will be returned in the case the instance has no shadow.
+*/
+int mcu_instance_shadow( const mcu_instance * pMCU, REAL * pOutputs, REAL * pCost );
+
+//! Outputs and cost of the shadow controller of the instance run by mcu_run(), see mcu_instance_shadow().
+int mcu_run_shadow( REAL * pOutputs, REAL * pCost );
+
+//! Run one sample of a batch of N controller instances.
+/*!
+    All inputs and outputs are contiguous blocks with one row per instance, 
+    i.e. the inputs of instance i start at pInputs[ i*MCU_NR_INPUTS ]. 
+    
+    Initialization and exit are executed instance by instance through 
+    mcu_instance_step(). During a run, each module (supervisory, operation, 
+    post procedure, simulation and logging) is executed for all instances 
+    before the next module is called, which keeps the code and tables of 
+    the module in cache for the complete batch. Before the operation module,
+    the rotor speed filters of the base controller are run turbine-major for
+    tiles of #FILTER_BANK_WIDTH instances, see base_controller_batch(). The 
+    per-instance results are identical to calling mcu_instance_step() for 
+    each instance, including the cycle times of the profiler and the heap 
+    audit, which are charged to the instance they belong to.
+    
+    At initialization a suffix "_Tnnn" is appended to the simulation ID of 
+    instance nnn, so the instances do not write to the same log files.
+    
+    \param pMCU         [in+out]    Array of N controller instances, see mcu_instance_create().
+    \param N            [in]        Number of instances.
+    \param pInputs      [in]        Inputs of all instances [N][MCU_NR_INPUTS].
+    \param pOutputs     [out]       Outputs of all instances [N][MCU_NR_OUTPUTS].
+    \param pDebug       [in+out]    Debug arrays of all instances [N][iDebugSize].
+    \param iDebugSize   [in]        Size of the debug array of a single instance.
+    \param pLogdata     [in+out]    Log arrays of all instances [N][MAXLOG].
+    \param iErrors      [out]       Error code of each instance [N], may be NULL.
+    \param iStatus      [in]        Simulation status (#MCU_STATUS_INIT, #MCU_STATUS_RUN and #MCU_STATUS_EXIT). 
+    \param iDevice      [in]        System which is running the simulation.
+    \param cMessage     [in+out]    Messages of all instances [N][iMessageSize].
+    \param iMessageSize [in]        Size of the message of a single instance.
+    \param cRunname     [in+out]    The name of the current simulation, shared by all instances.
+    
+    \return     The sum of the error codes of all instances.
+*/
+int mcu_run_batch(     
+        
+              mcu_instance ** pMCU          , 
+        const int             N             , 
+        const REAL          * pInputs       , 
+              REAL          * pOutputs      , 
+              REAL          * pDebug        , 
+        const int             iDebugSize    , 
+              REAL          * pLogdata      , 
+              int           * iErrors       , 
+        const int             iStatus       , 
+        const int             iDevice       , 
+              char          * cMessage      ,  
+        const int             iMessageSize  , 
+              char          * cRunname       
+        
+) ;
+
 //! Run the MCU to generate output u based on the given measurements.
 /*!
     
-    The function mcu_run initializes the static and dynamic data structs as 
-    static variables. It passes these on to the individual modules. When given the status to
-    exit it cleans up the memory. 
+    The function mcu_run is a single instance shim around mcu_instance_step(), 
+    it keeps one static mcu_instance which is created at initialization and 
+    destroyed when given the status to exit. 
     
     Besides the base controller it could execute more advanced controllers.
     
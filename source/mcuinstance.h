@@ -0,0 +1,135 @@
+/* ---------------------------------------------------------------------------------
+ *          file : mcuinstance.h                                                  *
+ *   description : C-header file, contains the data of one MCU instance           *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _MCUINSTANCE_H_
+#define _MCUINSTANCE_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup moduleMCU
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file mcuinstance.h
+    \brief This header file defines the contents of the opaque mcu_instance handle.
+
+    Only the MCU itself (and modules which operate on complete instances) should
+    include this file, external programs use the handle through the functions
+    declared in maincontrollerunit.h. The header should be included after the
+    data headers of all modules.
+*/
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+#define MCU_CACHELINE           64      //!< Size of a cache line [bytes], instances are aligned to it to avoid false sharing between threads.
+#define MCU_SHADOW_DEBUGSIZE    200             //!< Size of the debug array of a shadow controller.
+#define MCU_SHADOW_MSGSIZE      (10*BUFSIZE)    //!< Size of the message of a shadow controller.
+#define MCU_SIMTAG_SIZE         32              //!< Size of the simulation tag, holds the tag of a batch instance or clone followed by the suffix of its shadow.
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_STRUCTS
+
+/*! \struct mcu_shadow
+    \brief  A shadow controller: a second instance with its own parameter files, 
+            stepped on the inputs of its lead instance. Its outputs are kept here 
+            and never returned to the caller.
+ */
+typedef struct mcu_shadow {
+
+    mcu_instance        * pMCU                          ;   //!<    The shadow instance.
+    REAL                  pOutputs[ MCU_NR_OUTPUTS ]    ;   //!<    Outputs of the shadow in the last sample.
+    REAL                  pDebug[ MCU_SHADOW_DEBUGSIZE ];   //!<    Debug array of the shadow.
+    REAL                  pLogdata[ MAXLOG ]            ;   //!<    Log array of the shadow, written to its own log file.
+    char                  cMessage[ MCU_SHADOW_MSGSIZE ];   //!<    Message of the shadow.
+    int                   iShared                       ;   //!<    Flag indicating that the shadow reuses the filtered rotor speed of the lead.
+    int                   iErrors                       ;   //!<    Sum of the error codes of the shadow during the run.
+    long                  nSteps                        ;   //!<    Number of run samples of the shadow.
+    unsigned long long    tLast                         ;   //!<    Execution time of the shadow in the last sample [ns].
+    unsigned long long    tMax                          ;   //!<    Largest execution time of the shadow [ns].
+    unsigned long long    tSum                          ;   //!<    Total execution time of the shadow [ns].
+
+} mcu_shadow;
+
+/*! \struct mcu_instance
+    \brief  All data of one controller. Nothing is shared between instances, so
+            a single process can run an arbitrary number of turbine controllers.
+
+    The data structs of the modules and the objects of mcu_data_dynamic are 
+    carved from one \ref arena per instance. It is allocated at the 
+    initialization for the objects of all blocks, moved to an arena of the
+    scheduled blocks once the schedule is known, and released with a single
+    call at the exit. Only the start-up ramp, of which the length is known
+    at run time, and the log file are allocated on their own.
+ */
+struct mcu_instance {
+
+    //! \name Data structs of the modules
+    //@{
+    mcu_data_static     * MCUS                          ;   //!<    Static data of the base controller.
+    mcu_data_dynamic    * MCUD                          ;   //!<    Dynamic data of the base controller.
+#ifdef _SUP
+    sup_data_static     * SUPS                          ;   //!<    Static data of the supervisory controller.
+    sup_data_dynamic    * SUPD                          ;   //!<    Dynamic data of the supervisory controller.
+#endif
+#ifdef _SIM
+    sim_data_static     * SIMS                          ;   //!<    Static data of the simulation module.
+    sim_data_dynamic    * SIMD                          ;   //!<    Dynamic data of the simulation module.
+    evm_data_static     * EVMS                          ;   //!<    Static data of the events module.
+    evm_data_dynamic    * EVMD                          ;   //!<    Dynamic data of the events module.
+#endif
+    //@}
+
+    //! \name Data passed on from sample to sample
+    //@{
+    base_contr_recipe     REC                           ;   //!<    Set points and constraints of the operation module.
+    char                  cSimID[ 200 ]                 ;   //!<    Unique simulation ID, set during initialization.
+    char                  cSimTag[ MCU_SIMTAG_SIZE ]    ;   //!<    Optional suffix of the simulation ID, distinguishes the instances of a batch.
+    void                * vpLog                         ;   //!<    Handle of the log file of this instance.
+    //@}
+
+    //! \name Shadow controller
+    //@{
+    mcu_shadow          * pShadow                       ;   //!<    Shadow controller stepped after this instance, NULL without a shadow.
+    int                   bShadow                       ;   //!<    Flag indicating that this instance is itself a shadow, it never starts another one.
+    //@}
+
+    //! \name Memory management
+    //@{
+    void                * vpBase                        ;   //!<    Pointer returned by calloc, the instance itself starts at the next cache line.
+    mem_arena             MEM                           ;   //!<    Arena of the data structs of the modules, released as a whole, see mcu_instance_alloc().
+    //@}
+
+#if defined(DOTXPROFILER) || defined(DOTXALLOCAUDIT)
+    //! \name Instrumentation
+    //@{
+#ifdef DOTXPROFILER
+    prof_data             PROF                          ;   //!<    Cycle times of the stages of this instance.
+    unsigned long long    tBatch                        ;   //!<    Time spent on this instance in the current sample of mcu_run_batch() [ns].
+#endif
+#ifdef DOTXALLOCAUDIT
+    long                  nBatchHeap                    ;   //!<    Heap operations of this instance in the current sample of mcu_run_batch().
+#endif
+    //@}
+#endif
+
+};
+
+#endif
+
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _MCUINSTANCE_H_
+--------------------------------------------------------------------------------- */
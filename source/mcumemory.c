@@ -0,0 +1,103 @@
+/* ---------------------------------------------------------------------------------
+ *          file : mcumemory.c                                                    *
+ *   description : C-source file, static memory pools of the controller           *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+
+#include "./signals/signal_definitions_internal.h"
+#include "./signals/signal_definitions_custom.h"
+#include "./signals/signal_definitions_external.h"
+
+#include "./suplib/suplib.h"
+
+#include "./turbine/mcudata.h"
+
+#ifdef _SUP
+#include "./supervisor/supdata.h"
+#endif
+
+#ifdef _SIM
+#include "./simulation/evmdata.h"
+#include "./simulation/simdata.h"
+#endif
+
+#include "./basecontrol/basecontroller.h"
+#include "./operation/operation.h"
+#include "./logdata/logdata.h"
+
+#include "./maincontrollerunit.h"
+#include "./mcuinstance.h"
+
+#ifdef DOTXSTATICMEM
+
+/* Number of controller instances: the controller, and its shadow or a clone */
+#ifndef MEM_INSTANCES
+#define MEM_INSTANCES       2
+#endif
+
+/* Number of shadow controllers */
+#ifndef MEM_SHADOWS
+#define MEM_SHADOWS         1
+#endif
+
+/* Arena of an instance with the objects of all blocks: the data structs of the modules,
+   each on its own cache lines, and the block of mcu_data_dynamic last */
+#ifdef _SUP
+#define MEM_ARENA_SUP       ( MEM_SLOT( sizeof(sup_data_static) ) + MEM_SLOT( sizeof(sup_data_dynamic) ) )
+#else
+#define MEM_ARENA_SUP       0
+#endif
+#ifdef _SIM
+#define MEM_ARENA_SIM       ( MEM_SLOT( sizeof(sim_data_static) ) + MEM_SLOT( sizeof(sim_data_dynamic) ) + \
+                              MEM_SLOT( sizeof(evm_data_static) ) + MEM_SLOT( sizeof(evm_data_dynamic) ) )
+#else
+#define MEM_ARENA_SIM       0
+#endif
+#define MEM_ARENA_SIZE      ( MEM_SLOT( sizeof(mcu_data_static) ) + MEM_ARENA_SUP + MEM_ARENA_SIM + MCUD_BLOCK_SIZE )
+
+/* Largest checkpoint, for mcu_instance_clone(): the image of the dynamic structs and
+   the words which describe the layout. The start-up ramp is empty, the third order
+   ramp of thirdord() is not part of the build. */
+#ifdef _SUP
+#define MEM_CKPT_SUP        sizeof(sup_data_dynamic)
+#else
+#define MEM_CKPT_SUP        0
+#endif
+#ifdef _SIM
+#define MEM_CKPT_SIM        ( sizeof(sim_data_dynamic) + sizeof(evm_data_dynamic) )
+#else
+#define MEM_CKPT_SIM        0
+#endif
+#define MEM_CKPT_SIZE       ( MCUD_BLOCK_SIZE + sizeof(base_contr_recipe) + MEM_CKPT_SUP + MEM_CKPT_SIM + 16 * sizeof(int) )
+
+/* ---------------------------------------------------------------------------------
+ Memory of the pools, the initialization of an instance holds the arena of all blocks
+ and the arena of the scheduled blocks at the same time
+--------------------------------------------------------------------------------- */
+MEM_STORAGE( Instance   , sizeof(mcu_instance) + 2*MCU_CACHELINE    , MEM_INSTANCES );
+MEM_STORAGE( Shadow     , sizeof(mcu_shadow)                        , MEM_SHADOWS   );
+MEM_STORAGE( Arena      , MEM_ARENA_SIZE                            , MEM_INSTANCES + 1 );
+MEM_STORAGE( Log        , sizeof(log_stream)                        , MEM_INSTANCES );
+MEM_STORAGE( Checkpoint , MEM_CKPT_SIZE                             , 1             );
+
+/* ---------------------------------------------------------------------------------
+ The pools, an allocation takes a slot of the smallest pool in which it fits
+--------------------------------------------------------------------------------- */
+mem_pool mem_pools[] = {
+
+    MEM_POOL( Instance   , "mcu_instance"       ),
+    MEM_POOL( Shadow     , "mcu_shadow"         ),
+    MEM_POOL( Arena      , "instance_arena"     ),
+    MEM_POOL( Log        , "log_stream"         ),
+    MEM_POOL( Checkpoint , "checkpoint"         )
+};
+
+const int mem_npools = (int)( sizeof(mem_pools) / sizeof(mem_pools[0]) );
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ end mcumemory.c
+--------------------------------------------------------------------------------- */
@@ -6,7 +6,9 @@
 --------------------------------------------------------------------------------- */
 
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 #include "./../signals/signal_definitions_internal.h"
 #include "./../signals/signal_definitions_custom.h"
@@ -42,16 +44,13 @@ int operation (
               char             * cMessage       ,
         const mcu_data_static  * MCUS           ,
               mcu_data_dynamic * MCUD           ,
+              base_contr_recipe* REC            ,
         const int                STATE_INTINDEX    
         
     ) 
 {
     /* Local variables */
     int i, iError = MCU_OK;
-    
-
-    /* Setpoints and constraints */
-    static base_contr_recipe REC;
 
     /* -------------------------------------------------------------------------- */
     /* CALL THE DNPC MODULE */
@@ -91,7 +90,8 @@ int operation (
     	dnpc( &iStatus, &iModeDNPC, pInputsDNPC, &iErrorDNPC, pOutputsDNPC, cMessageDNPC, pLogdata, pDebug, pDebug+2000 );
 
     	iError += iErrorDNPC ;
-        strcat( cMessage, cMessageDNPC );
+        /* Only the message of a sample without error is shed, an error keeps its diagnostic */
+        if ( iErrorDNPC != MCU_OK || !mcu_shed( MCUD, MCU_SHED_DNPCMSG, iStatus ) ) strcat( cMessage, cMessageDNPC );
     }
 
 #endif
@@ -105,24 +105,24 @@ int operation (
         case STATE_OFF          :
         case STATE_POWERPROD    :
         
-            iError += power_production ( pInputs, pDebug, pLogdata, iStatus, MCUS, MCUD, &REC );
+            iError += power_production ( pInputs, pDebug, pLogdata, iStatus, MCUS, MCUD, REC );
             break;
         
         /* Operation through external NMPC DLL */
 #if defined(_DNPC_INTERNAL) || defined(_DNPC_EXTERNAL)
         case STATE_POWERPROD_DNPC           :   
-            iError += power_production_dnpc ( pOutputsDNPC, pDebug, pLogdata, iStatus, MCUS, MCUD, &REC );
+            iError += power_production_dnpc ( pOutputsDNPC, pDebug, pLogdata, iStatus, MCUS, MCUD, REC );
             break;
         case STATE_SHUTDOWN_DNPC            :
         case STATE_SHUTDOWN_DNPC_GRIDLOSS   :
         
-            iError += power_production_dnpc ( pOutputsDNPC, pDebug, pLogdata, iStatus, MCUS, MCUD, &REC );            
+            iError += power_production_dnpc ( pOutputsDNPC, pDebug, pLogdata, iStatus, MCUS, MCUD, REC );            
             break;
 #endif
         
         case STATE_SHUTDOWN     :
 
-            iError += fastshutdown ( pInputs, pOutputs, pLogdata, iStatus, MCUS, MCUD, &REC );    
+            iError += fastshutdown ( pInputs, pOutputs, pLogdata, iStatus, MCUS, MCUD, REC );    
             break;
             
         /* Error, unkown state */
@@ -146,42 +146,46 @@ int operation (
         cMessage      ,
         MCUS          ,
         MCUD          ,
-       &REC
+        REC
         
     );
 
     
     /* -------------------------------------------------------------------------- */
-    /* STORE DATA */
+    /* STORE DATA, only when the log array is read. The channels are listed in LOGB_OPER_LOG of mcuschedule.c */
     
-    pLogdata [ OPER_MEAS_GENSPEED   ] = pInputs [ I_MCU_IN_MEAS_GENSPEED       ] ;
-    pLogdata [ OPER_MEAS_AZIMUTH    ] = pInputs [ I_MCU_IN_MEAS_ROTORAZIANGLE  ] ;
-    pLogdata [ OPER_MEAS_FAACC      ] = pInputs [ I_MCU_IN_MEAS_TOWFAACC       ] ;
-    pLogdata [ OPER_MEAS_SWACC      ] = pInputs [ I_MCU_IN_MEAS_TOWSIDEACC     ] ;
-    pLogdata [ OPER_MEAS_GENTORQUE  ] = pInputs [ I_MCU_IN_MEAS_GENTORQUE      ] ;
-    pLogdata [ OPER_MEAS_TIME       ] = pInputs [ I_MCU_IN_CURRENTTIME         ] ;
-    pLogdata [ OPER_MEAS_ELECPOWER  ] = pInputs [ I_MCU_IN_MEAS_ELECPOWEROUT   ] ;
-    pLogdata [ OPER_MEAS_YAWERROR   ] = pInputs [ I_MCU_IN_MEAS_YAWERROR       ] ;
-    pLogdata [ OPER_MEAS_TIMESTEP   ] = pInputs [ I_MCU_IN_TIMESTEP            ] ;
-    pLogdata [ OPER_MEAS_GRIDCONT   ] = pInputs [ I_MCU_IN_DEM_GRIDCONTACTOR   ] ;
-    pLogdata [ OPER_MEAS_ACTTYPE    ] = pInputs [ I_MCU_IN_ACTUATORTYPE        ] ;
-    pLogdata [ OPER_MEAS_BENOUT1    ] = pInputs [ I_MCU_IN_MEAS_ROOTOUTBENDM1  ] ;
-    pLogdata [ OPER_MEAS_BENOUT2    ] = pInputs [ I_MCU_IN_MEAS_ROOTOUTBENDM2  ] ;
-    pLogdata [ OPER_MEAS_BENIN1     ] = pInputs [ I_MCU_IN_MEAS_ROOTINBENDM1  ] ;
-    pLogdata [ OPER_MEAS_BENIN2     ] = pInputs [ I_MCU_IN_MEAS_ROOTINBENDM2  ] ;
-    pLogdata [ OPER_MEAS_PITCH1     ] = pInputs [ I_MCU_IN_MEAS_PITCHANGLE1    ] ;
-    pLogdata [ OPER_MEAS_PITCH2     ] = pInputs [ I_MCU_IN_MEAS_PITCHANGLE2    ] ;
-    pLogdata [ OPER_MEAS_HUBWIND    ] = pInputs [ I_MCU_IN_WINDSPEED           ] ;
-    pLogdata [ OPER_DEM_GENTORQUE   ] = pOutputs [ I_MCU_OUT_DEM_GENTORQUE     ] ;
-    pLogdata [ OPER_DEM_YAWRATE     ] = pOutputs [ I_MCU_OUT_DEM_YAWRATE       ] ;    
-    pLogdata [ OPER_DEM_PITCH1      ] = pOutputs [ I_MCU_OUT_DEM_PITCHANGLE1   ] ;
-    pLogdata [ OPER_DEM_PITCH2      ] = pOutputs [ I_MCU_OUT_DEM_PITCHANGLE2   ] ;
+    if ( mcu_block( MCUD, MCU_BLOCK_OPER_LOG, iStatus ) ) {
+        LOG_STORE( pLogdata, OPER_MEAS_GENSPEED   , pInputs [ I_MCU_IN_MEAS_GENSPEED       ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_AZIMUTH    , pInputs [ I_MCU_IN_MEAS_ROTORAZIANGLE  ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_FAACC      , pInputs [ I_MCU_IN_MEAS_TOWFAACC       ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_SWACC      , pInputs [ I_MCU_IN_MEAS_TOWSIDEACC     ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_GENTORQUE  , pInputs [ I_MCU_IN_MEAS_GENTORQUE      ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_TIME       , pInputs [ I_MCU_IN_CURRENTTIME         ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_ELECPOWER  , pInputs [ I_MCU_IN_MEAS_ELECPOWEROUT   ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_YAWERROR   , pInputs [ I_MCU_IN_MEAS_YAWERROR       ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_TIMESTEP   , pInputs [ I_MCU_IN_TIMESTEP            ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_GRIDCONT   , pInputs [ I_MCU_IN_DEM_GRIDCONTACTOR   ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_ACTTYPE    , pInputs [ I_MCU_IN_ACTUATORTYPE        ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_BENOUT1    , pInputs [ I_MCU_IN_MEAS_ROOTOUTBENDM1  ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_BENOUT2    , pInputs [ I_MCU_IN_MEAS_ROOTOUTBENDM2  ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_BENIN1     , pInputs [ I_MCU_IN_MEAS_ROOTINBENDM1  ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_BENIN2     , pInputs [ I_MCU_IN_MEAS_ROOTINBENDM2  ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_PITCH1     , pInputs [ I_MCU_IN_MEAS_PITCHANGLE1    ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_PITCH2     , pInputs [ I_MCU_IN_MEAS_PITCHANGLE2    ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_HUBWIND    , pInputs [ I_MCU_IN_WINDSPEED           ]  );
+        LOG_STORE( pLogdata, OPER_DEM_GENTORQUE   , pOutputs [ I_MCU_OUT_DEM_GENTORQUE     ]  );
+        LOG_STORE( pLogdata, OPER_DEM_YAWRATE     , pOutputs [ I_MCU_OUT_DEM_YAWRATE       ]  );
+        LOG_STORE( pLogdata, OPER_DEM_PITCH1      , pOutputs [ I_MCU_OUT_DEM_PITCHANGLE1   ]  );
+        LOG_STORE( pLogdata, OPER_DEM_PITCH2      , pOutputs [ I_MCU_OUT_DEM_PITCHANGLE2   ]  );
 #if NR_BLADES >= 3                                                              
-    pLogdata [ OPER_DEM_PITCH3      ] = pOutputs [ I_MCU_OUT_DEM_PITCHANGLE3   ] ;
-    pLogdata [ OPER_MEAS_BENOUT3    ] = pInputs [ I_MCU_IN_MEAS_ROOTOUTBENDM3  ] ;
-    pLogdata [ OPER_MEAS_BENIN3     ] = pInputs [ I_MCU_IN_MEAS_ROOTINBENDM3  ] ;
-    pLogdata [ OPER_MEAS_PITCH3     ] = pInputs [ I_MCU_IN_MEAS_PITCHANGLE3    ] ;
+        LOG_STORE( pLogdata, OPER_DEM_PITCH3      , pOutputs [ I_MCU_OUT_DEM_PITCHANGLE3   ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_BENOUT3    , pInputs [ I_MCU_IN_MEAS_ROOTOUTBENDM3  ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_BENIN3     , pInputs [ I_MCU_IN_MEAS_ROOTINBENDM3  ]  );
+        LOG_STORE( pLogdata, OPER_MEAS_PITCH3     , pInputs [ I_MCU_IN_MEAS_PITCHANGLE3    ]  );
 #endif 
+        LOG_STORE( pLogdata, OPER_SHED_LEVEL      , R_( MCUD->Shed_Level    )  );
+        LOG_STORE( pLogdata, OPER_SHED_OVERRUNS   , R_( MCUD->Shed_Overruns )  );
+    }
 
     return iError;
 
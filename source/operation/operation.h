@@ -64,6 +64,7 @@
     \param cMessage         [in+out]    Output a message to the external program.
     \param MCUS             [in]        The struct with static prameters for the base controller.
     \param MCUD             [in+out]    The struct with dynamic controller data for the base controller.
+    \param REC              [in+out]    Recipe struct with the set points, owned by the controller instance.
     \param STATE_INTINDEX   [in]        Index number of the current controller state.
     
     \return        A non zero int will be returned in the case an error occurred.    
@@ -80,6 +81,7 @@ int operation (
               char             * cMessage   ,
         const mcu_data_static  * MCUS       ,
               mcu_data_dynamic * MCUD       ,
+              base_contr_recipe* REC        ,
         const int                STATE_INTINDEX    
         
 ) ;
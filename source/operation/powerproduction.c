@@ -158,10 +158,10 @@ int power_production (
     REC->iExternalInputs = 0             ;
 
     /* Log signals */
-    pLogdata [ BASE_SPD_OMEGA_SC        ] = Omega_sc     ;
-    pLogdata [ BASE_SPD_TGEN_BOUND      ] = Tgen_bound   ;
-    pLogdata [ BASE_SPD_WHALF           ] = Whalf        ;
-    pLogdata [ BASE_SPD_TORQUESELECT    ] = TorqueSelect ;
+    LOG_STORE( pLogdata, BASE_SPD_OMEGA_SC        , Omega_sc      );
+    LOG_STORE( pLogdata, BASE_SPD_TGEN_BOUND      , Tgen_bound    );
+    LOG_STORE( pLogdata, BASE_SPD_WHALF           , Whalf         );
+    LOG_STORE( pLogdata, BASE_SPD_TORQUESELECT    , TorqueSelect  );
     
     /* Report succes */
     return iError;
@@ -47,7 +47,7 @@ int startup (
             REAL                 * pLogdata                , 
     const   int                    iStatus                 , 
     const   mcu_data_static      * MCUS                    ,
-    const   mcu_data_dynamic     * MCUD                    ,
+            mcu_data_dynamic     * MCUD                    ,
     const   sup_data_static      * SUPS                    ,
             base_contr_recipe    * REC                     
 
@@ -66,11 +66,8 @@ int startup (
    const REAL Wmax    = MCUS->Wmax / MCUS->iGB    ;
    const REAL Whalf   = ( Wmin + Wmax ) /  R_(2.0)  ;
    const REAL OmegaR  = pInputs[ I_MCU_IN_MEAS_GENSPEED ] / MCUS->iGB ;
-   /* Static variables */
-   static int iIntState     = ENTRY;
-   static int iThirdFlag    = 0;
-   static int iThirdCount   = 0;
-   static matrix trd_ramp;
+   /* Substate data, kept in the dynamic struct (ENTRY after construction) */
+   matrix * trd_ramp        = &MCUD->Startup_Ramp;
 
    /* Calculate variables */
    colPitch   += pInputs[ I_MCU_IN_MEAS_PITCHANGLE1 ];
@@ -85,7 +82,7 @@ int startup (
 //   middlePitch = (SUPS->Strt_MaxPitch - SUPS->Strt_MinPitch)/R_(2.0);
 
    /* Substates Supervisor */
-   if (iIntState == ENTRY )
+   if (MCUD->Startup_SubState == ENTRY )
    {
 		#ifdef _LOG
 			pFile = fopen("logstartupc.txt","w") ;
@@ -96,7 +93,7 @@ int startup (
 	   {
 		   if ( colPitch > SUPS->Strt_MaxPitch )
 		   {
-			   iIntState = BLADESTOFINE;
+			   MCUD->Startup_SubState = BLADESTOFINE;
 				#ifdef _LOG
 					fprintf (pFile, "BLADESTOFINE %d \n",1);
 					fflush (pFile);
@@ -104,54 +101,55 @@ int startup (
 		   }
 		   else
 		   {
-			   iIntState = STARTUPCOND;
+			   MCUD->Startup_SubState = STARTUPCOND;
 		   }
 	   }
 	   else
 	   {
-		   iIntState = POWPRODCOND;
+		   MCUD->Startup_SubState = POWPRODCOND;
 	   }
    }
-   else if (iIntState == BLADESTOFINE )
+   else if (MCUD->Startup_SubState == BLADESTOFINE )
    {
-	   if ( iThirdCount >= trd_ramp.M)
+	   if ( MCUD->Startup_ThirdCount >= trd_ramp->M)
 	   {
 			#ifdef _LOG
 				fprintf (pFile, "STARTUPCOND %d (3rd finished) \n",4);
 				fflush (pFile);
 			#endif
-		   iIntState   = STARTUPCOND;
-		   iThirdFlag  = 0;
-		   iThirdCount = 0;
-		   trd_ramp.M  = 1;
-		   trd_ramp.N  = 1;
-		   free(trd_ramp.Mat);
+		   MCUD->Startup_SubState   = STARTUPCOND;
+		   MCUD->Startup_ThirdFlag  = 0;
+		   MCUD->Startup_ThirdCount = 0;
+		   trd_ramp->M  = 1;
+		   trd_ramp->N  = 1;
+		   free(trd_ramp->Mat);
+		   trd_ramp->Mat = NULL;
 			#ifdef _LOG
 				fprintf (pFile, "STARTUPCOND %d (3rd freed) \n",5);
 				fflush (pFile);
 			#endif
 	   }
    }
-   else if (iIntState == STARTUPCOND )
+   else if (MCUD->Startup_SubState == STARTUPCOND )
    {
 	   if ( pInputs[ I_MCU_IN_MEAS_GENSPEED ] >= SUPS->Strt_CutInSpeed )
 	   {
-		   iIntState = POWPRODCOND;
+		   MCUD->Startup_SubState = POWPRODCOND;
 	   }
    }
    else
    {
-	   iIntState = POWPRODCOND;
+	   MCUD->Startup_SubState = POWPRODCOND;
    }
 
    /* Substate Blades to Fine */
-   if  (iIntState == BLADESTOFINE )
+   if  (MCUD->Startup_SubState == BLADESTOFINE )
    {
 	   /* Contactor Off */
 	   REC->iDemGridContact = 0;
 
 	   /* Third order setpoint havent been generated. */
-	   if ( iThirdFlag == 0 )
+	   if ( MCUD->Startup_ThirdFlag == 0 )
 	   {
 			#ifdef _LOG
 				fprintf (pFile, "3rd Entry %d \n",3);
@@ -164,38 +162,38 @@ int startup (
 						diffPitch,  SUPS->Strt_MaxTripPitchSpd,  SUPS->Strt_MaxTripPitchAcc,  SUPS->Strt_MaxTripPitchJerk, MCUS->Ts);
 				fflush (pFile);
 			#endif
-		   /* Call third order setpoint geenrator. Memory for trd_ramp.Mat is allocated inside. */
-		   thirdord( diffPitch, SUPS->Strt_MaxTripPitchSpd, SUPS->Strt_MaxTripPitchAcc, SUPS->Strt_MaxTripPitchJerk, MCUS->Ts, &trd_ramp );
+		   /* Call third order setpoint geenrator. Memory for trd_ramp->Mat is allocated inside. */
+		   thirdord( diffPitch, SUPS->Strt_MaxTripPitchSpd, SUPS->Strt_MaxTripPitchAcc, SUPS->Strt_MaxTripPitchJerk, MCUS->Ts, trd_ramp );
 			#ifdef _LOG
 				fprintf (pFile, "3rd Generated %d \n",3);
 				fflush (pFile);
 				vFile = fopen("logsetopint.txt","w") ;
 			#endif
 		   /* Fix direction and offset of generated setpoint */
-		   for (i = 0; i < trd_ramp.M; i++)
+		   for (i = 0; i < trd_ramp->M; i++)
 		   {
-			   trd_ramp.Mat[i] = colPitch-trd_ramp.Mat[i];
+			   trd_ramp->Mat[i] = colPitch-trd_ramp->Mat[i];
 				#ifdef _LOG
-					fprintf (vFile, "%3.3f \n",trd_ramp.Mat[i]);
+					fprintf (vFile, "%3.3f \n",trd_ramp->Mat[i]);
 					fflush (vFile);
 				#endif
 		   }
 		   /* Third order setpoint generated */
-		   iThirdFlag = 1;
+		   MCUD->Startup_ThirdFlag = 1;
 			#ifdef _LOG
 				fprintf (pFile, "3rd Fixed %d \n",3);
-				fprintf (pFile, "Setpoint size M = %d, N = %d \n",trd_ramp.M,trd_ramp.N);
+				fprintf (pFile, "Setpoint size M = %d, N = %d \n",trd_ramp->M,trd_ramp->N);
 				fflush (pFile);
 				fclose(vFile);
 			#endif
 	   }
 
 	   /* Open loop of rotor speed controllers */
-	   if ( iThirdCount < trd_ramp.M)
+	   if ( MCUD->Startup_ThirdCount < trd_ramp->M)
 	   {
-		   REC->dRotSpdOpenLoopPitch   = trd_ramp.Mat[iThirdCount] ;
+		   REC->dRotSpdOpenLoopPitch   = trd_ramp->Mat[MCUD->Startup_ThirdCount] ;
 			#ifdef _LOG
-				fprintf (pFile, "%d th Setpoint applied: %3.3f \n",iThirdCount,REC->dRotSpdOpenLoopPitch);
+				fprintf (pFile, "%d th Setpoint applied: %3.3f \n",MCUD->Startup_ThirdCount,REC->dRotSpdOpenLoopPitch);
 				fflush (pFile);
 			#endif
 	   }
@@ -209,7 +207,7 @@ int startup (
 	   REC->iRotSpdOpenLoopTorque  = 1        ;
 
 	   /* Increase third order setpoint index */
-	   iThirdCount += 1;
+	   MCUD->Startup_ThirdCount += 1;
 
 	   /* De-activation of other modules */
 	   REC->dActRSPD               = R_(1.0);
@@ -231,7 +229,7 @@ int startup (
    }
 
    /* Substate Startup Conditions */
-   if  (iIntState == STARTUPCOND )
+   if  (MCUD->Startup_SubState == STARTUPCOND )
    {
 	   /* Contactor Off */
 	   REC->iDemGridContact = 0;
@@ -284,7 +282,7 @@ int startup (
    }
 
    /* Substate Power Production Conditions */
-   if  (iIntState == POWPRODCOND )
+   if  (MCUD->Startup_SubState == POWPRODCOND )
    {
 	   /* Contactor On */
 	   REC->iDemGridContact        = 1;
@@ -365,7 +363,7 @@ int startup (
 	   /* Disable the mechanical brake. */
 	   REC->iDemMechBrake          = 0;
 
-	   iIntState = ENTRY;
+	   MCUD->Startup_SubState = ENTRY;
    }
 
 //   /* Open loop of rotor speed controller */
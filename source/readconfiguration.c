@@ -71,6 +71,9 @@ int readconfiguration (
     fscanf( fid, "%s\n", MCUS->dllGUI       ); // printf( "%s \n", MCUS->dllGUI      );
     fscanf( fid, "%s\n", MCUS->LogDir       ); // printf( "%s \n", MCUS->LogDir      );
 
+    /* Optional line: configuration file of a shadow controller */
+    if ( fscanf( fid, "%s\n", MCUS->ShadowConfig ) != 1 ) strcpy( MCUS->ShadowConfig, "none" );
+
     fclose( fid );
   
     #ifdef _SUP
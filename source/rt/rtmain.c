@@ -0,0 +1,110 @@
+/* ---------------------------------------------------------------------------------
+ *          file : rtmain.c                                                       *
+ *   description : C-source file, command line entry point of the RT runner       *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#define _DOTX_HOST_     // Host of the controller: keeps the heap of the process, see staticmem.h
+
+#include <unistd.h>
+
+#include "./../signals/signal_definitions_internal.h"
+#include "./../signals/signal_definitions_custom.h"
+#include "./../signals/signal_definitions_external.h"
+
+#include "./rtrunner.h"
+#include "./../farm/mcufarm.h"
+
+static void rt_usage( const char * cProgram )
+{
+    fprintf( stderr, 
+        "usage: %s -i <inputs> [options]\n"
+        "  -c <file>    configuration file of the controller   (controller.ini)\n"
+        "  -i <file>    input file, one row of inputs per sample\n"
+        "  -t <Ts>      sample time [s]                          (0.01)\n"
+        "  -n <steps>   number of run samples                    (1000)\n"
+        "  -f <step>    index of the first run sample            (1)\n"
+        "  -p <prio>    SCHED_FIFO priority, 0 for normal        (%d)\n"
+        "  -a <cpu>     pin the periodic thread to a core\n"
+        "  -s <bytes>   stack size of the periodic thread        (%d)\n"
+        "  -l           feed back the actuator demands as measurements\n"
+        "  -r           replay the samples back to back, without waiting for the period\n"
+        "  -o <file>    record the outputs of every sample\n"
+        "  -k <file>    save the controller state after the last sample\n"
+        "  -w <file>    warm start from a saved controller state\n"
+        "  -m <N>       scaling curve of the farm executor with N instances on the first sample, instead of the run\n"
+        "  -j <threads> largest number of threads of the scaling curve, 0 for all cores (0)\n",
+        cProgram, RT_PRIORITY, RT_STACKSIZE );
+}
+
+/* ---------------------------------------------------------------------------------
+ * Main entry point of the real-time runner
+--------------------------------------------------------------------------------- */
+int main( int argc, char ** argv )
+{
+    rt_config   cfg;
+    rt_source   src;
+    rt_stats    stats;
+    char      * cInputs   = NULL;
+    int         bLoopback = 0;
+    int         nFarm     = 0, nFarmThreads = 0;
+    int         c, iError = MCU_OK;
+
+    rt_defaults( &cfg );
+
+    while ( ( c = getopt( argc, argv, "c:i:t:n:f:p:a:s:lro:k:w:m:j:h" ) ) != -1 ) {
+        switch ( c ) {
+            case 'c' : { strncpy( cfg.cConfig, optarg, FILENAMESIZE-1 ); break; }
+            case 'i' : { cInputs        = optarg;                       break; }
+            case 't' : { cfg.Ts         = (REAL) atof( optarg );        break; }
+            case 'n' : { cfg.nSteps     = atol( optarg );               break; }
+            case 'f' : { cfg.iFirst     = atol( optarg );               break; }
+            case 'p' : { cfg.iPriority  = atoi( optarg );               break; }
+            case 'a' : { cfg.iCpu       = atoi( optarg );               break; }
+            case 's' : { cfg.nStackSize = (size_t) atol( optarg );      break; }
+            case 'l' : { bLoopback      = 1;                            break; }
+            case 'r' : { cfg.bReplay    = 1;                            break; }
+            case 'o' : { strncpy( cfg.cOutputs, optarg, FILENAMESIZE-1 ); break; }
+            case 'k' : { strncpy( cfg.cCheckpoint, optarg, FILENAMESIZE-1 ); break; }
+            case 'w' : { strncpy( cfg.cRestore, optarg, FILENAMESIZE-1 ); break; }
+            case 'm' : { nFarm          = atoi( optarg );               break; }
+            case 'j' : { nFarmThreads   = atoi( optarg );               break; }
+            default  : { rt_usage( argv[0] ); return MCU_ERR; }
+        }
+    }
+
+    if ( cInputs == NULL || cfg.Ts <= R_(0.0) || cfg.iFirst < 1 ) {
+        rt_usage( argv[0] );
+        return MCU_ERR;
+    }
+
+    iError += rt_source_file( &src, cInputs, bLoopback );
+    if ( iError > MCU_OK ) return iError;
+
+    if ( nFarm > 0 ) {
+
+        /* Every instance of the farm runs on the first sample of the inputs */
+        REAL pInputs[ MCU_NR_INPUTS ] = { R_(0.0) }, pOutputs[ MCU_NR_OUTPUTS ] = { R_(0.0) };
+        iError += src.read( src.vpState, cfg.iFirst, pOutputs, pInputs );
+        pInputs[ I_MCU_IN_TIMESTEP    ] = cfg.Ts;
+        pInputs[ I_MCU_IN_CURRENTTIME ] = cfg.Ts * cfg.iFirst;
+
+        iError += mcufarm_scaling( nFarm, (int) cfg.nSteps, nFarmThreads, cfg.cConfig, pInputs, stdout );
+
+        rt_source_file_free( &src );
+        return ( iError > MCU_OK ) ? 1 : 0;
+    }
+
+    iError += rt_run( &cfg, &src, &stats );
+    rt_print( &cfg, &stats, stdout );
+
+    rt_source_file_free( &src );
+
+    /* Non zero exit code if the controller failed, missed a deadline or used the heap in a run sample */
+    return ( iError > MCU_OK || stats.iErrors > MCU_OK || stats.nOverruns > 0 || stats.nHeap > 0 ) ? 1 : 0;
+}
+
+/* ---------------------------------------------------------------------------------
+  end rtmain.c
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,482 @@
+/* ---------------------------------------------------------------------------------
+ *          file : rtrunner.c                                                     *
+ *   description : C-source file, real-time Linux host of the controller          *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#define _GNU_SOURCE
+#define _DOTX_HOST_     // Host of the controller: keeps the heap of the process, see staticmem.h
+
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <sys/mman.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "./../signals/signal_definitions_internal.h"
+#include "./../signals/signal_definitions_custom.h"
+#include "./../signals/signal_definitions_external.h"
+
+#include "./../maincontrollerunit.h"
+
+#include "./rtrunner.h"
+
+#define RT_NSEC     1000000000LL
+
+/* Data of the periodic thread, allocated (and locked) before the thread starts */
+typedef struct rt_task {
+    const rt_config   * cfg                             ;
+    rt_source         * src                             ;
+    rt_stats          * stats                           ;
+    int                 iError                          ;
+    REAL                pInputs [ MCU_NR_INPUTS  ]      ;
+    REAL                pOutputs[ MCU_NR_OUTPUTS ]      ;
+    REAL                pDebug  [ RT_DEBUGSIZE   ]      ;
+    REAL                pLogdata[ MAXLOG         ]      ;
+    char                cMessage[ RT_MSGSIZE     ]      ;
+    char                cRunname[ FILENAMESIZE   ]      ;
+    FILE              * fidOutputs                      ;
+    void              * vpRestore                       ;
+    size_t              nRestore                        ;
+} rt_task;
+
+/* Data of the file source */
+typedef struct rt_file {
+    REAL              * pRows                           ;
+    long                nRows                           ;
+    int                 bLoopback                       ;
+} rt_file;
+
+/* ---------------------------------------------------------------------------------
+ Time arithmetic
+--------------------------------------------------------------------------------- */
+static long long rt_ns( const struct timespec * t )
+{
+    return (long long)t->tv_sec * RT_NSEC + t->tv_nsec;
+}
+
+static void rt_add( struct timespec * t, const long long ns )
+{
+    long long tNew = rt_ns( t ) + ns;
+    t->tv_sec  = (time_t)( tNew / RT_NSEC );
+    t->tv_nsec = (long)  ( tNew % RT_NSEC );
+}
+
+/* ---------------------------------------------------------------------------------
+ Touch the stack which the controller will use, so it is mapped (and locked) 
+ before the periodic loop starts
+--------------------------------------------------------------------------------- */
+static void rt_prefault_stack( const size_t nBytes )
+{
+    volatile unsigned char cStack[ nBytes ];
+    memset( (void*)cStack, 0, nBytes );
+}
+
+/* ---------------------------------------------------------------------------------
+ Call the controller
+--------------------------------------------------------------------------------- */
+static int rt_step( rt_task * T, const long iStep, const int iStatus )
+{
+    int iError = MCU_OK;
+
+    if ( T->src->read != NULL ) 
+        iError += T->src->read( T->src->vpState, iStep, T->pOutputs, T->pInputs );
+
+    T->pInputs[ I_MCU_IN_TIMESTEP    ] = T->cfg->Ts;
+    T->pInputs[ I_MCU_IN_CURRENTTIME ] = T->cfg->Ts * iStep;
+
+    if ( iStatus == MCU_STATUS_INIT ) strcpy( T->cMessage, T->cfg->cConfig );
+
+    iError += mcu_run( T->pInputs, T->pOutputs, T->pDebug, T->pLogdata, iStatus, PLC, T->cMessage, T->cRunname );
+
+    if ( iStatus != MCU_STATUS_RUN ) fprintf( stderr, "%s", T->cMessage );
+
+    /* Record the outputs of the run samples */
+    if ( T->fidOutputs != NULL && iStatus == MCU_STATUS_RUN ) {
+        int k;
+        for ( k = 0; k < MCU_NR_OUTPUTS; ++k ) fprintf( T->fidOutputs, "%.9e\t", (double)T->pOutputs[k] );
+        fprintf( T->fidOutputs, "\n" );
+    }
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Save the state of the controller to the checkpoint file
+--------------------------------------------------------------------------------- */
+static int rt_save( const char * cFile )
+{
+    size_t  nSize = 0;
+    void  * vpBuffer;
+    FILE  * fid;
+    int     iError = MCU_OK;
+
+    if ( mcu_run_save( NULL, &nSize ) > MCU_OK || ( vpBuffer = malloc( nSize ) ) == NULL ) {
+        fprintf( stderr, "[rt]   <err> Failed to save the checkpoint\n" );
+        return MCU_ERR;
+    }
+
+    iError += mcu_run_save( vpBuffer, &nSize );
+
+    fid = ( iError == MCU_OK ) ? fopen( cFile, "wb" ) : NULL;
+    if ( fid == NULL || fwrite( vpBuffer, 1, nSize, fid ) != nSize ) iError += MCU_ERR;
+    if ( fid != NULL && fclose( fid ) != 0 ) iError += MCU_ERR;
+
+    if ( iError > MCU_OK ) fprintf( stderr, "[rt]   <err> Failed to write checkpoint %s\n", cFile );
+    else fprintf( stderr, "[rt]   Checkpoint of %lu bytes written to %s\n", (unsigned long) nSize, cFile );
+
+    free( vpBuffer );
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Read a checkpoint file, it is restored by the periodic thread after the initialization
+--------------------------------------------------------------------------------- */
+static int rt_read( const char * cFile, void ** vpBuffer, size_t * nSize )
+{
+    long   nFile;
+    FILE * fid = fopen( cFile, "rb" );
+
+    *vpBuffer = NULL;
+    *nSize    = 0;
+
+    if ( fid == NULL || fseek( fid, 0, SEEK_END ) != 0 || ( nFile = ftell( fid ) ) <= 0 || fseek( fid, 0, SEEK_SET ) != 0 
+            || ( *vpBuffer = malloc( (size_t) nFile ) ) == NULL || fread( *vpBuffer, 1, (size_t) nFile, fid ) != (size_t) nFile ) {
+        fprintf( stderr, "[rt]   <err> Failed to read checkpoint %s\n", cFile );
+        if ( fid != NULL ) fclose( fid );
+        free( *vpBuffer );
+        *vpBuffer = NULL;
+        return MCU_ERR;
+    }
+
+    fclose( fid );
+    *nSize = (size_t) nFile;
+    return MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ The periodic thread
+--------------------------------------------------------------------------------- */
+static void * rt_thread( void * vpTask )
+{
+    rt_task         * T     = (rt_task*) vpTask;
+    rt_stats        * S     = T->stats;
+    const long long   nsTs  = (long long) llround( T->cfg->Ts * 1e9 );
+    struct timespec   tNext, tWake, tDone;
+    long long         nsLat, nsExec, nsWakePrev = 0, nsLatSum = 0, nsExecSum = 0;
+    long              k;
+#ifdef DOTXALLOCAUDIT
+    long              nHeap;
+#endif
+
+#ifdef __linux__
+    if ( T->cfg->iCpu >= 0 ) {
+        cpu_set_t set;
+        CPU_ZERO( &set );
+        CPU_SET( T->cfg->iCpu, &set );
+        if ( pthread_setaffinity_np( pthread_self( ), sizeof(set), &set ) != 0 ) 
+            fprintf( stderr, "[rt]   <wrn> Failed to pin the thread to core %d\n", T->cfg->iCpu );
+    }
+#endif
+
+    rt_prefault_stack( T->cfg->nStackSize * 3 / 4 );
+
+    /* Initialization allocates the data of the controller, which is locked as well */
+    T->iError += rt_step( T, 0, MCU_STATUS_INIT );
+    if ( T->iError > MCU_OK ) return NULL;
+
+    /* Warm start: continue from the saved state */
+    if ( T->vpRestore != NULL ) {
+        if ( mcu_run_restore( T->vpRestore, T->nRestore ) > MCU_OK ) {
+            fprintf( stderr, "[rt]   <err> Checkpoint %s does not fit the controller\n", T->cfg->cRestore );
+            T->iError += MCU_ERR;
+            return NULL;
+        }
+        fprintf( stderr, "[rt]   Checkpoint %s restored\n", T->cfg->cRestore );
+    }
+
+    S->dExecMin = R_(1e30);
+
+    clock_gettime( CLOCK_MONOTONIC, &tNext );
+
+    for ( k = 1; k <= T->cfg->nSteps; ++k ) {
+
+        /* Sleep until the absolute deadline, a replay starts the next sample immediately */
+        rt_add( &tNext, nsTs );
+        if ( T->cfg->bReplay ) clock_gettime( CLOCK_MONOTONIC, &tNext );
+        else while ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &tNext, NULL ) == EINTR );
+        clock_gettime( CLOCK_MONOTONIC, &tWake );
+
+        nsLat = rt_ns( &tWake ) - rt_ns( &tNext );
+        nsLatSum += nsLat;
+        S->dLatencyMax = MAX( S->dLatencyMax, R_(1e-3) * nsLat );
+        if ( k > 1 ) 
+            S->dJitterMax = MAX( S->dJitterMax, R_(1e-3) * ABS( (REAL)( rt_ns( &tWake ) - nsWakePrev - nsTs ) ) );
+        nsWakePrev = rt_ns( &tWake );
+
+        /* Sample, the runner itself is not audited (_DOTX_HOST_) */
+#ifdef DOTXALLOCAUDIT
+        nHeap = alloc_count( );
+#endif
+        S->iErrors += rt_step( T, T->cfg->iFirst + k - 1, MCU_STATUS_RUN );
+#ifdef DOTXALLOCAUDIT
+        S->nHeap += alloc_count( ) - nHeap;
+#endif
+
+        clock_gettime( CLOCK_MONOTONIC, &tDone );
+
+        nsExec = rt_ns( &tDone ) - rt_ns( &tWake );
+        nsExecSum += nsExec;
+        S->dExecMin = MIN( S->dExecMin, R_(1e-3) * nsExec );
+        S->dExecMax = MAX( S->dExecMax, R_(1e-3) * nsExec );
+        S->nSteps   = k;
+
+        /* The sample finished after the next deadline, skip the periods which were missed */
+        if ( rt_ns( &tDone ) > rt_ns( &tNext ) + nsTs ) {
+            S->nOverruns += 1;
+            while ( rt_ns( &tDone ) > rt_ns( &tNext ) + nsTs ) {
+                rt_add( &tNext, nsTs );
+                S->nSkipped += 1;
+            }
+        }
+    }
+
+    if ( S->nSteps > 0 ) {
+        S->dLatencyMean = R_(1e-3) * (REAL)nsLatSum  / S->nSteps;
+        S->dExecMean    = R_(1e-3) * (REAL)nsExecSum / S->nSteps;
+    }
+    else S->dExecMin = R_(0.0);
+
+    /* The state after the last run sample */
+    if ( T->cfg->cCheckpoint[0] != '\0' ) T->iError += rt_save( T->cfg->cCheckpoint );
+
+    T->iError += rt_step( T, T->cfg->iFirst + T->cfg->nSteps, MCU_STATUS_EXIT );
+
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------------------
+ Default settings
+--------------------------------------------------------------------------------- */
+void rt_defaults( rt_config * cfg )
+{
+    memset( cfg, 0, sizeof(rt_config) );
+    strcpy( cfg->cConfig, "controller.ini" );
+    cfg->Ts         = R_(0.01);
+    cfg->nSteps     = 1000;
+    cfg->iFirst     = 1;
+    cfg->iPriority  = RT_PRIORITY;
+    cfg->iCpu       = -1;
+    cfg->nStackSize = RT_STACKSIZE;
+}
+
+/* ---------------------------------------------------------------------------------
+ Run the controller periodically
+--------------------------------------------------------------------------------- */
+int rt_run( const rt_config * cfg, rt_source * src, rt_stats * stats )
+{
+    int iError = MCU_OK, rc;
+    pthread_t thread;
+    pthread_attr_t attr;
+    struct sched_param param;
+    rt_task * T;
+
+    memset( stats, 0, sizeof(rt_stats) );
+
+    /* Lock all current and future pages, and keep freed memory in the process */
+    stats->iLocked = ( mlockall( MCL_CURRENT | MCL_FUTURE ) == 0 );
+    if ( !stats->iLocked ) fprintf( stderr, "[rt]   <wrn> Failed to lock the memory (%s)\n", strerror( errno ) );
+#ifdef __GLIBC__
+    mallopt( M_TRIM_THRESHOLD, -1 );
+    mallopt( M_MMAP_MAX, 0 );
+#endif
+
+    T = (rt_task*) calloc( 1, sizeof(rt_task) );
+    if ( T == NULL ) return MCU_ERR;
+    T->cfg   = cfg;
+    T->src   = src;
+    T->stats = stats;
+
+    if ( cfg->cOutputs[0] != '\0' ) {
+        T->fidOutputs = fopen( cfg->cOutputs, "w" );
+        if ( T->fidOutputs == NULL ) {
+            fprintf( stderr, "[rt]   <err> Failed to open output file %s\n", cfg->cOutputs );
+            free( T );
+            return MCU_ERR;
+        }
+    }
+
+    if ( cfg->cRestore[0] != '\0' ) iError += rt_read( cfg->cRestore, &T->vpRestore, &T->nRestore );
+
+    if ( iError == MCU_OK && src->open != NULL ) iError += src->open( src->vpState );
+    if ( iError > MCU_OK ) { if ( T->fidOutputs != NULL ) fclose( T->fidOutputs ); free( T->vpRestore ); free( T ); return iError; }
+
+    /* Create the periodic thread, fall back to normal scheduling without privileges */
+    pthread_attr_init( &attr );
+    pthread_attr_setstacksize( &attr, MAX( cfg->nStackSize, (size_t)PTHREAD_STACK_MIN ) );
+    if ( cfg->iPriority > 0 ) {
+        param.sched_priority = cfg->iPriority;
+        pthread_attr_setinheritsched( &attr, PTHREAD_EXPLICIT_SCHED );
+        pthread_attr_setschedpolicy ( &attr, SCHED_FIFO );
+        pthread_attr_setschedparam  ( &attr, &param );
+    }
+
+    rc = pthread_create( &thread, &attr, rt_thread, T );
+    stats->iRealtime = ( rc == 0 && cfg->iPriority > 0 );
+
+    if ( rc == EPERM && cfg->iPriority > 0 ) {
+        fprintf( stderr, "[rt]   <wrn> No permission for SCHED_FIFO, running with normal scheduling\n" );
+        pthread_attr_setinheritsched( &attr, PTHREAD_INHERIT_SCHED );
+        rc = pthread_create( &thread, &attr, rt_thread, T );
+    }
+    pthread_attr_destroy( &attr );
+
+    if ( rc != 0 ) {
+        fprintf( stderr, "[rt]   <err> Failed to create the periodic thread (%s)\n", strerror( rc ) );
+        iError += MCU_ERR;
+    }
+    else {
+        pthread_join( thread, NULL );
+        iError += T->iError;
+    }
+
+    if ( src->close != NULL ) iError += src->close( src->vpState );
+
+    if ( T->fidOutputs != NULL ) fclose( T->fidOutputs );
+    free( T->vpRestore );
+    free( T );
+
+    if ( stats->iLocked ) munlockall( );
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Print the statistics
+--------------------------------------------------------------------------------- */
+void rt_print( const rt_config * cfg, const rt_stats * stats, FILE * fid )
+{
+    fprintf( fid, "\n" );
+    fprintf( fid, "[rt]   Sample time       : %10.3f us\n", R_(1e6) * cfg->Ts );
+    fprintf( fid, "[rt]   Scheduling        : %s, memory %s\n", 
+                stats->iRealtime ? "SCHED_FIFO" : "normal", stats->iLocked ? "locked" : "not locked" );
+    fprintf( fid, "[rt]   Samples           : %10ld\n", stats->nSteps );
+    fprintf( fid, "[rt]   Overruns          : %10ld (%ld periods skipped)\n", stats->nOverruns, stats->nSkipped );
+    fprintf( fid, "[rt]   Controller errors : %10d\n", stats->iErrors );
+#ifdef DOTXALLOCAUDIT
+    fprintf( fid, "[rt]   Heap operations   : %10ld (run samples)%s\n", stats->nHeap, stats->nHeap > 0 ? "  <err>" : "" );
+#endif
+    fprintf( fid, "[rt]   Latency    [us]   : mean %10.3f   max %10.3f\n", stats->dLatencyMean, stats->dLatencyMax );
+    fprintf( fid, "[rt]   Jitter     [us]   :                   max %10.3f\n", stats->dJitterMax );
+    fprintf( fid, "[rt]   Execution  [us]   : mean %10.3f   max %10.3f   min %10.3f\n", 
+                stats->dExecMean, stats->dExecMax, stats->dExecMin );
+    fprintf( fid, "[rt]   Worst case [us]   : %10.3f (latency + execution, budget %.3f)\n", 
+                stats->dLatencyMax + stats->dExecMax, R_(1e6) * cfg->Ts );
+}
+
+/* ---------------------------------------------------------------------------------
+ File source
+--------------------------------------------------------------------------------- */
+static int rt_file_read( void * vpState, const long iStep, const REAL * pOutputs, REAL * pInputs )
+{
+    rt_file * F = (rt_file*) vpState;
+
+    memcpy( pInputs, F->pRows + ( iStep % F->nRows ) * MCU_NR_INPUTS, MCU_NR_INPUTS * sizeof(REAL) );
+
+    /* Ideal actuators */
+    if ( F->bLoopback && iStep > 0 ) {
+        pInputs[ I_MCU_IN_MEAS_PITCHANGLE1 ] = pOutputs[ I_MCU_OUT_DEM_PITCHANGLE1 ];
+        pInputs[ I_MCU_IN_MEAS_PITCHANGLE2 ] = pOutputs[ I_MCU_OUT_DEM_PITCHANGLE2 ];
+#if NR_BLADES == 3
+        pInputs[ I_MCU_IN_MEAS_PITCHANGLE3 ] = pOutputs[ I_MCU_OUT_DEM_PITCHANGLE3 ];
+#endif
+        pInputs[ I_MCU_IN_MEAS_GENTORQUE   ] = pOutputs[ I_MCU_OUT_DEM_GENTORQUE   ];
+    }
+
+    return MCU_OK;
+}
+
+int rt_source_file( rt_source * src, const char * cFile, const int bLoopback )
+{
+    char  * cLine = NULL, * p, * q;
+    size_t  nLine = 0;
+    long    nAlloc = 0;
+    int     k;
+
+    FILE * fid = fopen( cFile, "r" );
+    if ( fid == NULL ) {
+        fprintf( stderr, "[rt]   <err> Failed to open input file %s\n", cFile );
+        return MCU_ERR;
+    }
+
+    rt_file * F = (rt_file*) calloc( 1, sizeof(rt_file) );
+    if ( F == NULL ) {
+        fprintf( stderr, "[rt]   <err> Failed to allocate the input file %s\n", cFile );
+        fclose( fid );
+        return MCU_ERR;
+    }
+    F->bLoopback = bLoopback;
+
+    while ( getline( &cLine, &nLine, fid ) > 0 ) {
+
+        if ( cLine[0] == '#' || cLine[0] == '\n' || cLine[0] == '\r' ) continue;
+
+        if ( F->nRows == nAlloc ) {
+            REAL * pRows = (REAL*) realloc( F->pRows, MAX( 64, 2*nAlloc ) * MCU_NR_INPUTS * sizeof(REAL) );
+            if ( pRows == NULL ) {
+                fprintf( stderr, "[rt]   <err> Failed to allocate row %ld of input file %s\n", F->nRows + 1, cFile );
+                free( cLine );
+                fclose( fid );
+                free( F->pRows );
+                free( F );
+                return MCU_ERR;
+            }
+            F->pRows = pRows;
+            nAlloc   = MAX( 64, 2*nAlloc );
+        }
+
+        /* Missing values are zero */
+        p = cLine;
+        for ( k = 0; k < MCU_NR_INPUTS; ++k ) {
+            F->pRows[ F->nRows * MCU_NR_INPUTS + k ] = (REAL) strtod( p, &q );
+            p = q;
+        }
+        F->nRows += 1;
+    }
+
+    free( cLine );
+    fclose( fid );
+
+    if ( F->nRows == 0 ) {
+        fprintf( stderr, "[rt]   <err> No inputs in file %s\n", cFile );
+        free( F->pRows );
+        free( F );
+        return MCU_ERR;
+    }
+
+    memset( src, 0, sizeof(rt_source) );
+    src->vpState = F;
+    src->read    = rt_file_read;
+
+    return MCU_OK;
+}
+
+void rt_source_file_free( rt_source * src )
+{
+    rt_file * F = (rt_file*) src->vpState;
+
+    if ( F == NULL ) return;
+    free( F->pRows );
+    free( F );
+    src->vpState = NULL;
+}
+
+/* ---------------------------------------------------------------------------------
+  end rtrunner.c
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,188 @@
+/* ---------------------------------------------------------------------------------
+ *          file : rtrunner.h                                                     *
+ *   description : C-header file, real-time Linux host of the controller          *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _RTRUNNER_H_
+#define _RTRUNNER_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup moduleRT Real-time runner
+
+    The real-time runner hosts the controller (through mcu_run()) in a periodic
+    POSIX thread on Linux, e.g. on a PLC or a hardware-in-the-loop rig. It
+    proves whether the controller meets its sample time under load:
+
+    - the thread runs with SCHED_FIFO at the requested priority, optionally
+      pinned to one core;
+    - all memory is locked with mlockall() and the stack of the thread is
+      pre-faulted, so no page fault occurs during the periodic loop;
+    - every period is started by clock_nanosleep() with an absolute deadline
+      on CLOCK_MONOTONIC, so the period does not drift;
+    - the wake-up latency, the jitter of the period, the execution time and
+      the number of overruns (samples which finished after the next deadline)
+      are counted.
+
+    The measurements are supplied by an input source (#rt_source), which is a
+    set of callbacks. A source replaying a file with one row of inputs per
+    sample is provided by rt_source_file(); a fieldbus or a plant model is
+    plugged in by filling an #rt_source with its own callbacks.
+
+    With bReplay set in the #rt_config, the samples are run back to back
+    without waiting for the deadlines. A recorded trace is then replayed as
+    fast as possible, which is used to train the profile-guided build of
+    make_linux.mk; the execution times and overruns remain valid, the latency
+    and jitter are meaningless. The outputs of every sample can be recorded
+    in a file (cOutputs), which is used to compare the single and double
+    precision builds.
+
+    The state of the controller can be saved after the last run sample
+    (cCheckpoint) and restored right after the initialization (cRestore), see
+    \ref checkpoint. A run of N samples with a checkpoint, followed by a warm
+    start from sample iFirst = N+1, produces the same outputs as one
+    uninterrupted run.
+
+    When the process is not allowed to use real-time scheduling or to lock its
+    memory, the runner falls back to normal scheduling and reports this in the
+    statistics, so the host can also be used for functional tests.
+
+    \sa moduleMCU
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  rtrunner.h
+    \brief This header file contains the real-time Linux host of the controller.
+*/
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+#define RT_DEBUGSIZE        200             //!< Size of the debug array passed to the controller.
+#define RT_MSGSIZE          (10*BUFSIZE)    //!< Size of the message passed to the controller.
+#define RT_STACKSIZE        (512*1024)      //!< Default stack size of the periodic thread [bytes].
+#define RT_PRIORITY         80              //!< Default SCHED_FIFO priority of the periodic thread.
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_STRUCTS
+
+/*! \struct rt_source
+    \brief  Pluggable source of the controller inputs.
+
+    The callbacks are called from the periodic thread, read() should therefore
+    not block and should not allocate memory. The runner sets the time and the
+    time step of the inputs itself.
+ */
+typedef struct rt_source {
+
+    void  * vpState                                                             ;   //!< Private data of the source.
+    
+    //! Called once before the initialization of the controller.
+    int ( *open  )( void * vpState )                                            ;
+    
+    //! Fill the inputs of sample iStep, pOutputs holds the outputs of the previous sample.
+    int ( *read  )( void * vpState, const long iStep, const REAL * pOutputs, REAL * pInputs ) ;
+    
+    //! Called once after the exit of the controller.
+    int ( *close )( void * vpState )                                            ;
+
+} rt_source;
+
+/*! \struct rt_config
+    \brief  Settings of the real-time runner.
+ */
+typedef struct rt_config {
+
+    char    cConfig[ FILENAMESIZE ]     ;   //!< Configuration file of the controller (controller.ini).
+    REAL    Ts                          ;   //!< Sample time [s].
+    long    nSteps                      ;   //!< Number of run samples.
+    long    iFirst                      ;   //!< Index of the first run sample, sample k is read from the source with time k*Ts.
+    int     iPriority                   ;   //!< SCHED_FIFO priority, zero for normal scheduling.
+    int     iCpu                        ;   //!< Core to pin the thread to, negative for no pinning.
+    size_t  nStackSize                  ;   //!< Stack size of the periodic thread, pre-faulted before the loop [bytes].
+    int     bReplay                     ;   //!< Flag to run the samples back to back instead of periodically.
+    char    cOutputs[ FILENAMESIZE ]    ;   //!< File to record the outputs of every run sample, empty for none.
+    char    cCheckpoint[ FILENAMESIZE ] ;   //!< File to save the state of the controller to after the last run sample, empty for none.
+    char    cRestore[ FILENAMESIZE ]    ;   //!< Checkpoint to restore after the initialization (warm start), empty for none.
+
+} rt_config;
+
+/*! \struct rt_stats
+    \brief  Timing statistics of the periodic loop, all times in microseconds.
+ */
+typedef struct rt_stats {
+
+    long    nSteps                      ;   //!< Number of executed run samples.
+    long    nOverruns                   ;   //!< Number of samples which finished after the next deadline.
+    long    nSkipped                    ;   //!< Number of periods skipped after overruns.
+    int     iErrors                     ;   //!< Sum of the error codes of the controller.
+    long    nHeap                       ;   //!< Heap operations of the controller in the run samples, only counted with DOTXALLOCAUDIT.
+    int     iRealtime                   ;   //!< Flag indicating that SCHED_FIFO was obtained.
+    int     iLocked                     ;   //!< Flag indicating that the memory was locked.
+    REAL    dLatencyMax                 ;   //!< Largest wake-up latency (wake-up time minus deadline).
+    REAL    dLatencyMean                ;   //!< Mean wake-up latency.
+    REAL    dJitterMax                  ;   //!< Largest deviation of the period between two wake-ups from Ts.
+    REAL    dExecMin                    ;   //!< Smallest execution time of a sample.
+    REAL    dExecMax                    ;   //!< Largest execution time of a sample.
+    REAL    dExecMean                   ;   //!< Mean execution time of a sample.
+
+} rt_stats;
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+//! Default settings: Ts = 0.01 s, 1000 samples from sample 1, priority #RT_PRIORITY, no pinning.
+void rt_defaults( rt_config * cfg );
+
+//! Run the controller periodically.
+/*!
+    Initializes the controller, runs cfg->nSteps samples in a periodic thread 
+    and exits the controller. The messages of the controller are written to 
+    stderr.
+
+    \param cfg      [in]        Settings of the runner.
+    \param src      [in+out]    Source of the inputs.
+    \param stats    [out]       Timing statistics of the loop.
+    \return         A non zero int will be returned in the case an error occurred.
+*/
+int rt_run( const rt_config * cfg, rt_source * src, rt_stats * stats );
+
+//! Print the statistics in human readable form.
+void rt_print( const rt_config * cfg, const rt_stats * stats, FILE * fid );
+
+//! Source replaying a file with one row of MCU_NR_INPUTS inputs per sample.
+/*!
+    The file is read completely by open(), rows are separated by newlines and 
+    values by white space, lines starting with '#' are skipped. After the last 
+    row the file is replayed from the start. If bLoopback is set, the demanded 
+    pitch angles and generator torque of the previous sample are fed back as 
+    measurements (ideal actuators).
+
+    \param src          [out]   The source.
+    \param cFile        [in]    Name of the file.
+    \param bLoopback    [in]    Flag to feed back the actuator demands.
+    \return             A non zero int will be returned in the case an error occurred.
+*/
+int rt_source_file( rt_source * src, const char * cFile, const int bLoopback );
+
+//! Release the data of a source created by rt_source_file().
+void rt_source_file_free( rt_source * src );
+
+#endif
+
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _RTRUNNER_H_
+--------------------------------------------------------------------------------- */
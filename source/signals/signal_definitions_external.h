@@ -5,6 +5,10 @@
     The #LOGSIGNALS enumeration holds the indices used to adress variables in
     the pLogdata array. The signals are not individually documented as a Matlab
     scripts reads the file to auto generate the same indeces in Matlab.
+
+    Values are stored with LOG_STORE(), which compiles to nothing for a channel
+    which is not logged in this build. The log file only contains the channels
+    of the packed log record, see #LOG_NR_PACKED and logPacked[].
 */
 
 
@@ -16,6 +20,10 @@
 //   X_NUMBERS = (Variable Name, Bladed Unit, ON/OFF DotX logging, ON/OFF Bladed logging)
 //
 //   Just add as many rows as desired while following the specified format, the macros take care of the rest
+//   DotX logging can be :
+//		0   not logged
+//		1   logged
+//		2   logged, also in a build with DOTXLOGCORE which only logs this fixed subset
 //   Bladed Unit can be :
 //		A/T
 //		FL
@@ -24,13 +32,13 @@
 //		P
 
 #define X_NUMBERS        						\
-    X(OPER_MEAS_TIME              , - , 1 , 0 ) \
-    X(OPER_MEAS_GENSPEED          , - , 1 , 0 ) \
+    X(OPER_MEAS_TIME              , - , 2 , 0 ) \
+    X(OPER_MEAS_GENSPEED          , - , 2 , 0 ) \
     X(OPER_MEAS_AZIMUTH           , - , 1 , 0 ) \
     X(OPER_MEAS_FAACC             , - , 1 , 0 ) \
     X(OPER_MEAS_SWACC             , - , 1 , 0 ) \
-    X(OPER_MEAS_GENTORQUE         , - , 1 , 0 ) \
-    X(OPER_MEAS_ELECPOWER         , - , 1 , 0 ) \
+    X(OPER_MEAS_GENTORQUE         , - , 2 , 0 ) \
+    X(OPER_MEAS_ELECPOWER         , - , 2 , 0 ) \
     X(OPER_MEAS_YAWERROR          , - , 1 , 0 ) \
     X(OPER_MEAS_TIMESTEP          , - , 1 , 0 ) \
     X(OPER_MEAS_GRIDCONT          , - , 1 , 0 ) \
@@ -40,16 +48,18 @@
     X(OPER_MEAS_BENIN1           , - , 1 , 0 ) \
     X(OPER_MEAS_BENIN2           , - , 1 , 0 ) \
     X(OPER_MEAS_BENIN3           , - , 1 , 0 ) \
-    X(OPER_MEAS_PITCH1            , - , 1 , 0 ) \
-    X(OPER_MEAS_PITCH2            , - , 1 , 0 ) \
-    X(OPER_MEAS_PITCH3            , - , 1 , 0 ) \
+    X(OPER_MEAS_PITCH1            , - , 2 , 0 ) \
+    X(OPER_MEAS_PITCH2            , - , 2 , 0 ) \
+    X(OPER_MEAS_PITCH3            , - , 2 , 0 ) \
     X(OPER_MEAS_ACTTYPE           , - , 1 , 0 ) \
-    X(OPER_MEAS_HUBWIND           , - , 1 , 0 ) \
-    X(OPER_DEM_GENTORQUE          , - , 1 , 0 ) \
-    X(OPER_DEM_PITCH1             , - , 1 , 0 ) \
-    X(OPER_DEM_PITCH2             , - , 1 , 0 ) \
-    X(OPER_DEM_PITCH3             , - , 1 , 0 ) \
-    X(OPER_DEM_YAWRATE            , - , 1 , 0 ) \
+    X(OPER_MEAS_HUBWIND           , - , 2 , 0 ) \
+    X(OPER_DEM_GENTORQUE          , - , 2 , 0 ) \
+    X(OPER_DEM_PITCH1             , - , 2 , 0 ) \
+    X(OPER_DEM_PITCH2             , - , 2 , 0 ) \
+    X(OPER_DEM_PITCH3             , - , 2 , 0 ) \
+    X(OPER_DEM_YAWRATE            , - , 2 , 0 ) \
+    X(OPER_SHED_LEVEL             , - , 2 , 0 ) \
+    X(OPER_SHED_OVERRUNS          , - , 2 , 0 ) \
     X(BASE_SPD_RTSP               , - , 1 , 0 ) \
     X(BASE_SPD_RTSP_P_HPF         , - , 1 , 0 ) \
     X(BASE_SPD_RTSP_P_NFP         , - , 1 , 0 ) \
@@ -318,11 +328,16 @@
     X(DNPC_COMPEN_OM              , - , 1 , 0 ) \
     X(DNPC_COMPEN_KC              , - , 1 , 0 ) \
     X(SUP_TRIGGER                 , - , 1 , 0 ) \
-    X(SUP_TRIGGER_INDEX           , - , 1 , 0 ) \
+    X(SUP_TRIGGER_INDEX           , - , 2 , 0 ) \
     X(SUP_STATE                   , - , 1 , 0 ) \
-    X(SUP_STATE_INDEX             , - , 1 , 0 ) \
+    X(SUP_STATE_INDEX             , - , 2 , 0 ) \
     X(SUP_OVERPOWER               , - , 1 , 0 ) \
     X(SUP_OVERSPEED               , - , 1 , 0 ) \
+    X(SHADOW_COST                 , - , 1 , 0 ) \
+    X(SHADOW_DEM_GENTORQUE        , - , 1 , 0 ) \
+    X(SHADOW_DEM_PITCH1           , - , 1 , 0 ) \
+    X(SHADOW_DEM_PITCH2           , - , 1 , 0 ) \
+    X(SHADOW_DEM_PITCH3           , - , 1 , 0 ) \
     X(ZZZ_DEBUG0                  , - , 1 , 0 ) \
     X(ZZZ_DEBUG1                  , - , 1 , 0 ) \
     X(ZZZ_DEBUG2                  , - , 1 , 0 ) \
@@ -343,6 +358,13 @@ enum {
 };
 
 
+// Channels in the log file of this build
+#ifdef DOTXLOGCORE
+#define LOG_ON(DotxLog) ( (DotxLog) == 2 )
+#else
+#define LOG_ON(DotxLog) ( (DotxLog) != 0 )
+#endif
+
 static char *tableNames[] = {
 #define X(Name,Unit,DotxLog,BldLog) MACROSTR(Name),
 		X_NUMBERS
@@ -356,7 +378,7 @@ static char *bladedNames[] = {
 };
 
 static int dotxLogflags[] = {
-#define X(Name,Unit,DotxLog,BldLog) DotxLog,
+#define X(Name,Unit,DotxLog,BldLog) LOG_ON(DotxLog),
 		X_NUMBERS
 #undef X
 };
@@ -368,5 +390,41 @@ static int bladedLogflags[] = {
 };
 
 
+// LOGS_<Name> is 1 when the channel is stored: in the log file or in the Bladed logging
+enum {
+#define X(Name,Unit,DotxLog,BldLog) LOGS_##Name = LOG_ON(DotxLog) || (BldLog),
+    X_NUMBERS
+#undef X
+};
+
+// Store a value in the log array, the compiler removes the store of a channel which is not logged
+#define LOG_STORE(pLog, Name, Value) do { if ( LOGS_##Name ) (pLog)[ Name ] = (Value); } while ( 0 )
+
+// LOGP_<Name> is the position of an enabled channel in the packed log record, the
+// second enumerator of a disabled channel steps back so the next one takes its place
+enum {
+#define X(Name,Unit,DotxLog,BldLog) LOGP_##Name, LOGP_NEXT_##Name = LOGP_##Name + LOG_ON(DotxLog) - 1,
+    X_NUMBERS
+#undef X
+};
+
+// LOGQ_<Name> counts the disabled channels in the same way
+enum {
+#define X(Name,Unit,DotxLog,BldLog) LOGQ_##Name, LOGQ_NEXT_##Name = LOGQ_##Name + !LOG_ON(DotxLog) - 1,
+    X_NUMBERS
+#undef X
+};
+
+#define LOG_NR_PACKED LOGP_MAXLOG   // Number of channels in the log file
+
+// Channel of each position in the packed log record: the enabled channels in the order of
+// the table, followed by the disabled ones
+static const int logPacked[ MAXLOG + 1 ] = {
+#define X(Name,Unit,DotxLog,BldLog) [ (Name) == MAXLOG ? MAXLOG : LOG_ON(DotxLog) ? LOGP_##Name : MAXLOG - 1 - LOGQ_##Name ] = Name,
+		X_NUMBERS
+#undef X
+};
+
+
 
 #endif
@@ -15,6 +15,10 @@
 #include <string.h>
 
 #include "./../suplib/debugger.h"
+#include "./../suplib/allocaudit.h"
+#include "./../suplib/platform.h"
+#include "./../suplib/arena.h"
+#include "./../suplib/staticmem.h"
 
 #ifdef _DOTX_GLOG_
 	extern FILE * dotxfid;
@@ -123,6 +127,41 @@ enum MCU_STEPRESPONSES {
     MCU_STEP_IPC2Pq                     ,   //!<    Step on Q-component in IPC at 2P
 	MCU_STEP_COLL						    //!<    Step ont he collective pitch angle
 } MCU_STEPRESPONSES;
+
+/*! \enum MCU_SHEDTASKS
+    Low-criticality tasks which are deferred when the controller exceeds its time
+    budget, in the order in which they are shed (see mcu_shed_update()).
+*/
+enum MCU_SHEDTASKS {
+
+    MCU_SHED_LOGDATA                    ,   //!<    Writing the log line by logdata()
+    MCU_SHED_YAW                        ,   //!<    The yaw controller base_yaw_control()
+    MCU_SHED_STATISTICS                 ,   //!<    Recording the cycle-time statistics of the profiler
+    MCU_SHED_STATUS                     ,   //!<    Writing an empty message to the .STATUS file by the wrappers
+    MCU_SHED_DNPCMSG                    ,   //!<    Copying the message of the DNPC, not shed in a sample in which the DNPC reports an error
+
+    MCU_NR_SHEDTASKS                        //!<    Total number of tasks which can be shed
+} MCU_SHEDTASKS;
+
+/*! \enum MCU_BLOCKS
+    Blocks of the controller pipeline, in the order in which they are executed. 
+    Blocks of which no output reaches an actuator or a consumed log channel are 
+    removed from the run samples, see mcu_schedule().
+*/
+enum MCU_BLOCKS {
+
+    MCU_BLOCK_ROTSPD_FILTERS            ,   //!<    The rotor speed filters of the pitch and torque controller
+    MCU_BLOCK_SCHED_FILTERS             ,   //!<    The low-pass filters of the power and pitch for the gain schedules
+    MCU_BLOCK_ROTORSPEED                ,   //!<    The rotor speed controller base_rotorspeed()
+    MCU_BLOCK_BASE_LOG                  ,   //!<    Logging the signals of the rotor speed controller
+    MCU_BLOCK_DTDAMP                    ,   //!<    The drivetrain damping controller base_dt_damping()
+    MCU_BLOCK_FADAMP                    ,   //!<    The fore-aft damping controller base_fa_damping()
+    MCU_BLOCK_YAW                       ,   //!<    The yaw controller base_yaw_control()
+    MCU_BLOCK_ACTUATORS                 ,   //!<    Adding the control actions to the demanded pitch, torque and yaw rate
+    MCU_BLOCK_OPER_LOG                  ,   //!<    Logging the measurements and demands by operation()
+
+    MCU_NR_BLOCKS                           //!<    Total number of blocks
+} MCU_BLOCKS;
 //!@}
 
 
@@ -195,12 +234,30 @@ enum DNPC_SIGNALS_OUT {
 /* ------------------------------------------------------------------------------ */
 
 
+#ifdef FLOATPRECISION
+typedef float REAL;                         //!<    Definition of REAL as a float (compile with -DFLOATPRECISION)
+#define R_FMT           "%f"                //!<    Conversion of a REAL for scanf
+#define R_SIN           sinf                //!<    Math functions in the precision of REAL
+#define R_COS           cosf
+#define R_TAN           tanf
+#define R_EXP           expf
+#define R_SQRT          sqrtf
+#define R_POW           powf
+#define R_FLOOR         floorf
+#define R_CEIL          ceilf
+#else
 #define DOUBLEPRECISION                     //!<    Controller compiled in double precision
 typedef double REAL;                        //!<    Definition of REAL as a double
-
-/* [EAN 25/MAY/2013] Not yet operational */
-//#define FLOATPRECISION                    //!<    Controller compiled in float precision
-//typedef float REAL;                       //!<    Definition of REAL as a float
+#define R_FMT           "%lf"               //!<    Conversion of a REAL for scanf
+#define R_SIN           sin                 //!<    Math functions in the precision of REAL
+#define R_COS           cos
+#define R_TAN           tan
+#define R_EXP           exp
+#define R_SQRT          sqrt
+#define R_POW           pow
+#define R_FLOOR         floor
+#define R_CEIL          ceil
+#endif
 
 #define R_(x)           ((REAL)(x))
 #define MAX(a,b)        ((a) > (b) ? (a) : (b))
@@ -208,10 +265,10 @@ typedef double REAL;                        //!<    Definition of REAL as a doub
 #define ABS(a)          ((a) > R_(0.0)  ? (a) : -(a))
 #define NINT(a)         ((a) >= R_(0.0) ? (int)((a)+R_(0.5)) : (int)((a)-R_(0.5)))
 #define NINTF(a)        ((a) >= 0.0F ? (int)((a)+0.5F) : (int)((a)-0.5F))
-#define deg2rad(X)      (M_PI/R_(180.0)*(X))
-#define rad2deg(X)      (R_(180.0)/M_PI*(X))
-#define rpm2rps(X)      (M_PI/R_(30.0)*(X))
-#define rps2rpm(X)      (R_(30.0)/M_PI*(X))
+#define deg2rad(X)      (R_(M_PI)/R_(180.0)*(X))
+#define rad2deg(X)      (R_(180.0)/R_(M_PI)*(X))
+#define rpm2rps(X)      (R_(M_PI)/R_(30.0)*(X))
+#define rps2rpm(X)      (R_(30.0)/R_(M_PI)*(X))
 
 // rate [unit/sec] and ts [sec] strictly positive (rate > 0 and ts > 0)
 #define SRAMP(actual,desired,rate,ts)        ((desired) > (actual) ? (MIN((desired),((actual)+((ABS(ts))*(ABS(rate)))))) : (MAX((desired),((actual)-((ABS(ts))*(ABS(rate)))))))
@@ -225,10 +282,13 @@ typedef double REAL;                        //!<    Definition of REAL as a doub
 #define MAX_SCHED_SIZE  30                  //!<    Maximum number of elements in ALL schedule-tables
 #define FILENAMESIZE    256                 //!<    Maximum length of filenames
 #define BUFSIZE         1024                //!<    Buffer size
-#define EPS             1e-12               //!<    Smallest number for double comparison to zero, i.e. ABS(value) < EPS
+#define EPS             R_(1e-12)           //!<    Smallest number for double comparison to zero, i.e. ABS(value) < EPS
 
 #define SIGN(a)         ((a) / MAX(EPS,ABS((a)))  )
 
+// rate = {divisor, phase offset} as read by par_readline_rate(), k = number of run samples since initialization
+#define RATE_DUE(rate,k,status)              ( (status) != MCU_STATUS_RUN || (k) % (unsigned long long)(rate)[0] == (unsigned long long)(rate)[1] )  //!< A multi-rate task is due in this sample (always during initialization and exit)
+
 
 #define N_HPF_FILTERS 1                     //!<    Number of HPF in ALL filter sequences
 #define N_NFP_FILTERS 12                    //!<    Number of NFP in ALL filter sequences
@@ -63,9 +63,10 @@ typedef struct evm_data_dynamic{
  
 //! Allocation of memory for the evm_data_static struct.
 /*!
-    \return A pointer to a new instance of the evm_data_static struct is returned.
+    \param a       The arena of the instance.
+    \return A pointer to a new instance of the evm_data_static struct is returned, NULL if the arena only counts or is exhausted.
 */
-evm_data_static * init_evmdatastatic( const REAL * );
+evm_data_static * init_evmdatastatic( mem_arena * a, const REAL * );
 
 //! Freeing the memory occupied by the evm_data_static struct.
 /*!
@@ -76,10 +77,11 @@ int free_evmdatastatic( evm_data_static * EVMS );
 
 //! Allocation of memory for the evm_data_dynamic struct.
 /*!
+    \param a       The arena of the instance.
     \param EVMS    The dynamic struct is based on the parameters defined in the static struct.
-    \return A new instance of the mcu_data_dynamic struct is returned.
+    \return A new instance of the evm_data_dynamic struct is returned, NULL if the arena only counts or is exhausted.
 */
-evm_data_dynamic * init_evmdatadynamic( evm_data_static * EVMS );
+evm_data_dynamic * init_evmdatadynamic( mem_arena * a, evm_data_static * EVMS );
 
 //! Freeing the memory occupied by the evm_data_dynamic struct.
 /*!
@@ -16,12 +16,12 @@
 
 /* ---------------------------------------------------------------------------------
  Constructor of the evm_data_dynamic struct. Here all memory for data arrays needs 
- to be allocated.
+ to be carved from the arena of the instance.
 --------------------------------------------------------------------------------- */
-evm_data_dynamic * init_evmdatadynamic( evm_data_static * EVMS ) 
+evm_data_dynamic * init_evmdatadynamic( mem_arena * a, evm_data_static * EVMS ) 
 {
-    /* Allocate memory for the struct */
-    evm_data_dynamic * EVMD = (evm_data_dynamic*) calloc( 1, sizeof(evm_data_dynamic) );
+    /* Carve the struct, the arena is cleared at its allocation */
+    evm_data_dynamic * EVMD = (evm_data_dynamic*) arena_carve_line( a, sizeof(evm_data_dynamic) );
 
     /* Return allocated data struct */
     return EVMD;
@@ -30,16 +30,15 @@ evm_data_dynamic * init_evmdatadynamic( evm_data_static * EVMS )
 
 
 /* ---------------------------------------------------------------------------------
- Destructor of evm_data_dynamic struct. Here all memory for data arrays needs to
- be released.
+ Destructor of evm_data_dynamic struct. Here all memory outside the arena of the
+ instance needs to be released.
 --------------------------------------------------------------------------------- */
 int free_evmdatadynamic( evm_data_dynamic * EVMD )
 {
     /* Release memory of members of the struct */
     
     
-    /* Release memory of the struct itself */
-    free( EVMD );
+    /* The struct itself is released with the arena */
     
     return MCU_OK;
     
@@ -16,12 +16,13 @@
 
 /* ---------------------------------------------------------------------------------
  Constructor of evm_data_static struct. Here all memory for data arrays needs to
- be allocated.
+ be carved from the arena of the instance.
 --------------------------------------------------------------------------------- */
-evm_data_static * init_evmdatastatic( const REAL * pInputs  )
+evm_data_static * init_evmdatastatic( mem_arena * a, const REAL * pInputs )
 {
-    /* Allocate memory for the struct */
-    evm_data_static * EVMS = (evm_data_static*) calloc( 1, sizeof(evm_data_static) );
+    /* Carve the struct, the arena is cleared at its allocation */
+    evm_data_static * EVMS = (evm_data_static*) arena_carve_line( a, sizeof(evm_data_static) );
+    if ( EVMS == NULL ) return NULL;
     
     /* Initialize static variables */
     EVMS->Ts = pInputs[ I_MCU_IN_TIMESTEP ];
@@ -33,16 +34,15 @@ evm_data_static * init_evmdatastatic( const REAL * pInputs  )
 
 
 /* ---------------------------------------------------------------------------------
- Destructor of evm_data_static struct. Here all memory for data arrays needs to
- be released.
+ Destructor of evm_data_static struct. Here all memory outside the arena of the
+ instance needs to be released.
 --------------------------------------------------------------------------------- */
 int free_evmdatastatic( evm_data_static * EVMS )
 {
     /* Release memory of members of the struct */
 
     
-    /* Release memory of the struct itself */
-    free( EVMS );
+    /* The struct itself is released with the arena */
     
     return MCU_OK;
     
@@ -63,11 +63,12 @@ typedef struct sim_data_dynamic{
 //! Allocation of memory for the sim_data_static struct.
 /*!
 
+    \param a          The arena of the instance.
     \param pInputs    An array with all required inputs into the controller. The properties of the array and indexes of individual variables are described in signal_definitions_internal.h underneath \"IO of the MCU\".    
 
-    \return A pointer to a new instance of the sim_data_static struct is returned.
+    \return A pointer to a new instance of the sim_data_static struct is returned, NULL if the arena only counts or is exhausted.
 */
-sim_data_static * init_simdatastatic( const REAL * pInputs  );
+sim_data_static * init_simdatastatic( mem_arena * a, const REAL * pInputs  );
 
 //! Freeing the memory occupied by the sim_data_static struct.
 /*!
@@ -78,10 +79,11 @@ int free_simdatastatic( sim_data_static * SIMS );
 
 //! Allocation of memory for the sim_data_dynamic struct.
 /*!
+    \param a       The arena of the instance.
     \param SIMS    The dynamic struct is based on the parameters defined in the static struct.
-    \return A new instance of the mcu_data_dynamic struct is returned.
+    \return A new instance of the sim_data_dynamic struct is returned, NULL if the arena only counts or is exhausted.
 */
-sim_data_dynamic * init_simdatadynamic( sim_data_static * SIMS );
+sim_data_dynamic * init_simdatadynamic( mem_arena * a, sim_data_static * SIMS );
 
 //! Freeing the memory occupied by the sim_data_dynamic struct.
 /*!
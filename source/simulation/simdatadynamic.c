@@ -16,12 +16,12 @@
 
 /* ---------------------------------------------------------------------------------
  Constructor of the sim_data_dynamic struct. Here all memory for data arrays needs 
- to be allocated.
+ to be carved from the arena of the instance.
 --------------------------------------------------------------------------------- */
-sim_data_dynamic * init_simdatadynamic( sim_data_static * SIMS ) 
+sim_data_dynamic * init_simdatadynamic( mem_arena * a, sim_data_static * SIMS ) 
 {
-    /* Allocate memory for the struct */
-    sim_data_dynamic * SIMD = (sim_data_dynamic*) calloc( 1, sizeof(sim_data_dynamic) );    
+    /* Carve the struct, the arena is cleared at its allocation */
+    sim_data_dynamic * SIMD = (sim_data_dynamic*) arena_carve_line( a, sizeof(sim_data_dynamic) );
 
     /* Return allocated data struct */
     return SIMD;
@@ -30,13 +30,12 @@ sim_data_dynamic * init_simdatadynamic( sim_data_static * SIMS )
 
 
 /* ---------------------------------------------------------------------------------
- Destructor of sim_data_dynamic struct. Here all memory for data arrays needs to
- be released.
+ Destructor of sim_data_dynamic struct. Here all memory outside the arena of the
+ instance needs to be released.
 --------------------------------------------------------------------------------- */
 int free_simdatadynamic( sim_data_dynamic * SIMD )
 {
-    /* Release memory of the struct itself */
-    free( SIMD );
+    /* The struct itself is released with the arena */
     
     return MCU_OK;
     
@@ -16,12 +16,13 @@
 
 /* ---------------------------------------------------------------------------------
  Constructor of sim_data_static struct. Here all memory for data arrays needs to
- be allocated.
+ be carved from the arena of the instance.
 --------------------------------------------------------------------------------- */
-sim_data_static * init_simdatastatic( const REAL * pInputs )
+sim_data_static * init_simdatastatic( mem_arena * a, const REAL * pInputs )
 {
-    /* Allocate memory for the struct */
-    sim_data_static * SIMS = (sim_data_static*) calloc( 1, sizeof(sim_data_static) );
+    /* Carve the struct, the arena is cleared at its allocation */
+    sim_data_static * SIMS = (sim_data_static*) arena_carve_line( a, sizeof(sim_data_static) );
+    if ( SIMS == NULL ) return NULL;
     
     /* Initialize static variables */
     SIMS->Ts         = pInputs[ I_MCU_IN_TIMESTEP ];
@@ -33,16 +34,15 @@ sim_data_static * init_simdatastatic( const REAL * pInputs )
 
 
 /* ---------------------------------------------------------------------------------
- Destructor of sim_data_static struct. Here all memory for data arrays needs to
- be released.
+ Destructor of sim_data_static struct. Here all memory outside the arena of the
+ instance needs to be released.
 --------------------------------------------------------------------------------- */
 int free_simdatastatic( sim_data_static * SIMS )
 {
     /* Release memory of members of the struct */
 
     
-    /* Release memory of the struct itself */
-    free( SIMS );
+    /* The struct itself is released with the arena */
     
     return MCU_OK;
     
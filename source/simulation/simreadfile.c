@@ -36,7 +36,7 @@ int sim_readfile (
     FILE *fidInFile, *fidOutFile;
     char cInFile[200], cOutFile[200];
     char cDate [13];
-    struct tm * clock;    
+    struct tm * clock, tmDate;    
     struct stat attrib; 
     time_t now;
 
@@ -56,7 +56,7 @@ int sim_readfile (
     // Obtain modification time of par-file 
 
     stat( cInFile, &attrib );
-    clock = gmtime(&(attrib.st_mtime));
+    clock = plat_gmtime( &(attrib.st_mtime), &tmDate );
     strftime( cDate, 20, "%d/%m/%Y at %H:%M", clock);
     
     
@@ -82,7 +82,7 @@ int sim_readfile (
     strcat( cOutFile, ".PAR" );
     iCall++;
     
-    if ( ( fidOutFile = fopen ( cOutFile, "w" ) ) == NULL ) {
+    if ( ( fidOutFile = par_echo_open( cOutFile ) ) == NULL ) {
     
         strcat( cMessage, "[sim]  <err> Unable to open <" );
         strcat( cMessage, cOutFile );
@@ -103,7 +103,7 @@ int sim_readfile (
     // Close file
     
     fclose( fidInFile );
-    fclose( fidOutFile );
+    par_echo_close( fidOutFile );
     
     
     return 0;
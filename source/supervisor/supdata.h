@@ -63,6 +63,7 @@ typedef struct sup_data_static {
     //! \name General parameters
     //@{    
     REAL    Ts                                          ;   //!<    Time step size of the controller 
+    int     Trig_Rate[2]                                ;   //!<    Rate divisor and phase offset of the trigger scan in detect_triggers(), the triggers are held in between.
     //@}
     
     //! \name Parameters for the generator speed related triggers.
@@ -109,10 +110,11 @@ typedef struct sup_data_dynamic{
 
 //! Allocation of memory for the sup_data_static struct.
 /*!
+    \param a        [in+out] The arena of the instance.
     \param pInputs  [in] Array of measurements inputs.
-    \return         A pointer to a new instance of the sup_data_static struct is returned.
+    \return         A pointer to a new instance of the sup_data_static struct is returned, NULL if the arena only counts or is exhausted.
 */
-sup_data_static * init_supdatastatic( const REAL * pInputs );
+sup_data_static * init_supdatastatic( mem_arena * a, const REAL * pInputs );
 
 //! Freeing the memory occupied by the sup_data_static struct.
 /*!
@@ -123,10 +125,11 @@ int free_supdatastatic( sup_data_static * SUPS );
 
 //! Allocation of memory for the sup_data_dynamic struct.
 /*!
+    \param a        [in+out] The arena of the instance.
     \param SUPS     [in]     The dynamic struct is based on the parameters defined in the static struct.
-    \return         A new instance of the mcu_data_dynamic struct is returned.
+    \return         A new instance of the sup_data_dynamic struct is returned, NULL if the arena only counts or is exhausted.
 */
-sup_data_dynamic * init_supdatadynamic( sup_data_static * SUPS, const REAL * pInputs );
+sup_data_dynamic * init_supdatadynamic( mem_arena * a, sup_data_static * SUPS, const REAL * pInputs );
 
 //! Freeing the memory occupied by the sup_data_dynamic struct.
 /*!
@@ -135,6 +138,14 @@ sup_data_dynamic * init_supdatadynamic( sup_data_static * SUPS, const REAL * pIn
 */
 int free_supdatadynamic( sup_data_dynamic * SUPD );
 
+//! Save or restore the sup_data_dynamic struct with a checkpoint.
+/*!
+    \param s        [in,out]  The checkpoint stream, its mode sets the direction.
+    \param SUPD     [in,out]  The dynamic struct to save or restore.
+    \return         A non zero int will be returned in the case the checkpoint does not fit.
+*/
+int sup_checkpoint( ckpt_stream * s, sup_data_dynamic * SUPD );
+
 //! Reads the supervisory input file.
 /*!
     When adding or removing parameters from the supervisory static struct, this
@@ -16,12 +16,13 @@
 
 /* ---------------------------------------------------------------------------------
  Constructor of the sup_data_dynamic struct. Here all memory for data arrays needs 
- to be allocated.
+ to be carved from the arena of the instance.
 --------------------------------------------------------------------------------- */
-sup_data_dynamic * init_supdatadynamic( sup_data_static * SUPS, const REAL * pInputs  ) 
+sup_data_dynamic * init_supdatadynamic( mem_arena * a, sup_data_static * SUPS, const REAL * pInputs  ) 
 {
-    /* Allocate memory for the struct */
-    sup_data_dynamic * SUPD = (sup_data_dynamic*) calloc( 1, sizeof(sup_data_dynamic) );    
+    /* Carve the struct, the arena is cleared at its allocation */
+    sup_data_dynamic * SUPD = (sup_data_dynamic*) arena_carve_line( a, sizeof(sup_data_dynamic) );
+    if ( SUPD == NULL ) return NULL;
     
     /* Init values */
     SUPD->STATE_INTINDEX    = STATE_OFF         ;   
@@ -38,16 +39,36 @@ sup_data_dynamic * init_supdatadynamic( sup_data_static * SUPS, const REAL * pIn
 
 
 /* ---------------------------------------------------------------------------------
- Destructor of sup_data_dynamic struct. Here all memory for data arrays needs to
- be released.
+ Destructor of sup_data_dynamic struct. Here all memory outside the arena of the
+ instance needs to be released.
 --------------------------------------------------------------------------------- */
 int free_supdatadynamic( sup_data_dynamic * SUPD )
 {
     /* Release memory of members of the struct */
 
-    /* Release memory of the struct itself */
-    free( SUPD );
+    /* The struct itself is released with the arena */
     
     return MCU_OK;
     
 } /* end of destructor for the sup_data_static struct */
+
+
+/* ---------------------------------------------------------------------------------
+ Transfer the sup_data_dynamic struct to or from a checkpoint.
+--------------------------------------------------------------------------------- */
+int sup_checkpoint( ckpt_stream * s, sup_data_dynamic * SUPD )
+{
+    int i;
+    int iError = MCU_OK;
+
+    iError += ckpt_int( s, &SUPD->STATE                 );
+    iError += ckpt_int( s, &SUPD->STATE_INTINDEX        );
+    iError += ckpt_int( s, &SUPD->TRIGGER               );
+    iError += ckpt_int( s, &SUPD->TRIGGER_INTINDEX      );
+    for ( i = 0; i < N_TRIGGERS; ++i )
+        iError += ckpt_int( s, &SUPD->TRIGGERLIST[ i ]  );
+    iError += ckpt_int( s, &SUPD->EEC_flag              );
+
+    return iError;
+
+} /* end of checkpoint of the sup_data_dynamic struct */
@@ -16,12 +16,13 @@
 
 /* ---------------------------------------------------------------------------------
  Constructor of sup_data_static struct. Here all memory for data arrays needs to
- be allocated.
+ be carved from the arena of the instance.
 --------------------------------------------------------------------------------- */
-sup_data_static * init_supdatastatic( const REAL * pInputs )
+sup_data_static * init_supdatastatic( mem_arena * a, const REAL * pInputs )
 {
-    /* Allocate memory for the struct */
-    sup_data_static * SUPS = (sup_data_static*) calloc( 1, sizeof(sup_data_static) );
+    /* Carve the struct, the arena is cleared at its allocation */
+    sup_data_static * SUPS = (sup_data_static*) arena_carve_line( a, sizeof(sup_data_static) );
+    if ( SUPS == NULL ) return NULL;
     
     /* Initialize static variables */
     SUPS->Ts = pInputs[ I_MCU_IN_TIMESTEP ];
@@ -29,6 +30,7 @@ sup_data_static * init_supdatastatic( const REAL * pInputs )
     /* General settings */
 
     SUPS->SettlingTime = R_( 99999.0 ); 
+    SUPS->Trig_Rate[0] = 1;
 
     /* Return the constructed data struct */
     return SUPS;
@@ -37,15 +39,14 @@ sup_data_static * init_supdatastatic( const REAL * pInputs )
 
 
 /* ---------------------------------------------------------------------------------
- Destructor of sup_data_static struct. Here all memory for data arrays needs to
- be released.
+ Destructor of sup_data_static struct. Here all memory outside the arena of the
+ instance needs to be released.
 --------------------------------------------------------------------------------- */
 int free_supdatastatic( sup_data_static * SUPS )
 {
     /* Release memory of members of the struct */
     
-    /* Release memory of the struct itself */
-    free( SUPS );
+    /* The struct itself is released with the arena */
     
     return MCU_OK;
     
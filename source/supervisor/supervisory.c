@@ -112,12 +112,12 @@ int supervisory (
     /* -------------------------------------------------------------------------- */
     /* LOG DATA */
     
-    pLogdata[ SUP_TRIGGER           ]   = SUPD->TRIGGER           ;
-    pLogdata[ SUP_TRIGGER_INDEX     ]   = SUPD->TRIGGER_INTINDEX  ;
-    pLogdata[ SUP_STATE             ]   = SUPD->STATE             ;
-    pLogdata[ SUP_STATE_INDEX       ]   = SUPD->STATE_INTINDEX    ;
-    pLogdata[ SUP_OVERPOWER         ]   = SUPS->OverpowerLimit    ; 
-    pLogdata[ SUP_OVERSPEED         ]   = SUPS->OverspeedLimit    ;
+    LOG_STORE( pLogdata, SUP_TRIGGER           , SUPD->TRIGGER            );
+    LOG_STORE( pLogdata, SUP_TRIGGER_INDEX     , SUPD->TRIGGER_INTINDEX   );
+    LOG_STORE( pLogdata, SUP_STATE             , SUPD->STATE              );
+    LOG_STORE( pLogdata, SUP_STATE_INDEX       , SUPD->STATE_INTINDEX     );
+    LOG_STORE( pLogdata, SUP_OVERPOWER         , SUPS->OverpowerLimit     );
+    LOG_STORE( pLogdata, SUP_OVERSPEED         , SUPS->OverspeedLimit     );
     
     /* Report error */
     return iError;
@@ -215,6 +215,9 @@ int supervisory (
     The threshold values set in the supervisory parameter file are used in this
     function to detect triggers. If a trigger is added or modified, this file 
     must be modified as well. 
+    
+    The scan runs once every SUPS->Trig_Rate[0] samples (TriggerRate in the 
+    parameter file), in between the triggers of the last scan are held. 
       
     \param pInputs      [in]        An array with all required inputs into the controller. The properties of the array and indexes of individual variables are described in \ref MCU_SIGNALS_IN and \ref MCU_SIGNALS_IN_CUSTOM.
     \param pOutputs     [out]       An array with all outputs of the controller. The properties of the array and indexes of individual variables are described in \ref MCU_SIGNALS_OUT and \ref MCU_SIGNALS_OUT_CUSTOM.
@@ -77,7 +77,7 @@ int sup_readfile (
     FILE *fidInFile, *fidOutFile;
     char cInFile[200], cOutFile[200];
     char cDate [13];
-    struct tm * clock;    
+    struct tm * clock, tmDate;    
     struct stat attrib; 
     time_t now;
 
@@ -97,7 +97,7 @@ int sup_readfile (
     /* Obtain modification time of par-file */
 
     stat( cInFile, &attrib );
-    clock = gmtime(&(attrib.st_mtime));
+    clock = plat_gmtime( &(attrib.st_mtime), &tmDate );
     strftime( cDate, 20, "%d/%m/%Y at %H:%M", clock);
     
     strcat( cMessage, "[sup]  Loaded <" );
@@ -122,7 +122,7 @@ int sup_readfile (
     strcat( cOutFile, ".PAR" );
     iCall++;
     
-    if ( ( fidOutFile = fopen ( cOutFile, "w" ) ) == NULL ) {
+    if ( ( fidOutFile = par_echo_open( cOutFile ) ) == NULL ) {
     
         strcat( cMessage, "[sup]  <err> Unable to open <" );
         strcat( cMessage, cOutFile );
@@ -145,6 +145,7 @@ int sup_readfile (
     fprintf( fidOutFile, "\n");
 
     iError += par_readline_d( fidInFile, fidOutFile, &SUPS->SettlingTime, "SettlingTime" ); 
+    iError += par_readline_rate( fidInFile, fidOutFile, SUPS->Trig_Rate, "TriggerRate" ); 
 
     fprintf( fidOutFile,"\n\n");
     fprintf( fidOutFile, "* Supervisory state settings * \n");
@@ -187,7 +188,7 @@ int sup_readfile (
     SUPD->TRIGGER   = SUPS->trigger_table[ SUPD->TRIGGER_INTINDEX ].id;
 
     fclose( fidInFile );
-    fclose( fidOutFile );
+    par_echo_close( fidOutFile );
     
     return 0;
 };
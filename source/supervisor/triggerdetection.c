@@ -42,6 +42,9 @@ int detect_triggers (
     /* Local variables */
     int i, iError = MCU_OK;
     
+    /* Hold the triggers of the last scan in between two scans */
+    if ( !RATE_DUE( SUPS->Trig_Rate, MCUD->iSample, iStatus ) ) return iError;
+    
     /* Clear the previously detected triggers. */
     for( i = 0; i < N_TRIGGERS; i++ ) SUPD->TRIGGERLIST[i] = 0;
     
@@ -52,7 +55,7 @@ int detect_triggers (
         SUPD->TRIGGERLIST[ TRIGGER_SUP_OFF ] = 1 ;
     
     /* Detect overpower */
-    if ( pInputs[ I_MCU_IN_MEAS_ELECPOWEROUT ] > (SUPS->OverpowerLimit / 1e6) )
+    if ( pInputs[ I_MCU_IN_MEAS_ELECPOWEROUT ] > (SUPS->OverpowerLimit / R_(1e6)) )
         SUPD->TRIGGERLIST[ TRIGGER_OVERPOWER ] = 1;
 
     /* Detect overspeed */
@@ -0,0 +1,226 @@
+/* ---------------------------------------------------------------------------------
+ *          file : allocaudit.c                                                   *
+ *   description : C-source file, counting hook for heap allocations              *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#define _ALLOCAUDIT_C_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "./allocaudit.h"
+#include "./platform.h"
+#include "./staticmem.h"
+
+#ifdef DOTXALLOCAUDIT
+
+#include <stdatomic.h>
+
+/* Memory of a module, for the whole process */
+typedef struct alloc_usage {
+    const char    * cName   ;
+    long            nCount  ;
+    size_t          nBytes  ;
+    size_t          nPeak   ;
+} alloc_usage;
+
+/* A charged allocation which is in use */
+typedef struct alloc_live {
+    void          * ptr     ;
+    size_t          size    ;
+    int             iModule ;
+} alloc_live;
+
+/* Counters are kept per thread, so instances stepped by different threads do
+   not report each other's allocations */
+static _Thread_local long           nHeapOps    = 0;
+static _Thread_local const char   * cLastFile   = "";
+static _Thread_local int            iLastLine   = 0;
+
+static alloc_hook                   fHook       = NULL;
+
+/* Module of the calling thread, and the memory of all modules. The tables are 
+   shared by the threads, which only use them during the initialization. */
+static _Thread_local const char   * cModule     = NULL;
+static alloc_usage                  sUsage[ ALLOC_MODULES + 1 ];
+static alloc_live                   sLive[ ALLOC_LIVE ];
+static int                          nModules    = 0;
+static long                         nUncharged  = 0;
+static atomic_flag                  bLock       = ATOMIC_FLAG_INIT;
+
+static void alloc_lock( void )   { while ( atomic_flag_test_and_set_explicit( &bLock, memory_order_acquire ) ); }
+static void alloc_unlock( void ) { atomic_flag_clear_explicit( &bLock, memory_order_release ); }
+
+/* Charge an allocation to the module of the calling thread, the last entry of
+   sUsage holds the totals */
+static void alloc_charge( void * ptr, const size_t size )
+{
+    alloc_usage * pTotal = &sUsage[ ALLOC_MODULES ];
+    int k, i;
+
+    if ( cModule == NULL || ptr == NULL ) return;
+
+    alloc_lock( );
+
+    for ( k = 0; k < nModules && sUsage[k].cName != cModule && strcmp( sUsage[k].cName, cModule ) != 0; ++k );
+    if ( k == nModules && nModules < ALLOC_MODULES ) sUsage[ nModules++ ].cName = cModule;
+    for ( i = 0; i < ALLOC_LIVE && sLive[i].ptr != NULL; ++i );
+
+    if ( k < nModules && i < ALLOC_LIVE ) {
+        sLive[i].ptr     = ptr;
+        sLive[i].size    = size;
+        sLive[i].iModule = k;
+
+        sUsage[k].nCount++;
+        sUsage[k].nBytes += size;
+        if ( sUsage[k].nBytes > sUsage[k].nPeak ) sUsage[k].nPeak = sUsage[k].nBytes;
+
+        pTotal->nCount++;
+        pTotal->nBytes += size;
+        if ( pTotal->nBytes > pTotal->nPeak ) pTotal->nPeak = pTotal->nBytes;
+    }
+    else nUncharged++;
+
+    alloc_unlock( );
+}
+
+/* Return the memory of a charged allocation to its module, returns its size */
+static size_t alloc_uncharge( const void * ptr )
+{
+    size_t size = 0;
+    int i;
+
+    alloc_lock( );
+
+    for ( i = 0; i < ALLOC_LIVE && sLive[i].ptr != ptr; ++i );
+    if ( i < ALLOC_LIVE ) {
+        sUsage[ sLive[i].iModule ].nBytes -= sLive[i].size;
+        sUsage[ ALLOC_MODULES    ].nBytes -= sLive[i].size;
+        sLive[i].ptr = NULL;
+        size = sLive[i].size;
+    }
+
+    alloc_unlock( );
+    return size;
+}
+
+/* Record a heap operation */
+static void alloc_record( const char * file, const int line, const size_t size )
+{
+    ++nHeapOps;
+    cLastFile = file;
+    iLastLine = line;
+    if ( fHook != NULL ) fHook( file, line, size );
+}
+
+void * alloc_calloc( size_t n, size_t size, const char * file, const int line )
+{
+    void * ptr;
+
+    alloc_record( file, line, n*size );
+    ptr = calloc( n, size );
+    alloc_charge( ptr, n*size );
+    return ptr;
+}
+
+void * alloc_malloc( size_t size, const char * file, const int line )
+{
+    void * ptr;
+
+    alloc_record( file, line, size );
+    ptr = malloc( size );
+    alloc_charge( ptr, size );
+    return ptr;
+}
+
+void * alloc_realloc( void * ptr, size_t size, const char * file, const int line )
+{
+    void * pNew;
+    size_t nOld = 0;
+
+    alloc_record( file, line, size );
+    if ( ptr != NULL ) nOld = alloc_uncharge( ptr );
+    pNew = realloc( ptr, size );
+
+    /* A failed realloc keeps the old memory */
+    if ( pNew != NULL ) alloc_charge( pNew, size );
+    else if ( size != 0 && nOld > 0 ) alloc_charge( ptr, nOld );
+    return pNew;
+}
+
+void alloc_free( void * ptr, const char * file, const int line )
+{
+    /* free(NULL) does not touch the heap */
+    if ( ptr == NULL ) return;
+    alloc_record( file, line, 0 );
+    alloc_uncharge( ptr );
+    free( ptr );
+}
+
+void alloc_other( void * ptr, size_t size, const char * file, const int line )
+{
+    if ( ptr == NULL ) return;
+    alloc_record( file, line, size );
+    if ( size > 0 ) alloc_charge( ptr, size );
+    else            alloc_uncharge( ptr );
+}
+
+long alloc_count( void )
+{
+    return nHeapOps;
+}
+
+void alloc_reset( void )
+{
+    nHeapOps  = 0;
+    cLastFile = "";
+    iLastLine = 0;
+}
+
+const char * alloc_site( int * line )
+{
+    *line = iLastLine;
+    return cLastFile;
+}
+
+alloc_hook alloc_sethook( alloc_hook hook )
+{
+    alloc_hook fOld = fHook;
+    fHook = hook;
+    return fOld;
+}
+
+const char * alloc_module( const char * cName )
+{
+    const char * cOld = cModule;
+    cModule = cName;
+    return cOld;
+}
+
+void alloc_report( char * cMessage )
+{
+    const alloc_usage * pTotal = &sUsage[ ALLOC_MODULES ];
+    int k;
+
+    alloc_lock( );
+
+    for ( k = 0; k < nModules; ++k )
+        sprintf( cMessage + strlen( cMessage ), "[mem]  %-16s : %4ld allocation(s), %9lu bytes in use, peak %9lu bytes\t\n", 
+            sUsage[k].cName, sUsage[k].nCount, (unsigned long) sUsage[k].nBytes, (unsigned long) sUsage[k].nPeak );
+    sprintf( cMessage + strlen( cMessage ), "[mem]  %-16s : %4ld allocation(s), %9lu bytes in use, peak %9lu bytes\t\n", 
+        "total", pTotal->nCount, (unsigned long) pTotal->nBytes, (unsigned long) pTotal->nPeak );
+    if ( nUncharged > 0 )
+        sprintf( cMessage + strlen( cMessage ), "[mem]  <wrn> %ld allocation(s) not charged, more than %d modules or %d allocations in use\t\n", 
+            nUncharged, ALLOC_MODULES, ALLOC_LIVE );
+
+    alloc_unlock( );
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+  end allocaudit.c
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,136 @@
+/* ---------------------------------------------------------------------------------
+ *          file : allocaudit.h                                                   *
+ *   description : C-header file, counting hook for heap allocations              *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _ALLOCAUDIT_H_
+#define _ALLOCAUDIT_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup suplib 
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup allocaudit Allocation audit
+
+    The controller does not use the heap after initialization: every call with
+    #MCU_STATUS_RUN must complete without a single allocation or release, since
+    a heap operation in the control loop causes latency spikes and fragments the
+    heap of a PLC over months of uptime.
+
+    When compiled with DOTXALLOCAUDIT, calloc, malloc, realloc and free are
+    routed through counting functions which record the call site. The number of
+    heap operations of the calling thread is returned by alloc_count(), and a
+    hook installed with alloc_sethook() is called for every operation. The MCU
+    reports an error naming the offending call site for every run sample which
+    touched the heap (see mcu_instance_step()).
+
+    The operations are also charged to the module set with #DotxAllocModule by
+    the calling thread. For every module the number of allocations, the bytes
+    in use and the peak of the bytes in use are kept for the whole process, 
+    the MCU appends them to the message of the initialization with 
+    alloc_report(). Memory allocated outside alloc_module() is not charged.
+
+    Without DOTXALLOCAUDIT this header expands to nothing.
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  allocaudit.h
+    \brief This header file contains the counting hook for heap allocations.
+*/
+#endif
+
+#ifdef DOTXALLOCAUDIT
+
+#include <stdlib.h>
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+//! Function called for every heap operation, size is zero for a release.
+typedef void (*alloc_hook)( const char * file, const int line, const size_t size );
+
+#define ALLOC_MODULES   16      //!< Maximum number of modules in the memory report.
+#define ALLOC_LIVE      1024    //!< Maximum number of charged allocations in use at the same time.
+
+#define DotxAllocModule(cName)  alloc_module(cName)    //!< Charge the heap operations of the calling thread to a module.
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+void * alloc_calloc ( size_t n, size_t size, const char * file, const int line ); //!< Counting replacement of calloc.
+void * alloc_malloc ( size_t size, const char * file, const int line );           //!< Counting replacement of malloc.
+void * alloc_realloc( void * ptr, size_t size, const char * file, const int line ); //!< Counting replacement of realloc.
+void   alloc_free   ( void * ptr, const char * file, const int line );            //!< Counting replacement of free.
+void   alloc_other  ( void * ptr, size_t size, const char * file, const int line ); //!< Count memory of another allocator, e.g. aligned memory, size is zero for a release.
+
+//! Number of heap operations (allocations and releases) of the calling thread.
+long alloc_count( void );
+
+//! Reset the number of heap operations of the calling thread to zero.
+void alloc_reset( void );
+
+//! Call site of the last heap operation of the calling thread.
+/*!
+    \param line     [out]   Line number of the call site.
+    \return         The file name of the call site, an empty string if no operation took place.
+*/
+const char * alloc_site( int * line );
+
+//! Install a hook which is called for every heap operation, NULL removes the hook.
+/*!
+    \param hook     [in]    The new hook.
+    \return         The previous hook.
+*/
+alloc_hook alloc_sethook( alloc_hook hook );
+
+//! Charge the heap operations of the calling thread to a module of the memory report.
+/*!
+    \param cName    [in]    Name of the module, a string constant. NULL stops the charging.
+    \return         The module of the calling thread before the call, to restore it.
+*/
+const char * alloc_module( const char * cName );
+
+//! Append the memory per module to a message.
+/*!
+    Appends a line per module with the number of allocations, the bytes in 
+    use and the peak of the bytes in use since the start of the process, and
+    a line with the totals.
+
+    \param cMessage [in+out]    The message.
+*/
+void alloc_report( char * cMessage );
+
+#endif
+
+/* Route all heap operations of the controller through the counting functions, 
+   host programs (_DOTX_HOST_, see staticmem.h) are not audited */
+#if !defined(_ALLOCAUDIT_C_) && !defined(_DOTX_HOST_)
+#define calloc(n,s)     alloc_calloc ( (n), (s), __FILE__, __LINE__ )
+#define malloc(s)       alloc_malloc ( (s),      __FILE__, __LINE__ )
+#define realloc(p,s)    alloc_realloc( (p), (s), __FILE__, __LINE__ )
+#define free(p)         alloc_free   ( (p),      __FILE__, __LINE__ )
+#endif
+
+#else
+
+// No audit, expand to nothing
+#define DotxAllocModule(cName)
+
+#endif
+
+/** @}*/
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _ALLOCAUDIT_H_
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,38 @@
+/* ---------------------------------------------------------------------------------
+ *          file : arena.c                                                        *
+ *   description : C-source file, objects carved from one contiguous block        *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#include "./../signals/signal_definitions_internal.h"
+
+#include "./arena.h"
+
+/* ---------------------------------------------------------------------------------
+ Carve the next object
+--------------------------------------------------------------------------------- */
+void * arena_carve( mem_arena * a, const size_t nBytes )
+{
+    char * p = NULL;
+
+    if ( a->pBase != NULL && a->nUsed + nBytes <= a->nSize ) p = a->pBase + a->nUsed;
+
+    a->nUsed += ARENA_SIZE( nBytes );
+
+    return p;
+}
+
+/* ---------------------------------------------------------------------------------
+ Carve the next object on a cache line
+--------------------------------------------------------------------------------- */
+void * arena_carve_line( mem_arena * a, const size_t nBytes )
+{
+    a->nUsed = ( a->nUsed + PLAT_CACHELINE - 1 ) & ~(size_t)( PLAT_CACHELINE - 1 );
+
+    return arena_carve( a, nBytes );
+}
+
+/* ---------------------------------------------------------------------------------
+  end arena.c
+--------------------------------------------------------------------------------- */
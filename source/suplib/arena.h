@@ -0,0 +1,107 @@
+/* ---------------------------------------------------------------------------------
+ *          file : arena.h                                                        *
+ *   description : C-header file, objects carved from one contiguous block        *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup suplib
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup arena Arena
+
+    An arena is one contiguous block of memory from which objects are carved
+    in order, instead of allocating each of them on the heap. The objects of
+    a data struct then lie next to each other in the order in which they are
+    carved, which is chosen to be the order in which a sample accesses them.
+
+    The carve functions of the support library, e.g. mat_carve() and
+    filter_carve(), only assign the pointers and dimensions of the object and
+    leave its data as it is. Carving the same objects in the same order again
+    on a byte copy of the arena therefore restores all pointers of the copy,
+    which makes copying the data struct a single memcpy followed by the carve
+    pass, see mcu_checkpoint().
+
+    An arena without memory (pBase is NULL) only counts the bytes, which gives
+    the size of the arena to allocate.
+
+    The data structs of the modules of a controller instance are carved from
+    one arena per instance as well, each of them on its own cache lines, see
+    arena_carve_line(). The instance releases them all with one call at its
+    exit.
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  arena.h
+    \brief This header file contains the arena of contiguously carved objects.
+*/
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+#include <stddef.h>
+
+#define ARENA_ALIGN     8   //!< Alignment of every carved object [bytes], suffices for REAL, long and pointers.
+
+//! Bytes which an object of nBytes takes from an arena.
+#define ARENA_SIZE( nBytes )    ( ( (size_t)(nBytes) + ARENA_ALIGN - 1 ) & ~(size_t)( ARENA_ALIGN - 1 ) )
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_STRUCTS
+
+/*! \struct mem_arena
+    \brief  A block of memory from which objects are carved in order.
+ */
+typedef struct mem_arena {
+
+    char      * pBase   ;   //!< Start of the block, NULL to only count the bytes.
+    size_t      nSize   ;   //!< Size of the block [bytes].
+    size_t      nUsed   ;   //!< Bytes carved so far, larger than nSize when the block is exhausted.
+
+} mem_arena;
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+//! Carve the next object from an arena.
+/*!
+    \param a        [in+out]    The arena.
+    \param nBytes   [in]        Size of the object [bytes], rounded up to #ARENA_ALIGN.
+    \return         The object, NULL if the arena only counts or is exhausted.
+*/
+void * arena_carve( mem_arena * a, const size_t nBytes );
+
+//! Carve the next object from an arena, starting on a cache line.
+/*!
+    The object starts on a cache line when the arena does, e.g. a block of 
+    plat_aligned_calloc(). The bytes in front of it are skipped.
+
+    \param a        [in+out]    The arena.
+    \param nBytes   [in]        Size of the object [bytes].
+    \return         The object, NULL if the arena only counts or is exhausted.
+*/
+void * arena_carve_line( mem_arena * a, const size_t nBytes );
+
+#endif
+
+/** @}*/
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _ARENA_H_
+--------------------------------------------------------------------------------- */
@@ -65,18 +65,18 @@ bicu_mesh * bicu_loaddata( char* dir, char* type, int* loaderr )
     	*loaderr = INFODAT;
     	return NULL;
     }
-    fscanf( fid, "%lf" , &Nxd );
-    fscanf( fid, "%lf" , &Nyd );
+    fscanf( fid, R_FMT, &Nxd );
+    fscanf( fid, R_FMT, &Nyd );
     
     Nx = (int)Nxd;
     Ny = (int)Nyd;
     
     mesh = bicu_initmesh( Nx, Ny ); // Init mesh struct based on info
     
-    fscanf( fid, "%lf" , mesh->r   );
-    fscanf( fid, "%lf" , mesh->r+1 );
-    fscanf( fid, "%lf" , mesh->r+2 );
-    fscanf( fid, "%lf" , mesh->r+3 );
+    fscanf( fid, R_FMT, mesh->r   );
+    fscanf( fid, R_FMT, mesh->r+1 );
+    fscanf( fid, R_FMT, mesh->r+2 );
+    fscanf( fid, R_FMT, mesh->r+3 );
     
     fclose(fid);    
     
@@ -93,7 +93,7 @@ bicu_mesh * bicu_loaddata( char* dir, char* type, int* loaderr )
     	return mesh;
     }
     for ( k = 0 ; k < Nx*Ny; ++k ) 
-        fscanf( fid, "%lf %lf\n", mesh->n1+k, mesh->n2+k );
+        fscanf( fid, R_FMT " " R_FMT "\n", mesh->n1+k, mesh->n2+k );
     fclose(fid);    
 
 
@@ -138,7 +138,7 @@ bicu_mesh * bicu_loaddata( char* dir, char* type, int* loaderr )
     {
         for (j = 0; j <  16; ++j ) 
         {
-            fscanf( fid, "%lf ", &temp );
+            fscanf( fid, R_FMT " ", &temp );
             mesh->coef[ j + 16*k ] = temp;  
         }
     }
@@ -176,8 +176,8 @@ int bicu_findelement(   const bicu_mesh * mesh, // IN
                         int * ei )              // OUT  index of the desired element.
 {
 
-    int ix = (int) floor( ( x - mesh->r[0] ) / ( mesh->r[1] - mesh->r[0] ) * ( mesh->Nx-1.0 ) + 1 ); // Matlab index
-    int iy = (int) floor( ( y - mesh->r[2] ) / ( mesh->r[3] - mesh->r[2] ) * ( mesh->Ny-1.0 ) + 1 ); // Matlab index
+    int ix = (int) R_FLOOR( ( x - mesh->r[0] ) / ( mesh->r[1] - mesh->r[0] ) * ( mesh->Nx-R_(1.0) ) + 1 ); // Matlab index
+    int iy = (int) R_FLOOR( ( y - mesh->r[2] ) / ( mesh->r[3] - mesh->r[2] ) * ( mesh->Ny-R_(1.0) ) + 1 ); // Matlab index
     
     int index_node = ix + mesh->Nx * (iy-1) -1; // The second -1 is for Matlab to C index
     
@@ -246,8 +246,8 @@ int bicubic_interp( const bicu_mesh * mesh, // IN
         x_vec[ i+3 ]  = x3;
         dx_vec[ i   ] = 0.0;
         dx_vec[ i+1 ] = 1.0;
-        dx_vec[ i+2 ] = 2.0*xl;
-        dx_vec[ i+3 ] = 3.0*x2;
+        dx_vec[ i+2 ] = R_(2.0)*xl;
+        dx_vec[ i+3 ] = R_(3.0)*x2;
     }
     
     for ( i = 0; i < 4; i++ ) 
@@ -258,8 +258,8 @@ int bicubic_interp( const bicu_mesh * mesh, // IN
         y_vec[ i+12 ]  = y3;
         dy_vec[ i    ] = 0.0;
         dy_vec[ i+4  ] = 1.0;
-        dy_vec[ i+8  ] = 2.0*yl;
-        dy_vec[ i+12 ] = 3.0*y2;
+        dy_vec[ i+8  ] = R_(2.0)*yl;
+        dy_vec[ i+12 ] = R_(3.0)*y2;
     }
     
     *z      = 0.0;
@@ -0,0 +1,267 @@
+/* ---------------------------------------------------------------------------------
+ *          file : checkpoint.c                                                   *
+ *   description : C-source file, binary checkpoint of the controller state       *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "./../signals/signal_definitions_internal.h"
+
+#include "./matrix.h"
+#include "./system.h"
+#include "./filter.h"
+#include "./pid.h"
+#include "./hp_pid.h"
+#include "./checkpoint.h"
+
+
+/* ---------------------------------------------------------------------------------
+ Start a stream on a buffer
+--------------------------------------------------------------------------------- */
+void ckpt_open( ckpt_stream * s, void * pData, const size_t nSize, const int iMode )
+{
+    s->pData  = (unsigned char*) pData;
+    s->nSize  = ( pData != NULL ) ? nSize : 0;
+    s->nPos   = 0;
+    s->iMode  = iMode;
+    s->iError = MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer raw bytes
+--------------------------------------------------------------------------------- */
+int ckpt_bytes( ckpt_stream * s, void * pData, const size_t nBytes )
+{
+    /* Without a buffer, a save only counts the size */
+    if ( s->pData == NULL && s->iMode == CKPT_SAVE ) {
+        s->nPos += nBytes;
+        return MCU_OK;
+    }
+
+    if ( s->nPos + nBytes > s->nSize ) {
+        s->iError++;
+        return MCU_ERR;
+    }
+
+    switch ( s->iMode ) {
+        case CKPT_SAVE    : { memcpy( s->pData + s->nPos, pData, nBytes ); break; }
+        case CKPT_RESTORE : { memcpy( pData, s->pData + s->nPos, nBytes ); break; }
+        default           : break;
+    }
+    s->nPos += nBytes;
+
+    return MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer an integer, a long and REAL values
+--------------------------------------------------------------------------------- */
+int ckpt_int( ckpt_stream * s, int * iData )
+{
+    return ckpt_bytes( s, iData, sizeof(int) );
+}
+
+int ckpt_long( ckpt_stream * s, long * lData )
+{
+    return ckpt_bytes( s, lData, sizeof(long) );
+}
+
+int ckpt_real( ckpt_stream * s, REAL * dData, const int N )
+{
+    return ( N > 0 ) ? ckpt_bytes( s, dData, (size_t)N * sizeof(REAL) ) : MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer an integer which describes the layout, it is also read when verifying
+--------------------------------------------------------------------------------- */
+static int ckpt_layout( ckpt_stream * s, int * iData )
+{
+    if ( s->iMode == CKPT_SAVE ) return ckpt_bytes( s, iData, sizeof(int) );
+
+    if ( s->nPos + sizeof(int) > s->nSize ) {
+        s->iError++;
+        return MCU_ERR;
+    }
+    memcpy( iData, s->pData + s->nPos, sizeof(int) );
+    s->nPos += sizeof(int);
+
+    return MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Check that an integer equals the saved value
+--------------------------------------------------------------------------------- */
+int ckpt_check( ckpt_stream * s, const int iValue )
+{
+    /* A local copy, the value itself is never overwritten */
+    int iSaved = iValue;
+
+    if ( ckpt_layout( s, &iSaved ) > MCU_OK ) return MCU_ERR;
+
+    if ( iSaved != iValue ) {
+        s->iError++;
+        return MCU_ERR;
+    }
+    return MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer a matrix
+--------------------------------------------------------------------------------- */
+int ckpt_matrix( ckpt_stream * s, matrix * mat )
+{
+    int iError = MCU_OK;
+
+    iError += ckpt_check( s, mat->M );
+    iError += ckpt_check( s, mat->N );
+
+    /* Different dimensions: the data can not be located */
+    if ( iError > MCU_OK ) return iError;
+
+    return ckpt_real( s, mat->Mat, mat->M * mat->N );
+}
+
+int ckpt_matrix_alloc( ckpt_stream * s, matrix * mat )
+{
+    int M = mat->M, N = mat->N;
+    int iError = MCU_OK;
+
+    iError += ckpt_layout( s, &M );
+    iError += ckpt_layout( s, &N );
+    if ( iError > MCU_OK ) return iError;
+
+    if ( M < 0 || N < 0 ) {
+        s->iError++;
+        return MCU_ERR;
+    }
+
+    /* Skip the data when verifying, a restore allocates the saved size */
+    if ( s->iMode == CKPT_VERIFY ) return ckpt_bytes( s, NULL, (size_t)M * N * sizeof(REAL) );
+
+    if ( s->iMode == CKPT_RESTORE && ( M != mat->M || N != mat->N || mat->Mat == NULL ) ) {
+        REAL * pNew = ( M*N > 0 ) ? (REAL*) realloc( mat->Mat, (size_t)M * N * sizeof(REAL) ) : NULL;
+        if ( M*N > 0 && pNew == NULL ) { s->iError++; return MCU_ERR; }
+        if ( M*N == 0 ) free( mat->Mat );
+        mat->Mat = pNew;
+        mat->M   = M;
+        mat->N   = N;
+    }
+
+    return ckpt_real( s, mat->Mat, M * N );
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer a state space system
+--------------------------------------------------------------------------------- */
+int ckpt_system( ckpt_stream * s, System * sys )
+{
+    int iError = MCU_OK;
+
+    iError += ckpt_check ( s, sys->Nstate );
+    iError += ckpt_check ( s, sys->Nin    );
+    iError += ckpt_check ( s, sys->Nout   );
+    iError += ckpt_matrix( s, sys->A      );
+    iError += ckpt_matrix( s, sys->B      );
+    iError += ckpt_matrix( s, sys->C      );
+    iError += ckpt_matrix( s, sys->D      );
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer a filter, including the transfer function as the variable frequency
+ filters change it during the run
+--------------------------------------------------------------------------------- */
+int ckpt_filter( ckpt_stream * s, Filter * filt )
+{
+    int iError = MCU_OK;
+
+    iError += ckpt_real  ( s, filt->num  , FILTER_NCOEF           );
+    iError += ckpt_real  ( s, filt->den  , FILTER_NCOEF           );
+    iError += ckpt_real  ( s, filt->b    , FILTER_NCOEF           );
+    iError += ckpt_real  ( s, filt->a    , FILTER_NCOEF-1         );
+    iError += ckpt_real  ( s, filt->state, FILTER_NINTERNALSTATES );
+    iError += ckpt_real  ( s, &filt->Ts, 1  );
+    iError += ckpt_real  ( s, &filt->w0, 1  );
+    iError += ckpt_int   ( s, &filt->active );
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer a block average
+--------------------------------------------------------------------------------- */
+int ckpt_blockavr( ckpt_stream * s, BlockAvr * blockavr )
+{
+    int iError = MCU_OK;
+
+    iError += ckpt_check( s, blockavr->length );
+    if ( iError > MCU_OK ) return iError;
+
+    iError += ckpt_real( s, blockavr->array, blockavr->length );
+    iError += ckpt_int ( s, &blockavr->index );
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer a PID controller
+--------------------------------------------------------------------------------- */
+int ckpt_pid( ckpt_stream * s, PID * controller )
+{
+    int iError = MCU_OK;
+
+    iError += ckpt_matrix( s, controller->gains        );
+    iError += ckpt_matrix( s, controller->constraints  );
+    iError += ckpt_real  ( s, &controller->Ts, 1       );
+    iError += ckpt_matrix( s, controller->state        );
+    iError += ckpt_matrix( s, controller->ulast        );
+    iError += ckpt_matrix( s, controller->dulast       );
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Transfer a HP-PID controller
+--------------------------------------------------------------------------------- */
+int ckpt_hppid( ckpt_stream * s, HP_PID * hppid )
+{
+    int iError = MCU_OK;
+
+    iError += ckpt_pid ( s, hppid->pid                      );
+    iError += ckpt_check( s, hppid->ndelay                  );
+    if ( iError > MCU_OK ) return iError;
+    iError += ckpt_real( s, hppid->delayvec, hppid->ndelay  );
+    iError += ckpt_int ( s, &hppid->index                   );
+    iError += ckpt_int ( s, &hppid->active                  );
+    iError += ckpt_real( s, &hppid->modelA, 1               );
+    iError += ckpt_real( s, &hppid->modelB, 1               );
+    iError += ckpt_real( s, &hppid->lpconstant, 1           );
+    iError += ckpt_real( s, &hppid->lpstate, 1              );
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+ Checksum of a block of data
+--------------------------------------------------------------------------------- */
+unsigned int ckpt_checksum( const void * pData, const size_t nBytes )
+{
+    const unsigned char * p = (const unsigned char*) pData;
+    unsigned int h = 2166136261U;
+    size_t k;
+
+    for ( k = 0; k < nBytes; ++k ) {
+        h ^= p[k];
+        h *= 16777619U;
+    }
+
+    return h;
+}
+
+/* ---------------------------------------------------------------------------------
+  end checkpoint.c
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,145 @@
+/* ---------------------------------------------------------------------------------
+ *          file : checkpoint.h                                                   *
+ *   description : C-header file, binary checkpoint of the controller state       *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup suplib
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup checkpoint Checkpoints
+
+    A checkpoint is a binary copy of the complete run-time state of a
+    controller: filter states, PID internals, block averages, set points,
+    supervisory state, sample counters, etc. Restoring it continues the
+    controller bit-exactly where it was saved, e.g. after a warm restart of
+    the PLC, or from a saved operating point of a simulation.
+
+    The same function transfers an object in both directions, depending on
+    the mode of the #ckpt_stream, so the layout of the save and the restore
+    can not diverge. Each data struct module has one function which transfers
+    its dynamic struct, e.g. mcu_checkpoint(). The parameters are not part of
+    the checkpoint: it is restored into a controller which has been
+    initialized with the same parameter files. The dimensions of all matrices
+    are stored and checked, a checkpoint which does not fit is rejected.
+
+    A restore is done in two passes. The #CKPT_VERIFY pass reads the complete
+    checkpoint and checks the dimensions without modifying anything; only if
+    it succeeds the #CKPT_RESTORE pass copies the data, so a rejected
+    checkpoint leaves the controller untouched.
+
+    The REAL values are stored as their bit pattern, a checkpoint can only be
+    restored by a build with the same precision and byte order.
+
+    \sa mcu_instance_save(), mcu_instance_restore()
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  checkpoint.h
+    \brief This header file contains the functions to save and restore the controller state.
+*/
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+#define CKPT_MAGIC      "DOTXCKPT"      //!< First bytes of a checkpoint.
+#define CKPT_VERSION    6               //!< Version of the layout, incremented when the dynamic data structs change.
+
+//! Direction of a #ckpt_stream.
+enum ckpt_modes {
+    CKPT_SAVE       ,   //!< Copy the objects to the buffer, with a NULL buffer only the size is counted.
+    CKPT_VERIFY     ,   //!< Read the buffer and check the dimensions, without modifying the objects.
+    CKPT_RESTORE        //!< Copy the buffer to the objects.
+};
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_STRUCTS
+
+/*! \struct ckpt_stream
+    \brief  Buffer of a checkpoint and the position in it.
+ */
+typedef struct ckpt_stream {
+
+    unsigned char * pData       ;   //!< The buffer, NULL to count the size of a checkpoint.
+    size_t          nSize       ;   //!< Size of the buffer [bytes].
+    size_t          nPos        ;   //!< Number of bytes transferred.
+    int             iMode       ;   //!< Direction, see #ckpt_modes.
+    int             iError      ;   //!< Number of errors: buffer too small or dimensions which do not match.
+
+} ckpt_stream;
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+//! Start a stream on a buffer.
+/*!
+    \param s        [out]   The stream.
+    \param pData    [in]    The buffer, NULL with #CKPT_SAVE to count the size.
+    \param nSize    [in]    Size of the buffer [bytes].
+    \param iMode    [in]    Direction, see #ckpt_modes.
+*/
+void ckpt_open( ckpt_stream * s, void * pData, const size_t nSize, const int iMode );
+
+//! Transfer raw bytes.
+int ckpt_bytes( ckpt_stream * s, void * pData, const size_t nBytes );
+
+//! Transfer an integer.
+int ckpt_int( ckpt_stream * s, int * iData );
+
+//! Transfer a long integer.
+int ckpt_long( ckpt_stream * s, long * lData );
+
+//! Transfer an array of N REAL values.
+int ckpt_real( ckpt_stream * s, REAL * dData, const int N );
+
+//! Check that an integer, e.g. a dimension, equals the saved value.
+int ckpt_check( ckpt_stream * s, const int iValue );
+
+//! Transfer a matrix, its dimensions must equal the saved ones.
+int ckpt_matrix( ckpt_stream * s, matrix * mat );
+
+//! Transfer a matrix of which the size is set at run time, its data is reallocated at the restore.
+int ckpt_matrix_alloc( ckpt_stream * s, matrix * mat );
+
+//! Transfer a state space system.
+int ckpt_system( ckpt_stream * s, System * sys );
+
+//! Transfer a filter: transfer function, coefficients, state and settings.
+int ckpt_filter( ckpt_stream * s, Filter * filt );
+
+//! Transfer a block average: its buffer and index.
+int ckpt_blockavr( ckpt_stream * s, BlockAvr * blockavr );
+
+//! Transfer a PID controller: gains, constraints, state, ulast and dulast.
+int ckpt_pid( ckpt_stream * s, PID * controller );
+
+//! Transfer a HP-PID controller: its PID, delay vector, model and lowpass state.
+int ckpt_hppid( ckpt_stream * s, HP_PID * hppid );
+
+//! Checksum of a block of data (32 bit FNV-1a).
+unsigned int ckpt_checksum( const void * pData, const size_t nBytes );
+
+#endif
+
+/** @}*/
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _CHECKPOINT_H_
+--------------------------------------------------------------------------------- */
@@ -4,23 +4,11 @@
 
 #ifndef _MITA_EXPORT_
 
-#define _WIN32_WINNT    0x0500
-#define _WIN32_IE       0x0500
-#define CSIDL_MYMUSIC   0x000D
-#define CSIDL_MYVIDEO   0x000E
-#include <windows.h>
-#include <shlobj.h>
+#include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 
-//http://stackoverflow.com/questions/17933917/get-the-users-desktop-folder-using-windows-api
-char* desktop_directory()
-{
-	static char path[MAX_PATH+1];
-	if (SHGetSpecialFolderPathA(HWND_DESKTOP, path, CSIDL_DESKTOPDIRECTORY, FALSE))
-		return path;
-	else
-		return "ERROR";
-}
+#include "./../signals/signal_definitions_internal.h"
 
 void DotxInternalDebug( const char *file, const char *function, const int line, const char *format, ... )
 {
@@ -28,14 +16,14 @@ void DotxInternalDebug( const char *file, const char *function, const int line,
 	va_list ap;
 	static FILE * dotxfid = NULL;
 	static istatus = 0;
-	static char path[MAX_PATH+1];
+	static char path[FILENAMESIZE];
 
 	if (istatus == 0)
 	{
 		if ( dotxfid == NULL )
 		{
-			strcpy(path, desktop_directory());
-			strcat(path,"\\dotxdebug.txt");
+			plat_folder(PLAT_FOLDER_DESKTOP, path, FILENAMESIZE - 16);
+			strcat(path, PLAT_PATHSEP "dotxdebug.txt");
 			dotxfid = fopen( path, "w+" );
 		}
 		if ( dotxfid != NULL )
@@ -0,0 +1,64 @@
+/* ---------------------------------------------------------------------------------
+ *          file : fastmath.c                                                     *
+ *   description : C-source file, bounded-error math kernels of the control loop  *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#include <math.h>
+
+#include "./../signals/signal_definitions_internal.h"
+
+#include "./fastmath.h"
+
+
+/* pi/2 in two parts, PIO2_HI is exact in REAL */
+#ifdef FLOATPRECISION
+#define PIO2_HI     R_(1.57079637050628662109375)
+#define PIO2_LO     R_(-4.37113900018624283e-8)
+#else
+#define PIO2_HI     R_(1.5707963267948965579989817)
+#define PIO2_LO     R_(6.12323399573676603587e-17)
+#endif
+
+#define PIO4        R_(0.78539816339744830962)
+
+/* ---------------------------------------------------------------------------------
+ Tangent over |x| <= pi/4, Pade approximant of the continued fraction, or its
+ inverse
+--------------------------------------------------------------------------------- */
+static REAL fm_tan_kernel( const REAL x, const int bInverse )
+{
+    const REAL y = x * x;
+
+#ifdef FLOATPRECISION
+    const REAL P = R_(1.0) + y * ( R_(-1.0/9.0) + y *   R_(1.0/945.0) );
+    const REAL Q = R_(1.0) + y * ( R_(-4.0/9.0) + y *   R_(1.0/63.0)  );
+#else
+    const REAL P = R_(1.0) + y * ( R_(-7.0/51.0) + y * ( R_(1.0/255.0) + y * ( R_(-2.0/69615.0) + y * R_(1.0/34459425.0) ) ) );
+    const REAL Q = R_(1.0) + y * ( R_(-8.0/17.0) + y * ( R_(7.0/255.0) + y * ( R_(-4.0/9945.0)  + y * R_(1.0/765765.0)   ) ) );
+#endif
+
+    return bInverse ? Q / ( x * P ) : x * P / Q;
+}
+
+/* ---------------------------------------------------------------------------------
+ Tangent for arguments in (-pi/2, pi/2)
+--------------------------------------------------------------------------------- */
+REAL fm_tan( const REAL x )
+{
+    const REAL a = ABS( x );
+
+    if ( a <= PIO4 ) return fm_tan_kernel( x, FALSE );
+
+    /* Outside the domain of the kernels */
+    if ( !( a < PIO2_HI ) ) return R_TAN( x );
+
+    /* tan(x) = 1/tan(pi/2-x) */
+    if ( x > R_(0.0) ) return  fm_tan_kernel( ( PIO2_HI - a ) + PIO2_LO, TRUE );
+    else               return -fm_tan_kernel( ( PIO2_HI - a ) + PIO2_LO, TRUE );
+}
+
+/* ---------------------------------------------------------------------------------
+  end fastmath.c
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,87 @@
+/* ---------------------------------------------------------------------------------
+ *          file : fastmath.h                                                     *
+ *   description : C-header file, bounded-error math kernels of the control loop  *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _FASTMATH_H_
+#define _FASTMATH_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup suplib
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup fastmath Fast math kernels
+
+    The math library evaluates the transcendental functions correctly rounded
+    over their complete domain, which is expensive on the FPU of a PLC. The
+    kernels in this module only cover the domain in which the controller uses
+    them and have a documented maximum error, which is far below the noise on
+    the measurements.
+
+    The only transcendental function in the run samples is the tangent of the
+    prewarp of the variable frequency notch filters in discreteSISO(), which
+    is evaluated for every filter in every sample. The prewarp argument
+    w0*Ts/2 lies between 0 and pi/2 for any frequency below the Nyquist
+    frequency.
+
+    The code calls the kernels through the FM_ macros. When compiled with
+    DOTXLIBM the macros call the math library instead.
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  fastmath.h
+    \brief This header file contains the bounded-error math kernels of the control loop.
+*/
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+#ifdef DOTXLIBM
+#define FM_TAN(x)   R_TAN(x)        //!< Tangent, see fm_tan().
+#else
+#define FM_TAN(x)   fm_tan(x)       //!< Tangent, see fm_tan().
+#endif
+
+#define FM_TAN_ULP  3.5             //!< Maximum error of fm_tan() over (-pi/2, pi/2) [ulp], verified by fastmath_check.c.
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+//! Tangent for arguments in (-pi/2, pi/2).
+/*!
+    A Pade approximant of the continued fraction of the tangent, of order
+    [9/8] in double and [5/4] in single precision, over |x| <= pi/4. For
+    pi/4 < |x| < pi/2 the function returns 1/tan(pi/2-|x|), with pi/2 split
+    in two parts to keep the reduced argument accurate. Outside (-pi/2, pi/2)
+    the math library is called.
+
+    The maximum error over (-pi/2, pi/2), including the rounding of the
+    evaluation, is #FM_TAN_ULP (3.5) ulp: a relative error of 5e-16 in double
+    and 4e-7 in single precision. The math library is correct to within 1.2 
+    ulp. The bound is checked in both precisions by the target fastmath_check
+    of make_linux.mk.
+
+    \param x        [in]    Argument [rad].
+    \return         tan(x).
+*/
+REAL fm_tan( const REAL x );
+
+#endif
+
+/** @}*/
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _FASTMATH_H_
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,93 @@
+/* ---------------------------------------------------------------------------------
+ *          file : fastmath_check.c                                               *
+ *   description : C-source file, error sweep of the fast math kernels            *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#define _DOTX_HOST_     // Host of the controller: keeps the heap of the process, see staticmem.h
+
+#include <math.h>
+#include <float.h>
+
+#include "./../signals/signal_definitions_internal.h"
+
+#include "./fastmath.h"
+
+/* The reference is evaluated in long double, which needs more digits than REAL */
+#if LDBL_MANT_DIG <= DBL_MANT_DIG && !defined(FLOATPRECISION)
+#error "fastmath_check needs a long double with more precision than double"
+#endif
+
+#ifdef FLOATPRECISION
+#define FM_MANT     FLT_MANT_DIG
+#else
+#define FM_MANT     DBL_MANT_DIG
+#endif
+
+#define FM_PIO2     1.57079632679489661923132169163975144L
+
+/* Worst case of a sweep */
+typedef struct fm_worst {
+    double  dUlp    ;
+    REAL    x       ;
+} fm_worst;
+
+/* ---------------------------------------------------------------------------------
+ Error of a single argument in ulp of the exact result
+--------------------------------------------------------------------------------- */
+static void fm_check_tan( const REAL x, fm_worst * kernel, fm_worst * libm )
+{
+    long double t, ulp;
+    double      e;
+
+    if ( !( fabsl( (long double)x ) < FM_PIO2 ) || x == R_(0.0) ) return;
+
+    t   = tanl( (long double)x );
+    ulp = ldexpl( 1.0L, ilogbl( t ) - ( FM_MANT - 1 ) );
+
+    e = (double) fabsl( ( (long double)fm_tan( x ) - t ) / ulp );
+    if ( e > kernel->dUlp ) { kernel->dUlp = e; kernel->x = x; }
+
+    e = (double) fabsl( ( (long double)R_TAN( x ) - t ) / ulp );
+    if ( e > libm->dUlp ) { libm->dUlp = e; libm->x = x; }
+}
+
+/* ---------------------------------------------------------------------------------
+ Sweep fm_tan over (-pi/2, pi/2): a uniform grid, and geometric grids towards zero
+ and towards the poles, where the relative spacing of the arguments is smallest
+--------------------------------------------------------------------------------- */
+int main( int argc, char ** argv )
+{
+    long        i, n = ( argc > 1 ) ? atol( argv[1] ) : 10000000L;
+    int         k, s;
+    REAL        x;
+    fm_worst    kernel = { 0.0, R_(0.0) }, libm = { 0.0, R_(0.0) };
+
+    for ( i = -n; i <= n; ++i )
+        fm_check_tan( (REAL)( (long double)i / (long double)n * FM_PIO2 ), &kernel, &libm );
+
+    for ( s = -1; s <= 1; s += 2 ) {
+        for ( k = 1; k < FM_MANT + 8; ++k ) {
+            for ( i = 0; i < 64; ++i ) {
+                long double d = ldexpl( 1.0L + (long double)i / 64.0L, -k );
+                fm_check_tan( (REAL)( s * d ), &kernel, &libm );
+                x = (REAL)( s * ( FM_PIO2 - d ) );
+                fm_check_tan( x, &kernel, &libm );
+                fm_check_tan( (REAL)nextafterl( (long double)x, s * FM_PIO2 ), &kernel, &libm );
+            }
+        }
+    }
+
+    printf( "[fm]   fm_tan %-6s : max error %.3f ulp at x = %.17g, bound %.1f ulp%s\n", 
+                FM_MANT == DBL_MANT_DIG ? "double" : "float", kernel.dUlp, (double)kernel.x, 
+                FM_TAN_ULP, kernel.dUlp > FM_TAN_ULP ? "  <err>" : "" );
+    printf( "[fm]   libm   %-6s : max error %.3f ulp at x = %.17g\n", 
+                FM_MANT == DBL_MANT_DIG ? "double" : "float", libm.dUlp, (double)libm.x );
+
+    return ( kernel.dUlp > FM_TAN_ULP ) ? 1 : 0;
+}
+
+/* ---------------------------------------------------------------------------------
+  end fastmath_check.c
+--------------------------------------------------------------------------------- */
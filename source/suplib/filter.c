@@ -11,8 +11,9 @@
 #include "./../signals/signal_definitions_internal.h"
 
 #include "./matrix.h"
-#include "./system.h"
 #include "./filter.h"
+#include "./fastmath.h"
+#include "./health.h"
 
 /* ---------------------------------------------------------------------------------
    Memory functions 
@@ -26,33 +27,10 @@ Filter * filter_init(   const matrix * num,  /* [IN] Numerator
                     )
 {
 
-    /* Allocate memory for the struct */
+    /* Allocate memory for the struct, the state starts at zero */
     Filter * new_filter = (Filter*) calloc(1, sizeof(Filter));
     
-    new_filter->num = mat_initCopy( num );
-    new_filter->den = mat_initCopy( den );
-    
-    /* Create a internal state vector, 2 internal states per external state */
-    new_filter->state = mat_initEmpty( FILTER_NINTERNALSTATES, 1 );
-    
-    new_filter->Ts = Ts;
-    new_filter->w0 = w0;
-    
-    /* Initialize the filter system matrices */
-    new_filter->sys = sys_init( FILTER_NINTERNALSTATES, 
-                                FILTER_NINPUTS,
-                                FILTER_NOUTPUTS
-                            );
-                                
-    /* Calculate the value of the filter system matrices */ 
-    discreteSISO(   new_filter->num,    
-                    new_filter->den,    
-                    Ts, 
-                    w0,
-                    new_filter->sys
-                );
-    
-    new_filter->active = 1;
+    filter_setTf_mat( new_filter, num, den, Ts, w0 );
     
     return new_filter;
 }
@@ -63,7 +41,7 @@ BlockAvr * blockavr_init(const REAL time, const REAL Ts)
 	/* Allocate memory for the struct */
 	BlockAvr * new_blockavr = (BlockAvr*) calloc(1, sizeof(BlockAvr));
 
-	new_blockavr->length = (int)ceil(time/Ts);
+	new_blockavr->length = (int)R_CEIL(time/Ts);
 	new_blockavr->array  = (REAL*) calloc(new_blockavr->length, sizeof(REAL));
 	new_blockavr->index  = 0;
 
@@ -77,55 +55,42 @@ Filter * filter_initEmpty( )
     /* Allocate memory for the struct */
     Filter * new_filter = (Filter*) calloc(1, sizeof(Filter));
     
-    new_filter->num = mat_initEmpty( FILTER_NCOEF, 1 );
-    new_filter->den = mat_initEmpty( FILTER_NCOEF, 1 );
-    
-    /* Create a internal state vector, 2 internal states per external state */
-    new_filter->state = mat_initEmpty( FILTER_NINTERNALSTATES, 1 );
-                            
     new_filter->Ts =  R_(EPS);
     new_filter->w0 =  R_(FILTER_NOPREWRAP);
     
-    /* Initialize the filter system matrices */
-    new_filter->sys = sys_init( FILTER_NINTERNALSTATES, 
-                                FILTER_NINPUTS,
-                                FILTER_NOUTPUTS
-                            );
-    
     new_filter->active = 0;
 
     
     return new_filter;
 }
 
+/* Carve a filter from an arena, the filter is a flat struct */
+Filter * filter_carve( mem_arena * a )
+{
+    return (Filter*) arena_carve( a, sizeof(Filter) );
+}
+
+/* Initialize an empty filter carved from an arena of zeroed memory */
+Filter * filter_initArena( mem_arena * a )
+{
+    Filter * new_filter = filter_carve( a );
+
+    if ( new_filter != NULL ) {
+        new_filter->Ts     = R_(EPS);
+        new_filter->w0     = R_(FILTER_NOPREWRAP);
+        new_filter->active = 0;
+    }
+    return new_filter;
+}
+
 /* Initialize the filter by copying another filter */
 Filter * filter_initCopy( const Filter * source ) {
 
     /* Allocate memory for the struct */
     Filter * new_filter = (Filter*) calloc(1, sizeof(Filter));
     
-    new_filter->num = mat_initCopy( source->num );
-    new_filter->den = mat_initCopy( source->den );
-    
-    /* Create a internal state vector, 2 internal states per external state */
-    new_filter->state = mat_initCopy( source->state );
-    
-    new_filter->Ts = source->Ts;
-    new_filter->w0 = source->w0;
-    
-    /* Initialize the filter system matrices */
-    new_filter->sys = sys_init( FILTER_NINTERNALSTATES, 
-                                FILTER_NINPUTS,
-                                FILTER_NOUTPUTS
-                            );
-                                
-    /* Calculate the value of the filter system matrices */ 
-    discreteSISO(   new_filter->num ,   
-                    new_filter->den ,   
-                    new_filter->Ts  , 
-                    new_filter->w0  ,
-                    new_filter->sys
-                );
+    /* The transfer function, the coefficients and the state */
+    *new_filter = *source;
     
     new_filter->active = 1;
     
@@ -136,18 +101,9 @@ Filter * filter_initCopy( const Filter * source ) {
 /* Free the memory of the filter struct */
 int filter_free( Filter * filt )
 {
-
-    int err = MCU_OK;
-    
-    err += mat_free( filt->num   );
-    err += mat_free( filt->den   );
-    err += mat_free( filt->state );
-    
-    err += sys_free( filt->sys   );
-    
 	free( filt );
     
-    return err;
+    return MCU_OK;
 }
 
 // Free block average
@@ -163,66 +119,75 @@ int blockavr_free( BlockAvr * blockavr )
 
 
 /* ---------------------------------------------------------------------------------
-   Function to create a discrete SISO system from a given set of numumerators 
-   and denumerators.
+   Function to create a discrete second-order section from a given set of 
+   numumerators and denumerators.
 --------------------------------------------------------------------------------- */
-int discreteSISO(   const matrix * num , /* [IN]  Numerators [3]    */
-                    const matrix * den , /* [IN]  Denumerators [3]  */
+int discreteSISO(   const REAL   * num , /* [IN]  Numerators [3]    */
+                    const REAL   * den , /* [IN]  Denumerators [3]  */
                     const REAL     Ts  , /* [IN]  Sample time       */
                     const REAL     w0  , /* [IN]  Prewarp frequency */
-                          System * sys   /* [OUT] The output system */  
+                          Filter * filt  /* [OUT] The coefficients  */  
                 )
 {
 
-    int err = MCU_OK;
-    
     /* Define local variables */
-    REAL f, da0, da1, da2, db0, db1, db2, n1, n2, d1, d2;
+    REAL f, da0, db0;
     
     /* Check if prewarp frequency needs to be applied ( w0 < 0 -> do not apply ) */
     if ( w0 < R_(0.0) ) f = R_(2.0) / Ts; 
-    else f = w0 / tan( w0*Ts / R_(2.0) );
+    else f = w0 / FM_TAN( w0*Ts / R_(2.0) );
     
-    /* No filter needs to be applied if n(0) = n(1) = d(0) = d(1) = 0 */
-    if ( ABS( num->Mat[0] ) < R_(EPS) && ABS( num->Mat[1] ) < R_(EPS)  && 
-        ABS( den->Mat[0] ) < R_(EPS) && ABS( den->Mat[1] ) < R_(EPS) ) 
+    /* No filter needs to be applied if n(0) = n(1) = d(0) = d(1) = 0, a pure gain */
+    if ( ABS( num[0] ) < R_(EPS) && ABS( num[1] ) < R_(EPS)  && 
+        ABS( den[0] ) < R_(EPS) && ABS( den[1] ) < R_(EPS) ) 
     {
-        /*  TODO: set other matrices on zero */
-        err += mat_setValue( sys->D, 0, 0, num->Mat[2]/den->Mat[2] );
+        filt->b[0] = num[2]/den[2];
+        filt->b[1] = filt->b[2] = R_(0.0);
+        filt->a[0] = filt->a[1] = R_(0.0);
         
-        return err;
+        return MCU_OK;
     }
     
     /* The filter needs to be proper, if d(0) = d(1) = 0, the function will return
     an error */
-    if ( ABS( den->Mat[0] ) < R_(EPS) && ABS( den->Mat[1] ) < R_(EPS)  ) 
+    if ( ABS( den[0] ) < R_(EPS) && ABS( den[1] ) < R_(EPS)  ) 
         return MCU_ERR;
     
-    /* Determine coefficients of numerical scheme for computing 
-    the system matrices */
-    da0 =          num->Mat[0]*f*f + num->Mat[1]*f +          num->Mat[2];
-    da1 = R_(-2.0)*num->Mat[0]*f*f +                 R_(2.0)*num->Mat[2];
-    da2 =          num->Mat[0]*f*f - num->Mat[1]*f +          num->Mat[2];
-    db0 =          den->Mat[0]*f*f + den->Mat[1]*f +          den->Mat[2];
-    db1 = R_(-2.0)*den->Mat[0]*f*f +                  R_(2.0)*den->Mat[2];
-    db2 =          den->Mat[0]*f*f - den->Mat[1]*f +          den->Mat[2];
-    
-    d1  = db1/db0;
-    d2  = db2/db0;
-    n1  = da1/db0 - d1*da0/db0;
-    n2  = da2/db0 - d2*da0/db0;
-    
-    /* Define the discrete system matrices (A,B,C,D) */
-    REAL arrayA[4] = {  -d1,  -d2, R_(1.0), R_(0.0) };
-    REAL arrayB[2] = { R_(1.0), R_(0.0) };
-    REAL arrayC[2] = { n1, n2 };
-    REAL arrayD[1] = { da0/db0 };
-    err += mat_setArray( sys->A, arrayA, 2, 2 );
-    err += mat_setArray( sys->B, arrayB, 2, 1 );    
-    err += mat_setArray( sys->C, arrayC, 1, 2 );
-    err += mat_setArray( sys->D, arrayD, 1, 1 );
-    
-    return err;
+    da0 = num[0]*f*f + num[1]*f + num[2];
+    db0 = den[0]*f*f + den[1]*f + den[2];
+    
+#ifdef FLOATPRECISION
+    /* Delta form for single precision: the state is updated by increments, s(k+1) = s(k) + A s(k) + B u(k),
+    and a holds the coefficients of the delta operator z-1. At small w0*Ts the poles of the filter lie 
+    close to z = 1, the coefficients of z cancel to within the float resolution while the coefficients 
+    of z-1 are small numbers which are computed without cancellation. */
+    const REAL * N = num, * D = den;
+    REAL R0, R2;
+    
+    /* Numerator of the strictly proper part times db0^2, in which the cross terms N(i)*D(j) - D(i)*N(j) 
+    are exactly zero for equal coefficients (e.g. the notch frequency) */
+    R0 = ( N[0]*D[1] - D[0]*N[1] )*f   + ( N[0]*D[2] - D[0]*N[2] );
+    R2 = ( N[2]*D[0] - D[2]*N[0] )*f*f + ( N[2]*D[1] - D[2]*N[1] )*f;
+    
+    filt->a[0] = ( R_(2.0)*D[1]*f + R_(4.0)*D[2] ) / db0;
+    filt->a[1] = R_(4.0)*D[2] / db0;
+    filt->b[1] = R_(2.0)*( R2 - R0*f*f ) / ( db0*db0 );
+    filt->b[2] = R_(4.0)*R2 / ( db0*db0 );
+#else
+    /* Coefficients of the discrete transfer function normalized by db0, b holds the numerator
+    of the strictly proper part */
+    REAL da1, da2;
+    da1 = R_(-2.0)*num[0]*f*f +                 R_(2.0)*num[2];
+    da2 =          num[0]*f*f - num[1]*f +          num[2];
+    
+    filt->a[0] = ( R_(-2.0)*den[0]*f*f +                 R_(2.0)*den[2] ) / db0;
+    filt->a[1] = (          den[0]*f*f - den[1]*f +          den[2] ) / db0;
+    filt->b[1] = da1/db0 - filt->a[0]*da0/db0;
+    filt->b[2] = da2/db0 - filt->a[1]*da0/db0;
+#endif
+    filt->b[0] = da0/db0;
+    
+    return MCU_OK;
 }
 
 
@@ -231,83 +196,146 @@ int discreteSISO(   const matrix * num , /* [IN]  Numerators [3]    */
    Output functions 
 --------------------------------------------------------------------------------- */  
 
+/* One sample of an active section, the state is updated in place */
+static int filter_section( Filter * filt, const REAL u, REAL * y, const int iStatus )
+{
+    int iError = MCU_OK;
+    REAL * s = filt->state;
+    
+    if ( iStatus == MCU_STATUS_INIT )
+        iError += filter_calcState( filt, u );
+    
+    /* The output of the strictly proper part and the direct feedthrough */
+    const REAL s1 = s[0];
+    *y = ( filt->b[1]*s[0] + filt->b[2]*s[1] ) + filt->b[0]*u;
+    
+#ifdef FLOATPRECISION
+    /* Delta form: s1 += -a1 s1 - a2 s2 + u, s2 += s1 */
+    s[0] += ( -filt->a[0]*s[0] - filt->a[1]*s[1] ) + u;
+    s[1] += s1;
+#else
+    /* Direct form II: s1 = -a1 s1 - a2 s2 + u, s2 = s1 */
+    s[0]  = ( -filt->a[0]*s[0] - filt->a[1]*s[1] ) + u;
+    s[1]  = s1;
+#endif
+    
+    /* A non-finite state is reset to the steady state of the input, or of a zero input */
+    if ( health_guard( s, FILTER_NINTERNALSTATES, HEALTH_FILTER_RESET ) )
+        iError += filter_calcState( filt, isfinite( u ) ? u : R_(0.0) );
+    
+    return iError;
+}
+
 /* Calculate the output of the filter based on the input 
    and internal state of the filter */   
-int filter_output_mat( const Filter * filt, const matrix * input, matrix * output, const int iStatus )
+int filter_output_mat( Filter * filt, const matrix * input, matrix * output, const int iStatus )
 {
+    return filter_output_sca( filt, &input->Mat[0], &output->Mat[0], iStatus );
+}
 
-    if ( !filt->active ) { 
+/* For SISO systems it is useful to have a wrapper with scalar in- and outputs */   
+int filter_output_sca( Filter * filt, const REAL * dInput, REAL * dOutput, 
+                        const int iStatus ) {
     
-        output->Mat[0] = input->Mat[0];
+    /* Exit if not active */
+    if ( !filt->active ) { 
+        *dOutput = *dInput;
         return MCU_OK;
-        
     }
+    
+    return filter_section( filt, *dInput, dOutput, iStatus );
+}
 
+/* Calculate the outputs of a series of filters, only the active filters are executed */
+int filter_chain_output( Filter * const * series, const int nStages, FilterChain * chain, REAL * x,
+                        const int iStatus )
+{
     int iError = MCU_OK;
+    int i, k = 0;
+    unsigned long uMask = 0;
     
-    if ( iStatus == MCU_STATUS_INIT )
-        iError += filter_calcState( filt, input );
-    
-    /* Initialize some local variables */
-    matrix * new_state = mat_initCopy( filt->state );
-    int result;
+    if ( nStages > FILTER_CHAIN_MAX ) return MCU_ERR;
     
-    /* -----------------------------------------------------------------------------
-    Update the state, and set the filter output, by state-space system:
+    /* The active filters, rebuilt at the initialization and whenever a filter is switched on or off */
+    for ( i = 0; i < nStages; ++i )
+        if ( series[i]->active ) uMask |= 1UL << i;
     
-        x(k+1) = A x(k) + B u(k)
-        y(k)   = C x(k) + D u(k)
-    
-    ----------------------------------------------------------------------------- */
-    result = sys_output( filt->sys, filt->state, input, new_state, output );
-    
-    /* Check if the calculation went ok */
-    if( result != 0 ) 
-    { 
-        mat_free( new_state );
-        return iError += MCU_ERR;
+    if ( iStatus == MCU_STATUS_INIT || uMask != chain->uMask ) {
+        chain->uMask   = uMask;
+        chain->nActive = 0;
+        for ( i = 0; i < nStages; ++i )
+            if ( ( uMask >> i ) & 1UL ) chain->iActive[ chain->nActive++ ] = (short) i;
     }
     
-    /* Update the internal state vector */
-    iError += mat_setMatrix( new_state, filt->state );
-    
-    /* Free the temporary vector */
-    iError += mat_free( new_state );    
-    
+    for ( i = 0; i < chain->nActive; ++i ) {
+        
+        /* The inactive filters in front of the next active one pass their input */
+        for ( ; k < chain->iActive[i]; ++k ) x[k+1] = x[k];
+        
+        iError += filter_section( series[k], x[k], &x[k+1], iStatus );
+        ++k;
+    }
+    for ( ; k < nStages; ++k ) x[k+1] = x[k];
     
-    /* Report a succesful computation */
     return iError;
 }
 
-/* For SISO systems it is useful to have a wrapper with scalar in- and outputs */   
-int filter_output_sca( const Filter * filt, const REAL * dInput, REAL * dOutput, 
-                        const int iStatus ) {
-    
-    /* Exit if not active */
-    if ( !filt->active ) { 
-        *dOutput = *dInput;
-        return MCU_OK;
+
+/* Copy a filter into a column of a bank, an inactive filter passes its input */
+void filter_bank_load( FilterBank * bank, const int i, const Filter * filt )
+{
+    if ( filt == NULL || !filt->active ) {
+        
+        bank->b[0][i] = R_(1.0);
+        bank->b[1][i] = bank->b[2][i] = R_(0.0);
+        bank->a[0][i] = bank->a[1][i] = R_(0.0);
+        bank->state[0][i] = bank->state[1][i] = R_(0.0);
+        return;
     }
     
-    /* Initialize local variables */
-
-    int iError = MCU_OK;
-    REAL matrixmem_mInput[1][1];
-    matrix  mInput = mat_stackinit(1, 1, &(matrixmem_mInput[0][0]));
+    bank->b[0][i] = filt->b[0];
+    bank->b[1][i] = filt->b[1];
+    bank->b[2][i] = filt->b[2];
+    bank->a[0][i] = filt->a[0];
+    bank->a[1][i] = filt->a[1];
+    bank->state[0][i] = filt->state[0];
+    bank->state[1][i] = filt->state[1];
+}
 
-    REAL matrixmem_mOutput [1][1];
-    matrix  mOutput  = mat_stackinit( 1, 1, &(matrixmem_mOutput[0][0]));
+/* One sample of all columns, the same operations as filter_section() */
+void filter_bank_output( FilterBank * bank, const int n, const REAL * u, REAL * y )
+{
+    int i;
+    REAL * s1 = bank->state[0], * s2 = bank->state[1];
     
-    /* Convert the scaler input to a matrix */
-    mat_setValue( &mInput, 0, 0, *dInput );
+    for ( i = 0; i < n; ++i ) {
+        
+        const REAL s = s1[i];
+        y[i] = ( bank->b[1][i]*s1[i] + bank->b[2][i]*s2[i] ) + bank->b[0][i]*u[i];
+        
+#ifdef FLOATPRECISION
+        s1[i] += ( -bank->a[0][i]*s1[i] - bank->a[1][i]*s2[i] ) + u[i];
+        s2[i] += s;
+#else
+        s1[i]  = ( -bank->a[0][i]*s1[i] - bank->a[1][i]*s2[i] ) + u[i];
+        s2[i]  = s;
+#endif
+    }
+}
+
+/* Copy the new state of a column back into its filter */
+int filter_bank_store( const FilterBank * bank, const int i, Filter * filt, const REAL u )
+{
+    if ( !filt->active ) return MCU_OK;
     
-    /* Calculate the filter output */
-    iError += filter_output_mat( filt, &mInput, &mOutput, iStatus );
+    filt->state[0] = bank->state[0][i];
+    filt->state[1] = bank->state[1][i];
     
-    /* Convert the matrix output to a scaler */
-    iError += mat_getValue( &mOutput, 0, 0, dOutput );
+    /* A non-finite state is reset to the steady state of the input, or of a zero input */
+    if ( health_guard( filt->state, FILTER_NINTERNALSTATES, HEALTH_FILTER_RESET ) )
+        return filter_calcState( filt, isfinite( u ) ? u : R_(0.0) );
     
-    return iError;
+    return MCU_OK;
 }
 
 
@@ -361,14 +389,18 @@ int filter_setTf_mat(       Filter * filt, /* [OUT] The filter to operate on
                       const REAL     w0    /* [IN]  Prewarp frequency           */  
                     )
 {
-    int iError = MCU_OK;
+    int k;
+    
+    if ( num->M * num->N != FILTER_NCOEF || den->M * den->N != FILTER_NCOEF ) return MCU_ERR;
+    
     filt->active = 1;
     filt->Ts = Ts;
     filt->w0 = w0;
-    iError += mat_insert( num, filt->num, 0, 0 );
-    iError += mat_insert( den, filt->den, 0, 0 );
-    iError += discreteSISO( num, den, Ts, w0, filt->sys );		
-    return iError;
+    for ( k = 0; k < FILTER_NCOEF; ++k ) {
+        filt->num[k] = num->Mat[k];
+        filt->den[k] = den->Mat[k];
+    }
+    return discreteSISO( filt->num, filt->den, Ts, w0, filt );
 }
 
 /* Change the num and den of the transfer function withoud changing 
@@ -377,14 +409,33 @@ int filter_copyTf(          Filter * target , /* [OUT] Target filter */
                       const Filter * source   /* [IN]  Source filter */ 
                  )    
 {
-    int iError = MCU_OK;
+    int k;
+    
     target->active = source->active;
     target->Ts = source->Ts;
     target->w0 = source->w0;
-    iError += mat_insert( source->num, target->num, 0, 0 );
-    iError += mat_insert( source->den, target->den, 0, 0 );
-    iError += discreteSISO( target->num, target->den, target->Ts, target->w0, target->sys );    
-    return iError;
+    for ( k = 0; k < FILTER_NCOEF; ++k ) {
+        target->num[k] = source->num[k];
+        target->den[k] = source->den[k];
+        target->b[k]   = source->b[k];
+    }
+    target->a[0] = source->a[0];
+    target->a[1] = source->a[1];
+    return MCU_OK;
+}
+
+/* Check if two filters produce the same output for the same input, the 
+   coefficients follow from the transfer function */
+int filter_equal( const Filter * a, const Filter * b )
+{
+    int k, iSame = a->active == b->active && a->Ts == b->Ts && a->w0 == b->w0;
+    
+    for ( k = 0; k < FILTER_NCOEF; ++k ) 
+        iSame = iSame && a->num[k] == b->num[k] && a->den[k] == b->den[k];
+    for ( k = 0; k < FILTER_NINTERNALSTATES; ++k ) 
+        iSame = iSame && a->state[k] == b->state[k];
+    
+    return iSame;
 }
 
 /* Change the num and den of the transfer function withoud changing 
@@ -400,23 +451,25 @@ int filter_setTf_sca(       Filter * filt, /* [OUT] The filter to operate on
                       const REAL     w0    /* [IN]  Prewarp frequency           */  
                     )
 {
-    int iError = MCU_OK;
+    /* The same transfer function: the coefficients are still valid */
+    if ( filt->active && filt->Ts == Ts && filt->w0 == w0 &&
+         filt->num[0] == n0 && filt->num[1] == n1 && filt->num[2] == n2 &&
+         filt->den[0] == d0 && filt->den[1] == d1 && filt->den[2] == d2 ) 
+        return MCU_OK;
     
-    iError += mat_setValue( filt->num, 0, 0, n0 );
-    iError += mat_setValue( filt->num, 1, 0, n1 );
-    iError += mat_setValue( filt->num, 2, 0, n2 );
+    filt->num[0] = n0;
+    filt->num[1] = n1;
+    filt->num[2] = n2;
     
-    iError += mat_setValue( filt->den, 0, 0, d0 );
-    iError += mat_setValue( filt->den, 1, 0, d1 );
-    iError += mat_setValue( filt->den, 2, 0, d2 );
+    filt->den[0] = d0;
+    filt->den[1] = d1;
+    filt->den[2] = d2;
     
     filt->active = 1;
     filt->Ts = Ts;
     filt->w0 = w0;
     
-    iError += discreteSISO( filt->num, filt->den, Ts, w0, filt->sys );		
-    
-    return iError;
+    return discreteSISO( filt->num, filt->den, Ts, w0, filt );
 }
 
 /* Set the transfer function of a notch filter */
@@ -461,45 +514,29 @@ int filter_setHighPass_sca(      Filter * filt  ,
     return filter_setTf_sca( filt, R_(1.0), R_(0.0), R_(0.0), R_(1.0), damp*freq, freq*freq, Ts, FILTER_NOPREWRAP );
 }
 
-/* This function calculates the initial state of the filter based on the given 
-   filter system and input vector. The state is calculated by solving: 
-   (I - A ) x = B u. The function is used during the initialization of the filter. */   
-int filter_calcState( const Filter * filt,  /* [IN] The filter to operate on */
-                      const matrix * uInit  /* [IN] The init. input to calculate 
-                                                      the state with */
+/* This function calculates the initial state of the filter, the steady state 
+   of the section for the given input. The function is used during the 
+   initialization of the filter. */   
+int filter_calcState(       Filter * filt,  /* [IN] The filter to operate on */
+                      const REAL     uInit  /* [IN] The init. input to calculate 
+                                                    the state with */
                       )
 {
-
-    int iError = MCU_OK;
-    
-    /* -----------------------------------------------------------------------------
-    Initiate the state at the beginning of the simulation (aciStatus = 0), 
-    which is the solution x to
-    
-        (I - A ) x = B u
-    
-    ----------------------------------------------------------------------------- */
-    
-    /* Generate an identity matrix */
-    matrix * eye = mat_initEye( FILTER_NINTERNALSTATES );
-    
-    /* Subtract I from A */
-    REAL matrixmem_I_min_A [FILTER_NINTERNALSTATES][FILTER_NINTERNALSTATES];
-    matrix  I_min_A  = mat_stackinit( FILTER_NINTERNALSTATES, FILTER_NINTERNALSTATES, &(matrixmem_I_min_A[0][0]));
-    iError += mat_subtract( eye, filt->sys->A, &I_min_A );
-    
-    /* Multiply B and u */
-    REAL matrixmem_Bu [FILTER_NINTERNALSTATES][FILTER_NINPUTS];
-    matrix  Bu  = mat_stackinit( FILTER_NINTERNALSTATES, FILTER_NINPUTS, &(matrixmem_Bu[0][0]));
-    iError += mat_mult( filt->sys->B, uInit, &Bu );
+    REAL * s = filt->state;
     
-    /* solv I_min_A x = B u */
-    iError += mat_solve( &I_min_A, &Bu, filt->state );
+#ifdef FLOATPRECISION
+    /* Delta form: the steady state solves A s + B u = 0, i.e. s = [ 0, u/a2 ], a pure gain has no state */
+    s[0] = R_(0.0);
+    s[1] = ( ABS( filt->a[1] ) > R_(EPS) ) ? uInit / filt->a[1] : R_(0.0);
+#else
+    /* Direct form II: both states equal u/(1+a1+a2), a pole at z = 1 has no steady state */
+    REAL den = R_(1.0) + filt->a[0] + filt->a[1];
     
-    /* Free the temporary memory */
-    //iError += mat_free(eye);
+    s[0] = ( ABS( den ) > R_(EPS) ) ? uInit / den : R_(0.0);
+    s[1] = s[0];
+#endif
     
-    return iError; 
+    return MCU_OK; 
 
 }   
 
@@ -39,7 +39,30 @@
             NF(s) = \frac{s^2+\omega^2}{s^2+\xi\omega s+\omega^2}.
         \f]
         
-    \sa matrices, system
+    The filter is discretized with the (prewarped) Tustin transformation into
+    a second-order section: five coefficients and two states in the Filter 
+    struct itself, updated in place in direct form II:
+    \f{eqnarray*}{
+        y(k)     & = & b_1 s_1(k) + b_2 s_2(k) + b_0 u(k)   \\
+        s_1(k+1) & = & -a_1 s_1(k) - a_2 s_2(k) + u(k)      \\
+        s_2(k+1) & = & s_1(k)                               ,
+    \f}
+    in which \f$b_1\f$ and \f$b_2\f$ are the numerator of the strictly proper
+    part. The states are the past values of the internal signal and do not
+    depend on the coefficients, which the variable frequency notch filters 
+    change in every sample. In single precision 
+    (FLOATPRECISION) the section is kept in delta form, 
+    s(k+1) = s(k) + A s(k) + B u(k), in which \f$a_1\f$ and \f$a_2\f$ are the 
+    coefficients of the operator z-1, see discreteSISO(). Low-pass and notch 
+    filters at small \f$\omega T_s\f$ have their poles close to z = 1, and the 
+    coefficients of z then lose most of their significant digits in float.
+
+    The filter sequences of the controller are series of filters of which
+    most stages are usually switched off. filter_chain_output() only executes
+    the active stages, it keeps their indices and rebuilds them when a stage
+    is switched on or off.
+        
+    \sa matrices
     
     \b Implementation \b notes 
     
@@ -64,30 +87,18 @@
         
         // Define variables 
         REAL t = 0.0;
-        REAL Omn, input_sca;
-        
-        REAL NF3num[ FILTER_NCOEF ];
-        REAL NF3den[ FILTER_NCOEF ]
-        
-        matrix * num = mat_initEmpty( FILTER_NCOEF, FILTER_NINPUTS );
-        matrix * den = mat_initEmpty( FILTER_NCOEF, FILTER_NINPUTS );
-        
-        matrix * input_mat  = mat_initEmpty(1, 1);
-        matrix * output_mat = mat_initEmpty(1, 1);
+        REAL input_sca, output_sca;
         
+        // The filter holds its coefficients and states, it contains no pointers.
         Filter * filt = filter_initEmpty( );
         
         // Initialization of the notch filter.
         REAL w0 = f1;       // The notch frequency
         REAL zeta = 0.1;    // Damping ratio
-        // Place the numerator and denumerator in arrays.
-        REAL num_sca[3] = { 1.0, 0.0,             w0 * w0 };
-        REAL den_sca[3] = { 1.0, 2.0 * zeta * w0, w0 * w0 };
-        // Copy the arrays to matrices.
-        mat_setArray( num, num_sca, FILTER_NCOEF, FILTER_NINPUTS );
-        mat_setArray( den, den_sca, FILTER_NCOEF, FILTER_NINPUTS );
-        // Set the transfer function of the filter filter.
-        filter_setTf_mat( filt, num, den, dt, w0 );
+        // Set the transfer function [ n0 n1 n2 ] / [ d0 d1 d2 ], prewarped at 
+        // the notch frequency. This switches the filter on.
+        filter_setTf_sca( filt, 1.0, 0.0,             w0 * w0, 
+                                1.0, 2.0 * zeta * w0, w0 * w0, dt, w0 );
     
         // The simulation loop.
         for( t = 0.0; t <= t_end; t = t + dt )
@@ -102,11 +113,8 @@
                         A2 * sin( f2 * t ) +
                         A3 * sin( f3 * t ) ;
                         
-            // Copy the scalar variable to the matrix input vector. 
-            mat_setValue( input_mat, 0, 0, input_sca);
-        
             // Generate the output
-            filter_output_mat( filt, input_mat, output_mat, iStatus );
+            filter_output_sca( filt, &input_sca, &output_sca, iStatus );
     
             // Use the filtered signal  
             ...
@@ -114,12 +122,7 @@
         };
         
         // Free the memory allocated.
-        mat_free( num );
-        mat_free( den );
-        mat_free( input_mat );
-        mat_free( output_mat );
-        
-        filter_free( filt )
+        filter_free( filt );
     \endcode
 
    
@@ -158,19 +161,63 @@ enum {
 #ifndef DXG_SKIP_STRUCTS
 /*! \struct Filter
     \brief A struct defining the properties internal variables of a filter.
+
+    The members which a sample reads come first, the transfer function is 
+    only read when it is changed.
 */
 typedef struct Filter
 {
-    matrix * num    ;   //!< A matrix holding the numerator variables \f$[ n_0 \; n_1 \; n_2 ]^T\f$. 
-    matrix * den    ;   //!< A matrix holding the denumerator variables \f$[ d_0 \; d_1 \; d_2 ]^T\f$. 
-    System * sys    ;   //!< The discrete state space system based on the filter description. 
-    matrix * state  ;   //!< The internal state of the filter. 
-    REAL Ts         ;   //!< The sample time on which the filter operates. 
-    REAL w0         ;   //!< The prewarp frequency of the filter. If set to equal to FILTER_NOPREWRAP the prewarp frequency is disabled. 
-    int active      ;   //!< Indicator whether filter is turned on or off, in the latter case output=input 
+    REAL b[ FILTER_NCOEF ]                  ;   //!< The coefficients \f$[ b_0 \; b_1 \; b_2 ]\f$ of the discrete section.
+    REAL a[ FILTER_NCOEF-1 ]                ;   //!< The coefficients \f$[ a_1 \; a_2 ]\f$ of the discrete section.
+    REAL state[ FILTER_NINTERNALSTATES ]    ;   //!< The internal states \f$[ s_1 \; s_2 ]\f$ of the section.
+    int active                              ;   //!< Indicator whether filter is turned on or off, in the latter case output=input 
+    REAL num[ FILTER_NCOEF ]                ;   //!< The numerator variables \f$[ n_0 \; n_1 \; n_2 ]\f$. 
+    REAL den[ FILTER_NCOEF ]                ;   //!< The denumerator variables \f$[ d_0 \; d_1 \; d_2 ]\f$. 
+    REAL Ts                                 ;   //!< The sample time on which the filter operates. 
+    REAL w0                                 ;   //!< The prewarp frequency of the filter. If set to equal to FILTER_NOPREWRAP the prewarp frequency is disabled. 
     
 } Filter;
 
+//! Bytes which filter_carve() takes from an arena.
+#define FILTER_ARENA_SIZE   ARENA_SIZE( sizeof(Filter) )
+
+#define FILTER_CHAIN_MAX    N_FILTERS   //!< Largest number of filters in a series of filter_chain_output().
+
+#if FILTER_CHAIN_MAX > 32
+#error "The active filters of a FilterChain are kept in a mask of 32 bits"
+#endif
+
+/*! \struct FilterChain
+    \brief The active stages of a series of filters, see filter_chain_output().
+*/
+typedef struct FilterChain
+{
+    int   nActive                       ;   //!< Number of active filters in the series.
+    unsigned long uMask                 ;   //!< Active flags of the series from which iActive was built, bit k for filter k.
+    short iActive[ FILTER_CHAIN_MAX ]   ;   //!< Index of the active filters in the series, in the order of the series.
+
+} FilterChain;
+
+#define FILTER_BANK_WIDTH   16          //!< Number of filters which a FilterBank runs side by side.
+
+/*! \struct FilterBank
+    \brief One filter stage of up to #FILTER_BANK_WIDTH controllers, stored per coefficient.
+
+    The coefficients and states of the same filter of a number of controllers 
+    are stored next to each other, so filter_bank_output() runs the same 
+    operation over all of them in one loop, see mcu_run_batch(). The filters 
+    themselves remain the owners of the states: filter_bank_load() copies a 
+    filter into a column of the bank and filter_bank_store() copies its new 
+    state back.
+*/
+typedef struct FilterBank
+{
+    REAL b[ FILTER_NCOEF ][ FILTER_BANK_WIDTH ]                 ;   //!< The coefficients \f$[ b_0 \; b_1 \; b_2 ]\f$ of each column.
+    REAL a[ FILTER_NCOEF-1 ][ FILTER_BANK_WIDTH ]               ;   //!< The coefficients \f$[ a_1 \; a_2 ]\f$ of each column.
+    REAL state[ FILTER_NINTERNALSTATES ][ FILTER_BANK_WIDTH ]   ;   //!< The internal states \f$[ s_1 \; s_2 ]\f$ of each column.
+
+} FilterBank;
+
 typedef struct BlockAvr
 {
     REAL * array    ;   //!< Array of old vales
@@ -212,6 +259,22 @@ BlockAvr * blockavr_init(const REAL time, const REAL Ts);
 */
 Filter * filter_initEmpty( );
 
+//! Carve a filter from an arena.
+/*!
+    The coefficients, the state and the transfer function are part of the 
+    Filter struct, the filter contains no pointers and can be copied as a 
+    whole, see \ref arena.
+    \return     The filter, NULL if the arena only counts. It is released with the arena.
+*/
+Filter * filter_carve( mem_arena * a );
+
+//! Initialize the filter with zero entries in an arena.
+/*!
+    As filter_initEmpty(), the arena needs to be zeroed memory.
+    \return     The filter, NULL if the arena only counts. It is released with the arena.
+*/
+Filter * filter_initArena( mem_arena * a );
+
 //! Initialize the filter by copying an existing filter.
 /*!
 
@@ -248,7 +311,7 @@ int blockavr_free( BlockAvr * blockavr );
                     set the internal state.
     \return         A non zero int will be returned in case of an failure.  
 */
-int filter_output_mat( const Filter * filt, const matrix * input, matrix * output,
+int filter_output_mat( Filter * filt, const matrix * input, matrix * output,
                         const int iStatus );
                         
 //! Calculate the output scalar of the filter based on the input matrix and internal state of the filter.
@@ -261,9 +324,64 @@ int filter_output_mat( const Filter * filt, const matrix * input, matrix * outpu
                     set the internal state.
     \return         A non zero int will be returned in case of an failure.  
 */  
-int filter_output_sca( const Filter * filt, const REAL * dInput, REAL * dOutput, 
+int filter_output_sca( Filter * filt, const REAL * dInput, REAL * dOutput, 
                         const int iStatus );
 
+//! Calculate the outputs of a series of filters, of which only the active filters are executed.
+/*!
+    The active filters of the series are stored in the chain at the 
+    initialization (iStatus equals to MCU_STATUS_INIT), the other filters are
+    skipped. The active flags are compared with the chain in every sample,
+    which is rebuilt when a set function or filter_copyTf() switches a 
+    filter on or off at run time.
+
+    \param series   The filters of the series, the input of each filter is the output of the previous one.
+    \param nStages  Number of filters in the series, at most #FILTER_CHAIN_MAX.
+    \param chain    The active filters of the series.
+    \param x        Signal before and after each filter, x[0] is the input of the 
+                    series and x[k+1] the output of filter k. An inactive filter 
+                    passes its input.
+    \param iStatus  Simulation status input to the filters.
+    \return         A non zero int will be returned in case of an failure.  
+*/
+int filter_chain_output( Filter * const * series, const int nStages, FilterChain * chain, REAL * x,
+                        const int iStatus );
+
+//! Copy the coefficients and the state of a filter into a column of a bank.
+/*!
+    An inactive filter, or NULL, gives a column which passes its input.
+
+    \param bank     The filter bank.
+    \param i        The column, less than #FILTER_BANK_WIDTH.
+    \param filt     The filter, may be NULL.
+*/
+void filter_bank_load( FilterBank * bank, const int i, const Filter * filt );
+
+//! Calculate one run sample of the first n columns of a bank.
+/*!
+    Each column is updated as filter_output_sca() updates an active filter, 
+    without the guard of its state, which filter_bank_store() applies.
+
+    \param bank     The filter bank.
+    \param n        Number of columns, at most #FILTER_BANK_WIDTH.
+    \param u        The input of each column [n].
+    \param y        The output of each column [n].
+*/
+void filter_bank_output( FilterBank * bank, const int n, const REAL * u, REAL * y );
+
+//! Copy the new state of a column of a bank back into its filter.
+/*!
+    The state is guarded as in filter_output_sca(), with the counters selected 
+    by health_select(). Nothing is copied into an inactive filter.
+
+    \param bank     The filter bank.
+    \param i        The column.
+    \param filt     The filter which was loaded into the column.
+    \param u        The input of the column in this sample.
+    \return         A non zero int will be returned in case of an failure.  
+*/
+int filter_bank_store( const FilterBank * bank, const int i, Filter * filt, const REAL u );
+
 // Block average output
 int blockavr_output( BlockAvr * blockavr, const REAL * dInput, REAL * dOutput,
                         const int iStatus );
@@ -274,28 +392,27 @@ int blockavr_output( BlockAvr * blockavr, const REAL * dInput, REAL * dOutput,
 //! \name Parameter operations
 //!@{
 
-//! Function to create a discrete SISO system from a given set of numerators and denumerators.
+//! Function to create a discrete second-order section from a given set of numerators and denumerators.
 /*!
 
     Based on the given numerate, denumerator, sample time and prewrap frequency 
-    this function calculates a discrete SISO system in the form:
-    \f{eqnarray*}{
-        x(k+1) & = & A x(k) + B u(k)    \\
-        y(k)   & = & C x(k) + D u(k)    .
-    \f}
-    \param num  Matrix holding the numerator variables \f$[ n_0 \; n_1 \; n_2 ]^T\f$ of the filter.
-    \param den  Matrix holding the denumerator variables \f$[ d_0 \; d_1 \; d_2 ]^T\f$ of the filter.   
+    this function calculates the coefficients of the discrete transfer function
+    \f[
+        H(z) = \frac{ b_0 + b_1 z^{-1} + b_2 z^{-2} }{ 1 + a_1 z^{-1} + a_2 z^{-2} }.
+    \f]
+    In single precision (FLOATPRECISION) \f$a_1\f$ and \f$a_2\f$ are the 
+    coefficients of the denumerator in the operator z-1 instead, and 
+    \f$b_1\f$ and \f$b_2\f$ the output coefficients of the strictly proper 
+    part, see \ref filter.
+    \param num  The numerator variables \f$[ n_0 \; n_1 \; n_2 ]\f$ of the filter.
+    \param den  The denumerator variables \f$[ d_0 \; d_1 \; d_2 ]\f$ of the filter.   
     \param Ts   The sample time	on which the filter operates.
     \param w0   The prewarp frequency of the filter. If set to equal to 
                 FILTER_NOPREWRAP the prewarp frequency is disabled. 
-    \param sys  The output of the function is returned via this pointer. The 
-                given system must be initialized with:
-                \code 
-                    System * sys = sys_init( FILTER_NINTERNALSTATES, FILTER_NINPUTS, FILTER_NOUTPUTS );
-                \endcode    
+    \param filt The coefficients are returned in this filter, its state is not changed.
     \return     A non zero int will be returned in case of an failure.	
 */
-int discreteSISO( const matrix * num, const matrix * den, const REAL Ts, const REAL w0, System * sys );
+int discreteSISO( const REAL * num, const REAL * den, const REAL Ts, const REAL w0, Filter * filt );
     
 //! Change the numerator and denumerator of the transfer function making use of matrices.
 /*!
@@ -314,6 +431,8 @@ int filter_setTf_mat( Filter * filt, const matrix * num, const matrix * den, con
 //! Change the numerator and denumerator of the transfer function making use of scalars.
 /*!
     The transfer function is altered without changing the internal state of the filter.
+    The discretization is skipped when the filter already has this transfer function, 
+    sample time and prewarp frequency.
     
     \param filt The filter to operate on.
     \param n0       Numerator element \f$n_0\f$.    
@@ -337,6 +456,14 @@ int filter_setTf_sca( Filter * filt, const REAL n0, const REAL n1, const REAL n2
     \return         A non zero int will be returned in case of an failure.  
 */
 int filter_copyTf( Filter * target, const Filter * source );
+
+//! Check if two filters produce the same output for the same input
+/*!
+    \param a        First filter struct.
+    \param b        Second filter struct.
+    \return         1 If the transfer functions, the settings and the internal states are the same, 0 otherwise.
+*/
+int filter_equal( const Filter * a, const Filter * b );
         
 //! Set the transfer function of a notch filter 
 /*!
@@ -385,15 +512,15 @@ int filter_setHighPass_sca( Filter * filt, const REAL damp, const REAL freq, con
 
 //! This function calculates the initial state of the filter.
 /*! 
-    The initial stated is based on the given filter system and input vector. 
-    The state is calculated by solving: \f$(I - A ) x = B u\f$. The function 
-    is used during the initialization of the filter. 
+    The initial stated is the steady state of the section for a constant 
+    input. A section with a pole at z = 1 has no steady state, its state is 
+    set to zero. The function is used during the initialization of the filter. 
 
     \param filt     The filter to operate on.
     \param uInit    The initialization input to calculate the state with.
     \return         A non zero int will be returned in case of an failure.
 */  
-int filter_calcState( const Filter * filt, const matrix * uInit	);
+int filter_calcState( Filter * filt, const REAL uInit );
     
 //!@}
 
@@ -0,0 +1,64 @@
+/* ---------------------------------------------------------------------------------
+ *          file : health.c                                                       *
+ *   description : C-source file, numerical health of the filter and PID states   *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#include <float.h>
+
+#include "./../signals/signal_definitions_internal.h"
+
+#include "./health.h"
+
+/* Smallest normal number and largest finite number of REAL */
+#ifdef FLOATPRECISION
+#define HEALTH_TINY     FLT_MIN
+#define HEALTH_HUGE     FLT_MAX
+#else
+#define HEALTH_TINY     DBL_MIN
+#define HEALTH_HUGE     DBL_MAX
+#endif
+
+/* Counters of the instance which is stepped by the calling thread */
+static _Thread_local long * pHealth = NULL;
+static _Thread_local int    bHealthSnap = FALSE;
+
+/* ---------------------------------------------------------------------------------
+ Selection of the counters
+--------------------------------------------------------------------------------- */
+void health_select( long * pCount, const int bSnap )
+{
+    pHealth     = pCount;
+    bHealthSnap = bSnap;
+}
+
+/* ---------------------------------------------------------------------------------
+ Guard a state
+--------------------------------------------------------------------------------- */
+int health_guard( REAL * x, const int n, const int iReset )
+{
+    int k, bReset = FALSE;
+
+    for ( k = 0; k < n; ++k ) {
+
+        const REAL a = ABS( x[k] );
+
+        /* Also true for NaN */
+        if ( !( a <= HEALTH_HUGE ) ) 
+            bReset = TRUE;
+
+        else if ( bHealthSnap && a < HEALTH_TINY && a > R_(0.0) ) {
+            x[k] = R_(0.0);
+            if ( pHealth != NULL ) pHealth[ iReset+1 ]++;
+        }
+    }
+
+    if ( bReset && pHealth != NULL ) pHealth[ iReset ]++;
+
+    return bReset;
+}
+
+/* ---------------------------------------------------------------------------------
+  end health.c
+--------------------------------------------------------------------------------- */
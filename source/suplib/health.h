@@ -0,0 +1,93 @@
+/* ---------------------------------------------------------------------------------
+ *          file : health.h                                                       *
+ *   description : C-header file, numerical health of the filter and PID states   *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _HEALTH_H_
+#define _HEALTH_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup suplib
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup health Numerical health
+
+    The states of the filters and PID controllers are guarded against two
+    numerical problems:
+
+    - Subnormal numbers. A state which decays towards zero, e.g. in a filter
+      chain with a zero input or in the drivetrain damping after it is faded
+      out, ends up in the subnormal range, in which every operation on x86 is
+      one to two orders of magnitude slower. mcu_instance_step() flushes
+      subnormal numbers to zero in the processor during the sample, see
+      plat_fpu_flush(). On a processor without that mode the guard snaps
+      states below the smallest normal number to zero instead.
+    - Non-finite numbers. A NaN or Inf, e.g. after a bad measurement, would
+      stay in the state forever. The guard detects it and the filter or PID
+      resets its state: a filter to the steady state of its current input by
+      filter_calcState(), a PID to zero.
+
+    Every event is counted in the counters of the instance which is stepped,
+    which are selected per thread by health_select(), like the data of the
+    \ref profiler. The counters are reported at #MCU_STATUS_EXIT.
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  health.h
+    \brief This header file contains the numerical health guard of the filter and PID states.
+*/
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+//! Events of the numerical health guard, per kind of state the reset is followed by the snap.
+enum health_event {
+    HEALTH_FILTER_RESET     ,   //!< Filter state reset after a non-finite value.
+    HEALTH_FILTER_SNAP      ,   //!< Subnormal filter state snapped to zero.
+    HEALTH_PID_RESET        ,   //!< PID state reset after a non-finite value.
+    HEALTH_PID_SNAP         ,   //!< Subnormal PID state snapped to zero.
+    HEALTH_NR_EVENTS            //!< Number of events.
+};
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+//! Select the counters of the calling thread.
+/*!
+    \param pCount   [in+out]    Counters of the instance which is about to be stepped [#HEALTH_NR_EVENTS], NULL disables counting.
+    \param bSnap    [in]        Flag indicating that subnormal states are snapped to zero, i.e. the processor does not flush them.
+*/
+void health_select( long * pCount, const int bSnap );
+
+//! Guard the new state of a filter or PID controller.
+/*!
+    Snaps the subnormal elements to zero if selected and counts them as
+    iReset+1. A non-finite element is counted as iReset, the caller resets
+    the state.
+
+    \param x        [in+out]    The state.
+    \param n        [in]        Number of elements.
+    \param iReset   [in]        #HEALTH_FILTER_RESET or #HEALTH_PID_RESET.
+    \return         TRUE if the state contains a non-finite element.
+*/
+int health_guard( REAL * x, const int n, const int iReset );
+
+#endif
+
+/** @}*/
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _HEALTH_H_
+--------------------------------------------------------------------------------- */
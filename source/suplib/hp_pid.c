@@ -23,8 +23,6 @@
 /* Generate a new PID struct in memory */   
 HP_PID * hppid_initEmpty( ) {
     
-    /* Local variables */
-    int k;
     /* Allocate memory for the struct */
     HP_PID * hppid = (HP_PID*) calloc( 1, sizeof(HP_PID) );
     /* Initialize the conventional PID controller */
@@ -33,8 +31,9 @@ HP_PID * hppid_initEmpty( ) {
     hppid->active = 0;
     /* Initialize the filter state */
     hppid->lpstate = R_(0.0);
-    /* Initialize delayvector */
-    for ( k =0; k < DELAYVECLENGTH; ++k ) hppid->delayvec[k] = R_(0.0);
+    /* The delay vector is allocated when the delay is known */
+    hppid->delayvec = NULL;
+    hppid->ndelay   = 0;
     /* Return the created struct */
     return hppid;
     
@@ -43,8 +42,9 @@ HP_PID * hppid_initEmpty( ) {
 /* Free the memory allocated to the controller struct */    
 int hppid_free( HP_PID * hppid ) {
     
-    /* Release the conventional PID controller */
+    /* Release the conventional PID controller and the delay vector */
     pid_free( hppid->pid );
+    if ( hppid->delayvec != NULL ) free( hppid->delayvec );
     /* Release the HP_PID controller itself */
     free( hppid );
     /* Return error code */
@@ -80,7 +80,7 @@ int hppid_setdata(
     pid_setConstraints_sca( hppid->pid, umin, umax, dumin, dumax );
     /* Set internal model */
     if ( Tp > R_(0.0) ) {
-        hppid->modelA = exp( -Ts / Tp );
+        hppid->modelA = R_EXP( -Ts / Tp );
         hppid->modelB = K * ( R_(1.0) - hppid->modelA );
     }
     else {
@@ -88,9 +88,17 @@ int hppid_setdata(
         hppid->modelB = K       ;
     }
     /* Set filter constant in low-pass filter */
-    hppid->lpconstant = exp( -Ts / Tf );
+    hppid->lpconstant = R_EXP( -Ts / Tf );
     /* Set index in delayvector */
-    hppid->index = NINT( TDT/Ts + 1.0 );
+    hppid->index = NINT( TDT/Ts + R_(1.0) );
+    /* Only the samples up to the delay are read, the vector is zero at the start */
+    int ndelay = MAX( MIN( DELAYVECLENGTH, hppid->index ), 1 );
+    if ( ndelay != hppid->ndelay ) {
+        if ( hppid->delayvec != NULL ) free( hppid->delayvec );
+        hppid->delayvec = (REAL*) calloc( ndelay, sizeof(REAL) );
+        hppid->ndelay   = ( hppid->delayvec != NULL ) ? ndelay : 0;
+        if ( hppid->delayvec == NULL ) iError += MCU_ERR;
+    }
     /* (De)activate the HP-PID */
     hppid->active = active;
     
@@ -117,8 +125,8 @@ int hppid_output_sca(
     int k, iError = MCU_OK;
     REAL    rError;
     
-    /* Call the conventional controller */
-    if (!hppid->active) {
+    /* Call the conventional controller, also without a delay vector */
+    if ( !hppid->active || hppid->delayvec == NULL ) {
         rError  = rInput-rSetpoint;
         iError += pid_output_sca( hppid->pid, &rError, rOldOutput, rOutput, iStatus );
         *rModel = R_(0.0);
@@ -132,7 +140,7 @@ int hppid_output_sca(
         /* Obtain model value without delay */
         REAL rModel_ud      = hppid->delayvec[0];
         /* Obtain model value with delay */
-        int ndel            = MIN( DELAYVECLENGTH, hppid->index );
+        int ndel            = MIN( hppid->ndelay, hppid->index );
         int ndelm1          = MAX( ndel-1, 0 );
         *rModel             = hppid->delayvec[ ndelm1 ];
         /* Compute the adapted measurement for the controller */
@@ -141,7 +149,7 @@ int hppid_output_sca(
         rError              = rInput_con-rSetpoint;
         iError             += pid_output_sca( hppid->pid, &rError, rOldOutput, rOutput, iStatus );
         /* Update the delay vector */
-        for ( k = 1; k < DELAYVECLENGTH; ++k ) hppid->delayvec[k] = hppid->delayvec[k-1];
+        for ( k = 1; k < hppid->ndelay; ++k ) hppid->delayvec[k] = hppid->delayvec[k-1];
         hppid->delayvec[0] = hppid->modelA * rModel_ud + hppid->modelB * ( hppid->pid->ulast->Mat[0] - u0 );
     }
     
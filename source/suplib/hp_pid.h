@@ -29,7 +29,7 @@
 
 #ifndef DXG_SKIP_TYPES
 
-#define DELAYVECLENGTH 1000
+#define DELAYVECLENGTH 1000    //!<    Maximum length of the delay vector [samples]
 
 #endif
 
@@ -42,7 +42,8 @@ typedef struct HP_PID
 {
     
     PID    * pid                            ;   //!<    Conventional PID struct
-    REAL     delayvec[DELAYVECLENGTH]       ;   //!<    Delay vector
+    REAL   * delayvec                       ;   //!<    Delay vector, allocated by hppid_setdata() for the delay of the model
+    int      ndelay                         ;   //!<    Length of the delay vector, at most #DELAYVECLENGTH
     int      index                          ;   //!<    Index in delayvector
     int      active                         ;   //!<    HP-PID (1) or convenctional (0)
     REAL     modelA                         ;   //!<    Model x(k+1) = Ax(k) + Bu(k)
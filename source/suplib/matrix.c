@@ -29,6 +29,21 @@ matrix * mat_initEmpty( const int M, const int N )
 }
 
 
+/* Carve an empty matrix A of size MxN from an arena, the data directly follows the struct */
+matrix * mat_carve( mem_arena * a, const int M, const int N )
+{
+    matrix * new_matrix = (matrix*) arena_carve( a, sizeof(matrix) );
+    REAL   * pData      = (REAL*)   arena_carve( a, (size_t)M * N * sizeof(REAL) );
+
+    if ( new_matrix != NULL ) {
+        new_matrix->Mat = pData;
+        new_matrix->M = M;
+        new_matrix->N = N;
+    }
+    return new_matrix;
+}
+
+
 /* Initialize an empty matrix A on the stack (REAL* is first memory address of the REAL[][] where the matrix data will be hold)*/
 matrix  mat_stackinit( const int M, const int N, REAL * realarrayptr)
 {
@@ -256,11 +271,11 @@ int mat_mult( const matrix * A, const matrix * B, matrix * C )
 	{
 		for (i = 0; i < C->N; i++)
 		{
-			C->Mat[(i * C->M) + j] = 0.0; // Clean column first
+			C->Mat[(i * C->M) + j] = R_(0.0); // Clean column first
 		}
 		for (l = 0; l < A->N; l++) //k
 		{
-			if (A->Mat[(l * A->M) + j] != 0.0)
+			if (A->Mat[(l * A->M) + j] != R_(0.0))
 			{
 				for (i = 0; i < B->N; i++) //m
 				{
@@ -353,7 +368,7 @@ int mat_nrm2( const matrix * A, REAL * nrm2 )
 	{
 		*nrm2 += A->Mat[i]*A->Mat[i];
 	}
-    *nrm2 = sqrt(*nrm2);
+    *nrm2 = R_SQRT(*nrm2);
 
     return MCU_OK;
 }
@@ -71,6 +71,9 @@ typedef struct matrix{
     REAL * Mat;
     
 } matrix;
+
+//! Bytes which mat_carve() takes from an arena for a MxN matrix.
+#define MAT_ARENA_SIZE( M, N )  ( ARENA_SIZE( sizeof(matrix) ) + ARENA_SIZE( (size_t)(M) * (N) * sizeof(REAL) ) )
 #endif
 
 
@@ -84,6 +87,19 @@ typedef struct matrix{
 matrix * mat_initEmpty( const int M, const int N ); 
 matrix  mat_stackinit( const int M, const int N, REAL* realarrayptr);
 
+//! Carve an empty matrix of size MxN from an arena.
+/*!
+    The data directly follows the matrix struct. Only the pointer and the 
+    dimensions are set, the data is left as it is, see \ref arena.
+    
+    \param a The arena.
+    \param M Number of rows.
+    \param N Number of columns.
+    
+    \return The matrix, NULL if the arena only counts. It is released with the arena.
+*/
+matrix * mat_carve( mem_arena * a, const int M, const int N );
+
 //! Initialize a matrix with given values at the size of MxN. 
 /*! 
     The initial value array A is ROW MAJOR!! This to allow for easy human readable input.
@@ -71,10 +71,19 @@
     \li par_readline_f()        Read in a parameter line with float data type
     \li par_readline_d()        Read in a parameter line with double data type
     \li par_readline_s()        Read in a parameter line with char[] data type
+    \li par_readline_rate()     Read in an optional parameter line with the rate divisor and phase offset of a multi-rate task.
     \li par_readfilt_fxd()      Read in a parameter line which details a filter with a fixed frequency.
     \li par_readfilt_var()      Read in a parameter line which details a filter with a variable frequency.
     \li par_readfilt_series()   Read in a block of parameters lines which contain a sequence of filters (with _HPxF, _NFxP, NFxF and _LPxF extensions).
     
+    \subsection parameter_echo  Echo Files
+    Every read file function writes the parameters it has read to an echo
+    file in the log directory (e.g. _MCU.PAR). The echo file is opened with
+    par_echo_open() and closed with par_echo_close(). With the compile switch
+    DOTXPARALLELINIT the echo is kept in memory and written to the disc by a
+    background thread, so the initialization does not wait for the disc;
+    par_echo_sync() waits until all echo files are written.
+
     \sa matrices, system, filter, PID
 
  *  @{*/
@@ -93,6 +102,8 @@
 
 #define MAXPARCHAR 201
 
+#define PAR_THREAD_STACK    (256*1024)  //!< Stack size of the threads which read and write the parameter files with DOTXPARALLELINIT.
+
 typedef struct text_struct{
 	 char        * alltext ;
 	 int          position ;
@@ -147,9 +158,21 @@ int par_readline_d( FILE*, FILE*, REAL*, const char* );
 //! Read a line in char[] format
 int par_readline_s( FILE*, FILE*, char*, const char* );
 
+//! Read an optional line with the rate divisor and phase offset of a multi-rate task, see #RATE_DUE
+int par_readline_rate( FILE*, FILE*, int*, const char* );
+
 //! Find the start of the next line containing data
 void par_findstart( FILE*, char* );
 
+//! Open an echo file of a parameter file
+FILE * par_echo_open( const char* );
+
+//! Close an echo file, with DOTXPARALLELINIT it is written in the background
+int par_echo_close( FILE* );
+
+//! Wait until all echo files closed by par_echo_close() are written
+void par_echo_sync( void );
+
 //! Read a line in integer format
 int par_readline_txt_i( text_struct*, int*, const char* );
 
@@ -0,0 +1,189 @@
+/* ---------------------------------------------------------------------------------
+ *          file : par_echo.c                                                     *
+ *   description : C-source file, deferred writing of the parameter echo files    *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifdef DOTXPARALLELINIT
+#include <pthread.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "./../signals/signal_definitions_internal.h"
+
+#include "./matrix.h"
+#include "./system.h"
+#include "./filter.h"
+#include "./pid.h"
+#include "./par.h"
+
+
+#ifdef DOTXPARALLELINIT
+
+#define PAR_ECHO_BUFSIZE    (16*BUFSIZE)    /* Buffer of an echo file, holds a complete file */
+#define PAR_ECHO_FILES      16              /* Echo files which can be pending at the same time */
+
+/* State of an echo file */
+enum par_echo_states { ECHO_FREE, ECHO_OPEN, ECHO_QUEUED, ECHO_WRITING };
+
+typedef struct par_echo_file {
+    FILE    * fid       ;
+    char    * cBuffer   ;
+    int       iState    ;
+} par_echo_file;
+
+static par_echo_file   sEcho[ PAR_ECHO_FILES ];
+static int             bWriter = FALSE;
+static pthread_mutex_t mtxEcho = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  cndEcho = PTHREAD_COND_INITIALIZER;
+
+/* ---------------------------------------------------------------------------------
+ Background writer, flushes the queued echo files and stops when the queue is empty
+--------------------------------------------------------------------------------- */
+static void * par_echo_writer( void * vpArg )
+{
+    int k;
+
+    (void) vpArg;
+
+    pthread_mutex_lock( &mtxEcho );
+
+    for ( ;; ) {
+
+        for ( k = 0; k < PAR_ECHO_FILES && sEcho[k].iState != ECHO_QUEUED; ++k );
+        if ( k == PAR_ECHO_FILES ) break;
+
+        sEcho[k].iState = ECHO_WRITING;
+        pthread_mutex_unlock( &mtxEcho );
+
+        fclose( sEcho[k].fid );
+        free( sEcho[k].cBuffer );
+
+        pthread_mutex_lock( &mtxEcho );
+        sEcho[k].fid     = NULL;
+        sEcho[k].cBuffer = NULL;
+        sEcho[k].iState  = ECHO_FREE;
+    }
+
+    bWriter = FALSE;
+    pthread_cond_broadcast( &cndEcho );
+    pthread_mutex_unlock( &mtxEcho );
+
+    return NULL;
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ Open an echo file, the output is kept in memory until par_echo_close()
+--------------------------------------------------------------------------------- */
+FILE * par_echo_open( const char * cOutFile )
+{
+#ifdef DOTXPARALLELINIT
+    FILE * fid;
+    char * cBuffer;
+    int    k;
+
+    pthread_mutex_lock( &mtxEcho );
+    for ( k = 0; k < PAR_ECHO_FILES && sEcho[k].iState != ECHO_FREE; ++k );
+    if ( k < PAR_ECHO_FILES ) sEcho[k].iState = ECHO_OPEN;
+    pthread_mutex_unlock( &mtxEcho );
+
+    /* All slots in use: an ordinary file */
+    if ( k == PAR_ECHO_FILES ) return fopen( cOutFile, "w" );
+
+    fid     = fopen( cOutFile, "w" );
+#ifdef DOTXSTATICMEM
+    /* The static pools are sized for the controller, the echo keeps the buffer of the C library */
+    cBuffer = NULL;
+#else
+    cBuffer = ( fid != NULL ) ? (char*) malloc( PAR_ECHO_BUFSIZE ) : NULL;
+#endif
+
+    if ( cBuffer != NULL ) setvbuf( fid, cBuffer, _IOFBF, PAR_ECHO_BUFSIZE );
+
+    pthread_mutex_lock( &mtxEcho );
+    sEcho[k].fid     = fid;
+    sEcho[k].cBuffer = cBuffer;
+    sEcho[k].iState  = ( fid != NULL ) ? ECHO_OPEN : ECHO_FREE;
+    pthread_mutex_unlock( &mtxEcho );
+
+    return fid;
+#else
+    return fopen( cOutFile, "w" );
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+ Close an echo file, the contents are written to the disc in the background
+--------------------------------------------------------------------------------- */
+int par_echo_close( FILE * fidOutFile )
+{
+#ifdef DOTXPARALLELINIT
+    pthread_t thread;
+    int       k;
+
+    if ( fidOutFile == NULL ) return MCU_ERR;
+
+    pthread_mutex_lock( &mtxEcho );
+
+    for ( k = 0; k < PAR_ECHO_FILES && !( sEcho[k].iState == ECHO_OPEN && sEcho[k].fid == fidOutFile ); ++k );
+
+    /* Not opened by par_echo_open() or without a slot */
+    if ( k == PAR_ECHO_FILES ) {
+        pthread_mutex_unlock( &mtxEcho );
+        return ( fclose( fidOutFile ) == 0 ) ? MCU_OK : MCU_ERR;
+    }
+
+    sEcho[k].iState = ECHO_QUEUED;
+
+    /* Start the writer if it is not running, write the file here if that fails */
+    if ( !bWriter ) {
+        pthread_attr_t attr;
+        pthread_attr_init( &attr );
+        pthread_attr_setstacksize( &attr, PAR_THREAD_STACK );
+        pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+        if ( pthread_create( &thread, &attr, par_echo_writer, NULL ) == 0 ) {
+            bWriter = TRUE;
+        }
+        else {
+            sEcho[k].iState = ECHO_WRITING;
+            pthread_mutex_unlock( &mtxEcho );
+            fclose( sEcho[k].fid );
+            free( sEcho[k].cBuffer );
+            pthread_mutex_lock( &mtxEcho );
+            sEcho[k].fid     = NULL;
+            sEcho[k].cBuffer = NULL;
+            sEcho[k].iState  = ECHO_FREE;
+        }
+        pthread_attr_destroy( &attr );
+    }
+
+    pthread_mutex_unlock( &mtxEcho );
+
+    return MCU_OK;
+#else
+    if ( fidOutFile == NULL ) return MCU_ERR;
+    return ( fclose( fidOutFile ) == 0 ) ? MCU_OK : MCU_ERR;
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+ Wait until all echo files are written
+--------------------------------------------------------------------------------- */
+void par_echo_sync( void )
+{
+#ifdef DOTXPARALLELINIT
+    pthread_mutex_lock( &mtxEcho );
+    while ( bWriter ) pthread_cond_wait( &cndEcho, &mtxEcho );
+    pthread_mutex_unlock( &mtxEcho );
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+  end par_echo.c
+--------------------------------------------------------------------------------- */
@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <ctype.h>
 
 #include "./../signals/signal_definitions_internal.h"
 
@@ -184,7 +185,7 @@ int par_readline_d( FILE * fidInFile, FILE * fidOutFile, REAL * dData, const cha
             fprintf( fidOutFile, "%s : ", cTemp );
             
             for ( k = 0; k < N; ++k ) {
-                fscanf(  fidInFile,  "%lf ",   dData+k  );
+                fscanf(  fidInFile,  R_FMT " ", dData+k  );
                 iError += par_convert_d( cUnit, dData+k ) ;
                 if (fidOutFile != NULL)
                     fprintf( fidOutFile, "%.10f  ", *(dData+k) );
@@ -266,29 +267,69 @@ int par_readline_s( FILE * fidInFile, FILE * fidOutFile, char * cData, const cha
 } /* end par_readline_s() */
 
 /* ---------------------------------------------------------------------------------
- Find the start of the line
+ Read an optional rate divisor and phase offset of a multi-rate task
+ int par_readline_rate( FILE * fidInFile,     : File to read from
+                        FILE * fidOutFile,    : File to write output to
+                        int * iRate,          : Divisor and phase offset, {1,0} if absent
+                        const char * cTagRef  : Which tag name to look for in the file
 --------------------------------------------------------------------------------- */
-void par_findstart( FILE * fid, char * cType )
+int par_readline_rate( FILE * fidInFile, FILE * fidOutFile, int * iRate, const char * cTagRef )
+{
+    int iError;
+
+    // Default: run the task every sample
+    iRate[0] = 1;
+    iRate[1] = 0;
+
+    // A missing tag is not an error, older parameter files simply run every task at Ts
+    iError = par_readline_i( fidInFile, fidOutFile, iRate, cTagRef );
+    if ( iError < 0 ) return MCU_OK;
+
+    // Keep the divisor positive and the phase offset within [0,divisor)
+    if ( iRate[0] < 1 ) {
+        fprintf( fidOutFile, "[ERROR] Tag %s has a rate divisor smaller than 1\n", cTagRef );
+        iRate[0] = 1;
+        iError  += 1;
+    }
+    iRate[1] = ( ( iRate[1] % iRate[0] ) + iRate[0] ) % iRate[0];
+
+    return iError;
+
+} /* end par_readline_rate() */
+
+/* ---------------------------------------------------------------------------------
+ Skip the blanks up to the next character
+--------------------------------------------------------------------------------- */
+static void par_skipblank( FILE * fid )
 {
+	int c;
 
-	// Reads the first non-blank char as the 'type' of the input on current line (i.e. 'I' or 'D')
-	fscanf( fid, "%c ", cType );
-	char tmp;
+	while ( ( c = getc( fid ) ) != EOF && isspace( c ) );
+	if ( c != EOF ) ungetc( c, fid );
 
-	switch ( *cType ) {
+} /* end par_skipblank() */
+
+/* ---------------------------------------------------------------------------------
+ Find the start of the line
+--------------------------------------------------------------------------------- */
+void par_findstart( FILE * fid, char * cType )
+{
+	int c;
 
-	case '*' :    // Indicates a comment
-		tmp = '0';
+	// Reads the first non-blank char as the 'type' of the input on current line (i.e. 'I' or 'D'),
+	// character by character with getc() instead of fscanf() as the comments make up most of the file
+	while ( ( c = getc( fid ) ) != EOF ) {
 
-		while ( tmp != '*' )  // While comment not finished discard chars
-			fscanf( fid, "%c ", &tmp );
+		par_skipblank( fid );
+		*cType = (char) c;
 
-		par_findstart( fid, cType );
+		if ( c != '*' ) return;  // If cType is valid then return it
 
-		break;
+		// Indicates a comment, discard chars until it is finished. An unfinished comment returns '*'.
+		while ( ( c = getc( fid ) ) != EOF && c != '*' );
+		if ( c == EOF ) return;
 
-	default:  // If cType is valid then return it
-		return;
+		par_skipblank( fid );
 	}
 
 } /* end par_findstart() */
@@ -181,7 +181,7 @@ int par_readline_txt_d(  text_struct * iText, REAL * dData, const char * cTagRef
             for ( k = 0; k < N; ++k )
             {
                 consumed  = 0;
-                sscanf( &iText->alltext[iText->position], "%lf %n",   dData+k, &consumed );
+                sscanf( &iText->alltext[iText->position], R_FMT " %n", dData+k, &consumed );
                 iText->position += consumed;
                 iError += par_convert_d( cUnit, dData+k ) ;
             }
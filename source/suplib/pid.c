@@ -12,7 +12,8 @@
 
 #include "./matrix.h"
 #include "./system.h"
-#include "./PID.h"
+#include "./pid.h"
+#include "./health.h"
 
 /* ---------------------------------------------------------------------------------
    Memory functions 
@@ -78,6 +79,36 @@ PID * pid_initEmpty( )
 }
     
     
+/* Carve a PID struct from an arena, the matrices follow the struct */
+PID * pid_carve( mem_arena * a )
+{
+    PID    * new_pid     = (PID*) arena_carve( a, sizeof(PID) );
+    matrix * gains       = mat_carve( a, PID_NGAINS, 1 );
+    matrix * constraints = mat_carve( a, PID_NCONSTRAINTS, 1 );
+    matrix * state       = mat_carve( a, PID_NINTERNALSTATES, 1 );
+    matrix * ulast       = mat_carve( a, PID_NOUTPUTS, 1 );
+    matrix * dulast      = mat_carve( a, PID_NOUTPUTS, 1 );
+
+    if ( new_pid != NULL ) {
+        new_pid->gains       = gains;
+        new_pid->constraints = constraints;
+        new_pid->state       = state;
+        new_pid->ulast       = ulast;
+        new_pid->dulast      = dulast;
+    }
+    return new_pid;
+}
+
+/* Generate a new empty PID struct in an arena of zeroed memory */
+PID * pid_initArena( mem_arena * a )
+{
+    PID * new_pid = pid_carve( a );
+
+    if ( new_pid != NULL ) new_pid->Ts = EPS;
+
+    return new_pid;
+}
+    
 /* Free the memory allocated to the controller struct */    
 int pid_free( PID * controller )
 {
@@ -117,10 +148,11 @@ int pid_output_mat( const PID    * controller, /* [IN]  Controller struct */
     /* *du   = Kp*( err-erkm1 ) + KI*erkm1 + KD*( err-2*erkm1-erkm2 );	*/
     
     
+    /* A row vector is stored identically in row and column major order, so the 
+       array can be used directly as the matrix memory */
     REAL AArray[3] = { err->Mat[0] - erkm1, erkm1, err->Mat[0] - (R_(2.0)*erkm1) - erkm2 };
-    matrix * A = mat_init( AArray, 1, 3 );
-    iError += mat_mult( A, controller->gains, du );
-    iError += mat_free(A);	
+    matrix A = mat_stackinit( 1, 3, AArray );
+    iError += mat_mult( &A, controller->gains, du );
     
     /* Apply speed constraints */
     REAL duScalar = du->Mat[0];
@@ -139,6 +171,13 @@ int pid_output_mat( const PID    * controller, /* [IN]  Controller struct */
     
     /* Update internal PID state for next call */
     REAL s[2] = { err->Mat[0], erkm1 };
+    
+    /* A non-finite error resets the state, the output is held */
+    if ( health_guard( s, PID_NINTERNALSTATES, HEALTH_PID_RESET ) ) {
+        s[0] = s[1] = R_(0.0);
+        du->Mat[0]  = R_(0.0);
+    }
+    
     iError += mat_setArray( controller->state, s, PID_NINTERNALSTATES, 1 );
     
     /* Store the current values as the last */
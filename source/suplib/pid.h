@@ -163,6 +163,10 @@ typedef struct PID
     matrix * dulast         ;   //!< Previous controller output \f$\Delta u_{k-1}\f$. 
 
 } PID;
+
+//! Bytes which pid_carve() takes from an arena.
+#define PID_ARENA_SIZE      ( ARENA_SIZE( sizeof(PID) ) + MAT_ARENA_SIZE( PID_NGAINS, 1 ) + MAT_ARENA_SIZE( PID_NCONSTRAINTS, 1 ) + \
+    MAT_ARENA_SIZE( PID_NINTERNALSTATES, 1 ) + 2 * MAT_ARENA_SIZE( PID_NOUTPUTS, 1 ) )
 #endif
 
 /* ------------------------------------------------------------------------------ */
@@ -196,6 +200,23 @@ PID * pid_init( const matrix * gains, const matrix * constraints, const REAL Ts
 */
 PID * pid_initEmpty( );
 
+//! Carve a PID struct from an arena.
+/*!
+    The matrices follow the PID struct. Only the pointers are set, carving 
+    again on a copy of the arena restores them, see \ref arena.
+
+    \return     The PID, NULL if the arena only counts. It is released with the arena.
+*/
+PID * pid_carve( mem_arena * a );
+
+//! Generate a new empty (=zero) PID struct in an arena.
+/*!
+    As pid_initEmpty(), the arena needs to be zeroed memory.
+
+    \return     The PID, NULL if the arena only counts. It is released with the arena.
+*/
+PID * pid_initArena( mem_arena * a );
+
 //! Free the memory allocated to the controller struct.
 /*!
     \param controller   A pointer to a PID struct of which the memory should be released.
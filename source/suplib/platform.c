@@ -0,0 +1,235 @@
+/* ---------------------------------------------------------------------------------
+ *          file : platform.c                                                     *
+ *   description : C-source file, operating system dependent services             *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifdef _WIN32
+#define _WIN32_WINNT    0x0500
+#define _WIN32_IE       0x0500
+#include <windows.h>
+#include <shlobj.h>
+#include <malloc.h>
+#else
+#include <dlfcn.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2_MATH__)
+#define PLAT_FPU_SSE
+#include <xmmintrin.h>
+#elif defined(__aarch64__)
+#define PLAT_FPU_FPCR
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "./../signals/signal_definitions_internal.h"
+
+#include "./platform.h"
+
+/* ---------------------------------------------------------------------------------
+ External libraries
+--------------------------------------------------------------------------------- */
+void * plat_library_open( const char * cFile )
+{
+    if ( cFile == NULL || cFile[0] == '\0' ) return NULL;
+#ifdef _WIN32
+    return (void*) LoadLibraryA( cFile );
+#else
+    return dlopen( cFile, RTLD_NOW | RTLD_LOCAL );
+#endif
+}
+
+void * plat_library_symbol( void * vpLib, const char * cName )
+{
+    if ( vpLib == NULL ) return NULL;
+#ifdef _WIN32
+    return (void*) GetProcAddress( (HMODULE) vpLib, cName );
+#else
+    return dlsym( vpLib, cName );
+#endif
+}
+
+int plat_library_close( void * vpLib )
+{
+    if ( vpLib == NULL ) return MCU_OK;
+#ifdef _WIN32
+    return FreeLibrary( (HMODULE) vpLib ) ? MCU_OK : MCU_ERR;
+#else
+    return ( dlclose( vpLib ) == 0 ) ? MCU_OK : MCU_ERR;
+#endif
+}
+
+const char * plat_library_error( void )
+{
+#ifdef _WIN32
+    static char cError[ 32 ];
+    sprintf( cError, "error code %lu", (unsigned long) GetLastError( ) );
+    return cError;
+#else
+    const char * cError = dlerror( );
+    return ( cError != NULL ) ? cError : "no error";
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+ Special folders
+--------------------------------------------------------------------------------- */
+#ifndef _WIN32
+static int plat_isdir( const char * cPath )
+{
+    struct stat st;
+    return ( stat( cPath, &st ) == 0 && S_ISDIR( st.st_mode ) );
+}
+#endif
+
+int plat_folder( const int iFolder, char * cPath, const size_t nPath )
+{
+    char cFound[ FILENAMESIZE ] = "";
+
+#ifdef _WIN32
+    char cWin[ MAX_PATH+1 ];
+    int  iCSIDL = ( iFolder == PLAT_FOLDER_DOCUMENTS ) ? CSIDL_PERSONAL : CSIDL_DESKTOPDIRECTORY;
+
+    if ( iFolder == PLAT_FOLDER_TEMP ) {
+        DWORD n = GetTempPathA( MAX_PATH, cWin );
+        if ( n > 0 && n <= MAX_PATH ) {
+            if ( cWin[ n-1 ] == '\\' ) cWin[ n-1 ] = '\0';
+            strncpy( cFound, cWin, FILENAMESIZE-1 );
+        }
+    }
+    else if ( SHGetSpecialFolderPathA( HWND_DESKTOP, cWin, iCSIDL, FALSE ) )
+        strncpy( cFound, cWin, FILENAMESIZE-1 );
+#else
+    const char * cHome = getenv( "HOME" );
+    const char * cEnv;
+
+    switch ( iFolder ) {
+        case PLAT_FOLDER_DESKTOP   : { cEnv = getenv( "XDG_DESKTOP_DIR"   ); break; }
+        case PLAT_FOLDER_DOCUMENTS : { cEnv = getenv( "XDG_DOCUMENTS_DIR" ); break; }
+        default                    : { cEnv = getenv( "TMPDIR"            ); break; }
+    }
+
+    if ( cEnv != NULL && plat_isdir( cEnv ) )
+        strncpy( cFound, cEnv, FILENAMESIZE-1 );
+    else if ( iFolder == PLAT_FOLDER_TEMP )
+        strcpy( cFound, "/tmp" );
+    else if ( cHome != NULL ) {
+        /* Desktop or Documents in the home directory, or the home directory itself */
+        snprintf( cFound, FILENAMESIZE, "%s/%s", cHome, ( iFolder == PLAT_FOLDER_DESKTOP ) ? "Desktop" : "Documents" );
+        if ( !plat_isdir( cFound ) ) strncpy( cFound, cHome, FILENAMESIZE-1 );
+    }
+#endif
+
+    cFound[ FILENAMESIZE-1 ] = '\0';
+
+    if ( cFound[0] == '\0' || strlen( cFound ) >= nPath ) {
+        if ( nPath > 1 ) strcpy( cPath, "." );
+        return MCU_ERR;
+    }
+
+    strcpy( cPath, cFound );
+    return MCU_OK;
+}
+
+/* ---------------------------------------------------------------------------------
+ Time
+--------------------------------------------------------------------------------- */
+struct tm * plat_gmtime( const time_t * tTime, struct tm * tmTime )
+{
+#ifdef _WIN32
+    /* The result of gmtime() is thread local in the Microsoft runtime */
+    struct tm * tmStatic = gmtime( tTime );
+    if ( tmStatic == NULL ) return NULL;
+    *tmTime = *tmStatic;
+    return tmTime;
+#else
+    return gmtime_r( tTime, tmTime );
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+ Memory aligned to a cache line
+--------------------------------------------------------------------------------- */
+void * plat_aligned_calloc( const size_t nSize )
+{
+    void * vp = NULL;
+
+#if defined(DOTXSTATICMEM)
+    /* Every slot of the static pools starts on a cache line */
+    vp = calloc( 1, nSize );
+#elif defined(_WIN32)
+    vp = _aligned_malloc( nSize, PLAT_CACHELINE );
+#else
+    if ( posix_memalign( &vp, PLAT_CACHELINE, nSize ) != 0 ) vp = NULL;
+#endif
+
+    if ( vp != NULL ) memset( vp, 0, nSize );
+#if defined(DOTXALLOCAUDIT) && !defined(DOTXSTATICMEM)
+    alloc_other( vp, nSize, __FILE__, __LINE__ );
+#endif
+    return vp;
+}
+
+void plat_aligned_free( void * vp )
+{
+#if defined(_WIN32) && !defined(DOTXSTATICMEM)
+#ifdef DOTXALLOCAUDIT
+    alloc_other( vp, 0, __FILE__, __LINE__ );
+#endif
+    _aligned_free( vp );
+#else
+    free( vp );
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+ Floating-point mode
+--------------------------------------------------------------------------------- */
+#define PLAT_MXCSR_FTZ  0x8000UL    /* SSE: flush results to zero */
+#define PLAT_MXCSR_DAZ  0x0040UL    /* SSE: treat subnormal inputs as zero */
+#define PLAT_FPCR_FZ    ( 1UL << 24 )   /* AArch64: flush inputs and results to zero */
+
+int plat_fpu_flush( unsigned long * pMode )
+{
+    *pMode = 0UL;
+
+#if defined(DOTXNOFTZ)
+    return FALSE;
+#elif defined(PLAT_FPU_SSE)
+    *pMode = (unsigned long) _mm_getcsr( );
+    _mm_setcsr( (unsigned int)( *pMode | PLAT_MXCSR_FTZ | PLAT_MXCSR_DAZ ) );
+    return TRUE;
+#elif defined(PLAT_FPU_FPCR)
+    unsigned long iFPCR;
+    __asm__ __volatile__( "mrs %0, fpcr" : "=r" ( iFPCR ) );
+    __asm__ __volatile__( "msr fpcr, %0" : : "r" ( iFPCR | PLAT_FPCR_FZ ) );
+    *pMode = iFPCR;
+    return TRUE;
+#else
+    /* E.g. the x87 unit of a 32-bit build without SSE math */
+    return FALSE;
+#endif
+}
+
+void plat_fpu_restore( const unsigned long iMode )
+{
+#if defined(DOTXNOFTZ)
+    (void) iMode;
+#elif defined(PLAT_FPU_SSE)
+    _mm_setcsr( (unsigned int) iMode );
+#elif defined(PLAT_FPU_FPCR)
+    __asm__ __volatile__( "msr fpcr, %0" : : "r" ( iMode ) );
+#else
+    (void) iMode;
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+  end platform.c
+--------------------------------------------------------------------------------- */
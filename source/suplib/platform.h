@@ -0,0 +1,154 @@
+/* ---------------------------------------------------------------------------------
+ *          file : platform.h                                                     *
+ *   description : C-header file, operating system dependent services             *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _PLATFORM_H_
+#define _PLATFORM_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup suplib
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup platform Platform abstraction
+
+    The controller is built as a Windows DLL (make_mcu.mk, MinGW) and as a
+    Linux shared object and static library (make_linux.mk). The few services
+    which differ between the two are collected here:
+
+    - the attributes of the exported entry points (#DOTX_EXPORT, #DOTX_CDECL);
+    - the path separator (#PLAT_PATHSEP);
+    - loading an external library at run time, e.g. the DNPC module or the GUI
+      interface server: plat_library_open(), plat_library_symbol() and
+      plat_library_close() wrap LoadLibrary/GetProcAddress/FreeLibrary and
+      dlopen/dlsym/dlclose;
+    - the special folders of the user: plat_folder() wraps
+      SHGetSpecialFolderPath on Windows and follows the XDG conventions on
+      Linux, falling back to the home directory;
+    - a thread safe gmtime(), plat_gmtime(), for the parameter files which
+      are read in parallel;
+    - memory aligned to a cache line (#PLAT_CACHELINE) for the structs which
+      are split in hot and cold blocks: plat_aligned_calloc() and
+      plat_aligned_free() wrap _aligned_malloc/_aligned_free and
+      posix_memalign/free;
+    - the floating-point mode of the processor: plat_fpu_flush() flushes
+      subnormal numbers to zero during a controller sample (FTZ and DAZ of SSE
+      on x86, FZ on AArch64) and plat_fpu_restore() restores the mode of the
+      host afterwards.
+
+    The library functions are only called during initialization and exit.
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  platform.h
+    \brief This header file contains the operating system dependent services.
+*/
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+#ifdef _WIN32
+#define DOTX_EXPORT     __declspec(dllexport)                   //!< Attribute of an exported entry point.
+#define DOTX_CDECL      __cdecl                                 //!< Calling convention of an exported entry point.
+#define PLAT_PATHSEP    "\\"                                    //!< Separator of the directories in a path.
+#else
+#define DOTX_EXPORT     __attribute__((visibility("default")))  //!< Attribute of an exported entry point.
+#define DOTX_CDECL                                              //!< Calling convention of an exported entry point.
+#define PLAT_PATHSEP    "/"                                     //!< Separator of the directories in a path.
+#endif
+
+#define PLAT_CACHELINE  64                                      //!< Size of a cache line [bytes], the alignment of plat_aligned_calloc().
+
+//! Special folders of the user, see plat_folder().
+enum plat_folders {
+    PLAT_FOLDER_DESKTOP     ,   //!< Desktop of the user.
+    PLAT_FOLDER_DOCUMENTS   ,   //!< Documents of the user.
+    PLAT_FOLDER_TEMP            //!< Directory for temporary files.
+};
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+#include <stddef.h>
+#include <time.h>
+
+//! Load an external library.
+/*!
+    \param cFile    [in]    File name of the library (.dll or .so).
+    \return         Handle of the library, NULL if it could not be loaded.
+*/
+void * plat_library_open( const char * cFile );
+
+//! Address of a function exported by a library loaded with plat_library_open().
+/*!
+    \param vpLib    [in]    Handle of the library.
+    \param cName    [in]    Name of the function.
+    \return         Address of the function, NULL if it is not exported.
+*/
+void * plat_library_symbol( void * vpLib, const char * cName );
+
+//! Release a library loaded with plat_library_open(), a NULL handle is ignored.
+int plat_library_close( void * vpLib );
+
+//! Description of the last failure of the library functions.
+const char * plat_library_error( void );
+
+//! Path of a special folder of the user, without trailing separator.
+/*!
+    \param iFolder  [in]    The folder, see #plat_folders.
+    \param cPath    [out]   The path.
+    \param nPath    [in]    Size of cPath.
+    \return         A non zero int will be returned in the case an error occurred, cPath is "." then.
+*/
+int plat_folder( const int iFolder, char * cPath, const size_t nPath );
+
+//! Thread safe version of gmtime().
+/*!
+    \param tTime    [in]    The time.
+    \param tmTime   [out]   The time in UTC.
+    \return         tmTime, NULL if the time can not be converted.
+*/
+struct tm * plat_gmtime( const time_t * tTime, struct tm * tmTime );
+
+//! Allocate zeroed memory which starts on a cache line.
+/*!
+    \param nSize    [in]    Size of the memory [bytes].
+    \return         The memory, NULL if it could not be allocated. Release it with plat_aligned_free().
+*/
+void * plat_aligned_calloc( const size_t nSize );
+
+//! Release memory allocated with plat_aligned_calloc(), a NULL pointer is ignored.
+void plat_aligned_free( void * vp );
+
+//! Flush subnormal numbers to zero in the calling thread, see \ref health.
+/*!
+    Without support by the processor, or when compiled with DOTXNOFTZ, the
+    mode is not changed.
+
+    \param pMode    [out]   Floating-point mode before the call, for plat_fpu_restore().
+    \return         TRUE if subnormal numbers are flushed to zero.
+*/
+int plat_fpu_flush( unsigned long * pMode );
+
+//! Restore the floating-point mode saved by plat_fpu_flush() (only called if it returned TRUE).
+void plat_fpu_restore( const unsigned long iMode );
+
+#endif
+
+/** @}*/
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _PLATFORM_H_
+--------------------------------------------------------------------------------- */
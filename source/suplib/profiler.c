@@ -0,0 +1,195 @@
+/* ---------------------------------------------------------------------------------
+ *          file : profiler.c                                                     *
+ *   description : C-source file, cycle-time profiler of the controller stages    *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "./../signals/signal_definitions_internal.h"
+
+#include "./profiler.h"
+
+/* Data of the instance which is stepped by the calling thread */
+static _Thread_local prof_data * pProf = NULL;
+
+static const char * cStageNames[ PROF_NSTAGES ] = {
+    "total"         ,
+    "supervisory"   ,
+    "operation"     ,
+    "basecontroller",
+    "filters"       ,
+    "rotorspeed"    ,
+    "dtdamp"        ,
+    "fadamp"        ,
+    "yaw"           ,
+    "postprocedure" ,
+    "simulation"    ,
+    "logdata"
+};
+
+/* ---------------------------------------------------------------------------------
+ Monotonic clock in nanoseconds
+--------------------------------------------------------------------------------- */
+unsigned long long prof_clock( void )
+{
+#ifdef _WIN32
+    static LARGE_INTEGER liFreq = { { 0, 0 } };
+    LARGE_INTEGER liCount;
+    if ( liFreq.QuadPart == 0 ) QueryPerformanceFrequency( &liFreq );
+    QueryPerformanceCounter( &liCount );
+    return (unsigned long long) ( (double)liCount.QuadPart * 1e9 / (double)liFreq.QuadPart );
+#else
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+/* ---------------------------------------------------------------------------------
+ Histogram buckets: linear below PROF_NLINEAR ns, PROF_NSUB buckets per octave above
+--------------------------------------------------------------------------------- */
+static int prof_bucket( const unsigned long long t )
+{
+    int e = 0;
+    unsigned long long v = t;
+
+    if ( t < PROF_NLINEAR ) return (int)t;
+
+    /* Octave of the duration, e >= 4 */
+    while ( v >>= 1 ) ++e;
+
+    return MIN( PROF_NBUCKETS - 1, PROF_NLINEAR + ( e - 4 ) * PROF_NSUB + (int)( ( t >> ( e - 3 ) ) & ( PROF_NSUB - 1 ) ) );
+}
+
+/* Largest duration which falls in bucket b */
+static unsigned long long prof_upper( const int b )
+{
+    int e, s;
+
+    if ( b < PROF_NLINEAR ) return (unsigned long long)b;
+
+    e = 4 + ( b - PROF_NLINEAR ) / PROF_NSUB;
+    s =     ( b - PROF_NLINEAR ) % PROF_NSUB;
+
+    return ( (unsigned long long)( PROF_NSUB + s + 1 ) << ( e - 3 ) ) - 1;
+}
+
+/* ---------------------------------------------------------------------------------
+ Recording
+--------------------------------------------------------------------------------- */
+void prof_select( prof_data * prof, const int iRecord )
+{
+    pProf = prof;
+    if ( prof != NULL ) prof->iRecord = iRecord;
+}
+
+void prof_begin( const int iStage )
+{
+    if ( pProf == NULL || !pProf->iRecord ) return;
+    pProf->tStart[ iStage ] = prof_clock( );
+}
+
+void prof_end( const int iStage )
+{
+    if ( pProf == NULL || !pProf->iRecord ) return;
+
+    prof_record( iStage, prof_clock( ) - pProf->tStart[ iStage ] );
+}
+
+void prof_record( const int iStage, const unsigned long long t )
+{
+    if ( pProf == NULL || !pProf->iRecord ) return;
+
+    if ( pProf->nCount[ iStage ] == 0 || t < pProf->tMin[ iStage ] ) pProf->tMin[ iStage ] = t;
+    if ( t > pProf->tMax[ iStage ] ) pProf->tMax[ iStage ] = t;
+    pProf->tSum  [ iStage ] += t;
+    pProf->nCount[ iStage ] += 1;
+    pProf->nHist [ iStage ][ prof_bucket( t ) ] += 1;
+}
+
+void prof_reset( prof_data * prof )
+{
+    int iRecord = prof->iRecord;
+    memset( prof, 0, sizeof(prof_data) );
+    prof->iRecord = iRecord;
+}
+
+/* ---------------------------------------------------------------------------------
+ Reporting
+--------------------------------------------------------------------------------- */
+
+/* Smallest duration below which the given fraction of the samples lies, the upper 
+   edge of the bucket is bounded by the largest duration */
+static REAL prof_percentile( const prof_data * prof, const int iStage, const REAL dFrac )
+{
+    int b;
+    unsigned long long n = 0;
+    unsigned long long nTarget = (unsigned long long) ceil( dFrac * (REAL)prof->nCount[ iStage ] );
+
+    for ( b = 0; b < PROF_NBUCKETS; ++b ) {
+        n += prof->nHist[ iStage ][ b ];
+        if ( n >= MAX( 1ULL, nTarget ) ) 
+            return R_(1e-3) * (REAL) MIN( prof_upper( b ), prof->tMax[ iStage ] );
+    }
+
+    return R_(1e-3) * (REAL) prof->tMax[ iStage ];
+}
+
+int prof_summarize( const prof_data * prof, const int iStage, prof_summary * pSummary )
+{
+    if ( iStage < 0 || iStage >= PROF_NSTAGES ) return MCU_ERR;
+
+    memset( pSummary, 0, sizeof(prof_summary) );
+    pSummary->nCount = prof->nCount[ iStage ];
+    if ( pSummary->nCount == 0 ) return MCU_OK;
+
+    pSummary->dMin  = R_(1e-3) * (REAL) prof->tMin[ iStage ];
+    pSummary->dP50  = prof_percentile( prof, iStage, R_(0.5)   );
+    pSummary->dP99  = prof_percentile( prof, iStage, R_(0.99)  );
+    pSummary->dP999 = prof_percentile( prof, iStage, R_(0.999) );
+    pSummary->dMax  = R_(1e-3) * (REAL) prof->tMax[ iStage ];
+    pSummary->dMean = R_(1e-3) * (REAL) prof->tSum[ iStage ] / (REAL) prof->nCount[ iStage ];
+
+    return MCU_OK;
+}
+
+const char * prof_stagename( const int iStage )
+{
+    if ( iStage < 0 || iStage >= PROF_NSTAGES ) return "";
+    return cStageNames[ iStage ];
+}
+
+int prof_write( const prof_data * prof, const char * cFile )
+{
+    int k, iError = MCU_OK;
+    prof_summary S;
+
+    FILE * fid = fopen( cFile, "w" );
+    if ( fid == NULL ) return MCU_ERR;
+
+    fprintf( fid, "stage\tsamples\tmin[us]\tp50[us]\tp99[us]\tp99.9[us]\tmax[us]\tmean[us]\n" );
+
+    for ( k = 0; k < PROF_NSTAGES; ++k ) {
+        iError += prof_summarize( prof, k, &S );
+        if ( S.nCount == 0 ) continue;
+        fprintf( fid, "%s\t%llu\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\n", prof_stagename( k ), 
+                    S.nCount, S.dMin, S.dP50, S.dP99, S.dP999, S.dMax, S.dMean );
+    }
+
+    fclose( fid );
+
+    return iError;
+}
+
+/* ---------------------------------------------------------------------------------
+  end profiler.c
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,174 @@
+/* ---------------------------------------------------------------------------------
+ *          file : profiler.h                                                     *
+ *   description : C-header file, cycle-time profiler of the controller stages    *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup suplib 
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup profiler Cycle-time profiler
+
+    When compiled with DOTXPROFILER, every stage of a controller sample is
+    timestamped with a monotonic high-resolution clock. The stages nest: the
+    total sample contains the operation module, which contains the base
+    controller, which contains the filter chains, the rotor speed controller,
+    the damping controllers and the yaw controller.
+
+    Only run samples are recorded, initialization and exit involve file I/O.
+    For each stage a histogram with logarithmic buckets (8 per octave, i.e. a
+    resolution of at most 12.5%) is kept, from which the minimum, median, 99th
+    and 99.9th percentile and maximum are derived. At #MCU_STATUS_EXIT the
+    summary is written to a tab separated file next to the log file, and during
+    the simulation it is available through mcu_instance_profile().
+
+    A stage is marked in the code with DotxProfBegin() and DotxProfEnd(). The
+    data of the instance being stepped is selected per thread by prof_select(),
+    so the stages deep inside the base controller need no extra arguments.
+
+    Without DOTXPROFILER the markers expand to nothing.
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  profiler.h
+    \brief This header file contains the cycle-time profiler of the controller stages.
+*/
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+//! Stages of a controller sample which are timed separately.
+enum prof_stage {
+    PROF_TOTAL              ,   //!< Complete sample of mcu_instance_step().
+    PROF_SUPERVISORY        ,   //!< Supervisory module.
+    PROF_OPERATION          ,   //!< Operation module (includes the base controller).
+    PROF_BASECONTROLLER     ,   //!< Base controller.
+    PROF_FILTERS            ,   //!< Filter chains of the base controller.
+    PROF_ROTORSPEED         ,   //!< Rotor speed controller.
+    PROF_DTDAMP             ,   //!< Drive train damping.
+    PROF_FADAMP             ,   //!< Fore-aft tower damping.
+    PROF_YAW                ,   //!< Yaw control.
+    PROF_POSTPROCEDURE      ,   //!< Supervisory post procedure.
+    PROF_SIMULATION         ,   //!< Simulation module.
+    PROF_LOGDATA            ,   //!< Logging of the data.
+    PROF_NSTAGES                //!< Number of stages.
+};
+
+#define PROF_NLINEAR    16                          //!< Durations below this number of nanoseconds have their own bucket.
+#define PROF_NSUB       8                           //!< Number of buckets per octave.
+#define PROF_NBUCKETS   ( PROF_NLINEAR + 36*PROF_NSUB ) //!< Number of buckets, covers up to 2^40 ns (about 18 minutes).
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_STRUCTS
+
+/*! \struct prof_data
+    \brief  Histograms of the cycle times of all stages of one controller instance.
+ */
+typedef struct prof_data {
+
+    unsigned long long  tStart  [ PROF_NSTAGES ]                    ;   //!< Start of the current measurement [ns].
+    unsigned long long  nCount  [ PROF_NSTAGES ]                    ;   //!< Number of measurements.
+    unsigned long long  tMin    [ PROF_NSTAGES ]                    ;   //!< Smallest duration [ns].
+    unsigned long long  tMax    [ PROF_NSTAGES ]                    ;   //!< Largest duration [ns].
+    unsigned long long  tSum    [ PROF_NSTAGES ]                    ;   //!< Sum of the durations [ns].
+    unsigned int        nHist   [ PROF_NSTAGES ][ PROF_NBUCKETS ]   ;   //!< Histogram of the durations.
+    int                 iRecord                                     ;   //!< Flag indicating that the current sample is recorded.
+
+} prof_data;
+
+/*! \struct prof_summary
+    \brief  Summary of the cycle times of one stage, all times in microseconds.
+ */
+typedef struct prof_summary {
+
+    unsigned long long  nCount  ;   //!< Number of recorded samples.
+    REAL                dMin    ;   //!< Smallest cycle time.
+    REAL                dP50    ;   //!< Median cycle time.
+    REAL                dP99    ;   //!< 99th percentile.
+    REAL                dP999   ;   //!< 99.9th percentile.
+    REAL                dMax    ;   //!< Largest cycle time.
+    REAL                dMean   ;   //!< Mean cycle time.
+
+} prof_summary;
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+#ifdef DOTXPROFILER
+
+#define DotxProfSelect(prof,rec)    prof_select(prof,rec)   //!< Select the data of the instance which is stepped.
+#define DotxProfBegin(stage)        prof_begin(stage)       //!< Mark the start of a stage.
+#define DotxProfEnd(stage)          prof_end(stage)         //!< Mark the end of a stage.
+#define DotxProfRecord(stage,t)     prof_record(stage,t)    //!< Add a duration which is measured by the caller.
+
+#else
+
+// No profiling, expand to nothing
+#define DotxProfSelect(prof,rec)
+#define DotxProfBegin(stage)
+#define DotxProfEnd(stage)
+#define DotxProfRecord(stage,t)
+
+#endif
+
+//! Select the data which records the stages of the calling thread.
+/*!
+    \param prof     [in+out]    Data of the instance which is about to be stepped, NULL disables recording.
+    \param iRecord  [in]        Flag indicating whether the sample should be recorded.
+*/
+void prof_select( prof_data * prof, const int iRecord );
+
+void prof_begin( const int iStage );    //!< Start timing a stage.
+void prof_end  ( const int iStage );    //!< Stop timing a stage and add the duration to its histogram.
+void prof_record( const int iStage, const unsigned long long t );   //!< Add a duration [ns] to the histogram of a stage, e.g. of an instance of a batch.
+
+//! Reset all histograms.
+void prof_reset( prof_data * prof );
+
+//! Monotonic clock [ns], also available without DOTXPROFILER (used by the load shedding of the MCU).
+unsigned long long prof_clock( void );
+
+//! Summarize the histogram of a stage.
+/*!
+    \param prof     [in]    The profiler data.
+    \param iStage   [in]    The stage, see #prof_stage.
+    \param pSummary [out]   The summary.
+    \return         A non zero int will be returned in the case an error occurred.
+*/
+int prof_summarize( const prof_data * prof, const int iStage, prof_summary * pSummary );
+
+//! Name of a stage.
+const char * prof_stagename( const int iStage );
+
+//! Write the summary of all stages to a tab separated file.
+/*!
+    \param prof     [in]    The profiler data.
+    \param cFile    [in]    Name of the file.
+    \return         A non zero int will be returned in the case an error occurred.
+*/
+int prof_write( const prof_data * prof, const char * cFile );
+
+#endif
+
+/** @}*/
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _PROFILER_H_
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,167 @@
+/* ---------------------------------------------------------------------------------
+ *          file : staticmem.c                                                    *
+ *   description : C-source file, static memory pools instead of the heap         *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#define _STATICMEM_C_
+
+#include "./../signals/signal_definitions_internal.h"
+
+#include "./staticmem.h"
+
+#ifdef DOTXSTATICMEM
+
+#include <stdatomic.h>
+
+/* Largest request which is larger than the slots of every pool, since the last check */
+static _Atomic size_t nUnfit = 0;
+
+/* ---------------------------------------------------------------------------------
+ Claim a free slot of the smallest pool in which the request fits
+--------------------------------------------------------------------------------- */
+static void * mem_claim( const size_t nSize )
+{
+    size_t nTried = 0;
+    int    k, i, iBest;
+
+    for ( ;; ) {
+
+        /* The next larger pool in which the request fits */
+        iBest = -1;
+        for ( k = 0; k < mem_npools; ++k ) {
+            if ( mem_pools[k].nSlot < nSize || mem_pools[k].nSlot <= nTried ) continue;
+            if ( iBest < 0 || mem_pools[k].nSlot < mem_pools[iBest].nSlot ) iBest = k;
+        }
+        if ( iBest < 0 ) break;
+
+        /* Pools of the same slot size are tried in the order of the table */
+        for ( k = iBest; k < mem_npools; ++k ) {
+            mem_pool * pool = &mem_pools[k];
+            if ( pool->nSlot != mem_pools[iBest].nSlot ) continue;
+            for ( i = 0; i < pool->nSlots; ++i ) {
+                if ( atomic_load_explicit( &pool->pUsed[i], memory_order_relaxed ) ) continue;
+                if ( atomic_exchange( &pool->pUsed[i], 1 ) ) continue;
+                memset( pool->pBase + (size_t)i * pool->nSlot, 0, nSize );
+                return pool->pBase + (size_t)i * pool->nSlot;
+            }
+        }
+        nTried = mem_pools[iBest].nSlot;
+    }
+
+    /* Record the failure at the smallest pool which would have fitted */
+    for ( k = 0, iBest = -1; k < mem_npools; ++k )
+        if ( mem_pools[k].nSlot >= nSize && ( iBest < 0 || mem_pools[k].nSlot < mem_pools[iBest].nSlot ) ) iBest = k;
+
+    if ( iBest >= 0 ) {
+        atomic_fetch_add( &mem_pools[iBest].nFailed, 1 );
+        if ( nSize > mem_pools[iBest].nLargest ) mem_pools[iBest].nLargest = nSize;
+    }
+    else {
+        size_t nOld = atomic_load( &nUnfit );
+        while ( nSize > nOld && !atomic_compare_exchange_weak( &nUnfit, &nOld, nSize ) );
+    }
+
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------------------
+ The pool and the slot of a pointer, NULL if it does not belong to a pool
+--------------------------------------------------------------------------------- */
+static mem_pool * mem_find( const void * ptr, int * iSlot )
+{
+    const char * p = (const char*) ptr;
+    int k;
+
+    for ( k = 0; k < mem_npools; ++k ) {
+        mem_pool * pool = &mem_pools[k];
+        if ( p >= pool->pBase && p < pool->pBase + (size_t)pool->nSlots * pool->nSlot ) {
+            *iSlot = (int)( ( p - pool->pBase ) / pool->nSlot );
+            return pool;
+        }
+    }
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------------------
+ Replacements of the heap functions
+--------------------------------------------------------------------------------- */
+void * mem_calloc( size_t n, size_t size )
+{
+    if ( size != 0 && n > (size_t)-1 / size ) return NULL;
+    return mem_claim( n * size );
+}
+
+void * mem_malloc( size_t size )
+{
+    return mem_claim( size );
+}
+
+void * mem_realloc( void * ptr, size_t size )
+{
+    mem_pool * pool;
+    void     * pNew;
+    int        i;
+
+    if ( ptr == NULL ) return mem_claim( size );
+    if ( size == 0 ) {
+        mem_free( ptr );
+        return NULL;
+    }
+
+    pool = mem_find( ptr, &i );
+    if ( pool == NULL ) return NULL;
+    if ( size <= pool->nSlot ) return ptr;
+
+    /* A larger slot, the old one is kept if there is none */
+    pNew = mem_claim( size );
+    if ( pNew != NULL ) {
+        memcpy( pNew, ptr, pool->nSlot );
+        mem_free( ptr );
+    }
+    return pNew;
+}
+
+void mem_free( void * ptr )
+{
+    mem_pool * pool;
+    int        i;
+
+    if ( ptr == NULL ) return;
+
+    pool = mem_find( ptr, &i );
+    if ( pool != NULL ) atomic_store( &pool->pUsed[i], 0 );
+}
+
+/* ---------------------------------------------------------------------------------
+ Report the requests which did not fit
+--------------------------------------------------------------------------------- */
+int mem_check( char * cMessage )
+{
+    size_t nSize;
+    int    k, nFailed, iError = MCU_OK;
+
+    for ( k = 0; k < mem_npools; ++k ) {
+        nFailed = atomic_exchange( &mem_pools[k].nFailed, 0 );
+        if ( nFailed == 0 ) continue;
+        sprintf( cMessage + strlen( cMessage ), "[mem]  Static pool %s exhausted: %d requests up to %lu bytes found none of its %d slots of %lu bytes free\t\n",
+            mem_pools[k].cName, nFailed, (unsigned long) mem_pools[k].nLargest, mem_pools[k].nSlots, (unsigned long) mem_pools[k].nSlot );
+        mem_pools[k].nLargest = 0;
+        iError = MCU_ERR;
+    }
+
+    nSize = atomic_exchange( &nUnfit, 0 );
+    if ( nSize > 0 ) {
+        sprintf( cMessage + strlen( cMessage ), "[mem]  Static pools: a request of %lu bytes is larger than the slots of every pool\t\n", (unsigned long) nSize );
+        iError = MCU_ERR;
+    }
+
+    return iError;
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+  end staticmem.c
+--------------------------------------------------------------------------------- */
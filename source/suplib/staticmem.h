@@ -0,0 +1,142 @@
+/* ---------------------------------------------------------------------------------
+ *          file : staticmem.h                                                    *
+ *   description : C-header file, static memory pools instead of the heap         *
+ *       toolbox : DotX Wind Turbine Control Software (support library)           *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+#ifndef _STATICMEM_H_
+#define _STATICMEM_H_
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup suplib
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+/** \addtogroup staticmem Static memory
+
+    Certified PLC targets and some real-time operating systems do not allow
+    dynamic memory at all. When compiled with DOTXSTATICMEM the controller
+    never calls the heap: calloc, malloc, realloc and free are routed to a
+    table of pools of static memory, as DOTXALLOCAUDIT routes them to its
+    counting functions (which then call the pools).
+
+    A pool is a number of slots of one size, both fixed at compile time. The
+    application defines the table #mem_pools with #MEM_STORAGE and #MEM_POOL,
+    for the controller in mcumemory.c, with the sizes derived from the data
+    structs (N_FILTERS, NR_BLADES, ...) and the number of instances. An
+    allocation takes a free slot of the smallest pool in which it fits, or of
+    the next larger pool when that one is full, a release returns the slot. Every slot starts on a cache line,
+    so the pools also serve plat_aligned_calloc().
+
+    A request for which no slot is free does not abort: it returns NULL, as
+    the heap would, and is recorded. mem_check() reports the recorded
+    requests, the MCU calls it after the constructors of its data structs and
+    fails the initialization with the name of the pool which is too small.
+
+    Only the translation units of the controller are routed to the pools. The
+    programs and interfaces around it (the real-time runner, the farm and the
+    wrappers) define _DOTX_HOST_ before the first include, they keep using the
+    heap of the process, which the pools are not sized for.
+
+    Without DOTXSTATICMEM this header expands to nothing.
+ *  @{*/
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FILES
+/*!
+    \file  staticmem.h
+    \brief This header file contains the static memory pools which replace the heap.
+*/
+#endif
+
+#ifdef DOTXSTATICMEM
+
+#include <stddef.h>
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_TYPES
+
+//! Size of a slot for objects of nSize bytes, a multiple of #PLAT_CACHELINE.
+#define MEM_SLOT( nSize )   ( ( (size_t)(nSize) + PLAT_CACHELINE - 1 ) / PLAT_CACHELINE * PLAT_CACHELINE )
+
+//! Define the static memory of a pool of nSlots slots for objects of nSize bytes, at file scope.
+#define MEM_STORAGE( pool, nSize, nSlots ) \
+    static _Alignas( PLAT_CACHELINE ) char  pool##_Mem [ nSlots ][ MEM_SLOT( nSize ) ]; \
+    static _Atomic int                      pool##_Used[ nSlots ]
+
+//! Entry of the table #mem_pools for a pool defined with #MEM_STORAGE.
+#define MEM_POOL( pool, cName ) \
+    { cName, sizeof( pool##_Mem[0] ), (int)( sizeof( pool##_Mem ) / sizeof( pool##_Mem[0] ) ), &pool##_Mem[0][0], pool##_Used, 0, 0 }
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_STRUCTS
+
+/*! \struct mem_pool
+    \brief  A pool of slots of one size in static memory.
+ */
+typedef struct mem_pool {
+
+    const char    * cName       ;   //!< Name of the pool in the diagnostics.
+    size_t          nSlot       ;   //!< Size of a slot [bytes].
+    int             nSlots      ;   //!< Number of slots.
+    char          * pBase       ;   //!< Memory of the slots, aligned to a cache line.
+    _Atomic int   * pUsed       ;   //!< Flag per slot: in use.
+    _Atomic int     nFailed     ;   //!< Requests which fitted in a slot but found none free, since the last mem_check().
+    size_t          nLargest    ;   //!< Largest of these requests [bytes].
+
+} mem_pool;
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_VARIABLES
+
+extern mem_pool     mem_pools[];    //!< The pools, defined by the application.
+extern const int    mem_npools;     //!< Number of pools in #mem_pools.
+
+#endif
+
+/* ------------------------------------------------------------------------------ */
+#ifndef DXG_SKIP_FUNCTIONS
+
+void * mem_calloc ( size_t n, size_t size );    //!< Replacement of calloc, a zeroed slot.
+void * mem_malloc ( size_t size );              //!< Replacement of malloc, a zeroed slot.
+void * mem_realloc( void * ptr, size_t size );  //!< Replacement of realloc, the slot is kept while the size fits.
+void   mem_free   ( void * ptr );               //!< Replacement of free, returns the slot.
+
+//! Report the requests which did not fit since the last call.
+/*!
+    For every pool which ran out of slots, and for requests which are larger
+    than the slots of every pool, a line is appended to the message. The
+    records are cleared.
+
+    \param cMessage [in+out]    The message.
+    \return         MCU_OK if every request was served, MCU_ERR otherwise.
+*/
+int mem_check( char * cMessage );
+
+#endif
+
+/* Route all heap operations of the controller to the pools, with DOTXALLOCAUDIT
+   through the counting functions. Host programs keep the heap of the process. */
+#if !defined(_STATICMEM_C_) && !defined(_DOTX_HOST_) && ( !defined(DOTXALLOCAUDIT) || defined(_ALLOCAUDIT_C_) )
+#define calloc(n,s)     mem_calloc ( (n), (s) )
+#define malloc(s)       mem_malloc ( (s)      )
+#define realloc(p,s)    mem_realloc( (p), (s) )
+#define free(p)         mem_free   ( (p)      )
+#endif
+
+#endif
+
+/** @}*/
+/** @}*/
+/* ------------------------------------------------------------------------------ */
+
+#endif
+
+/* ---------------------------------------------------------------------------------
+ End _STATICMEM_H_
+--------------------------------------------------------------------------------- */
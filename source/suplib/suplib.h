@@ -32,6 +32,10 @@ This is the documentation for the Support Library
 #include "./hp_pid.h"
 #include "./par.h"
 #include "./bicubic.h"
+#include "./profiler.h"
+#include "./checkpoint.h"
+#include "./fastmath.h"
+#include "./health.h"
 
 /** @}*/
 
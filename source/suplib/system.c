@@ -37,6 +37,27 @@ System * sys_init( const int Nstate, const int Nin, const int Nout )
     
 }
 
+/* Carve a system with empty matrices from an arena, the matrices follow the struct */
+System * sys_carve( mem_arena * a, const int Nstate, const int Nin, const int Nout )
+{
+    System * new_system = (System*) arena_carve( a, sizeof(System) );
+    matrix * A = mat_carve( a, Nstate, Nstate );
+    matrix * B = mat_carve( a, Nstate, Nin    );
+    matrix * C = mat_carve( a, Nout  , Nstate );
+    matrix * D = mat_carve( a, Nout  , Nin    );
+
+    if ( new_system != NULL ) {
+        new_system->Nstate = Nstate;
+        new_system->Nin    = Nin;
+        new_system->Nout   = Nout;
+        new_system->A = A;
+        new_system->B = B;
+        new_system->C = C;
+        new_system->D = D;
+    }
+    return new_system;
+}
+
 /* Initialize a system from the given matrices. */
 System * sys_initMat( const matrix * A, const matrix * B, const matrix * C, const matrix * D )
 {
@@ -57,6 +57,10 @@ typedef struct System {
     int      Nout   ;   /*!< The number of outputs out of the system. */  
     
 } System;
+
+//! Bytes which sys_carve() takes from an arena.
+#define SYS_ARENA_SIZE( Nstate, Nin, Nout ) ( ARENA_SIZE( sizeof(System) ) + \
+    MAT_ARENA_SIZE( Nstate, Nstate ) + MAT_ARENA_SIZE( Nstate, Nin ) + MAT_ARENA_SIZE( Nout, Nstate ) + MAT_ARENA_SIZE( Nout, Nin ) )
 #endif
 
 /* ------------------------------------------------------------------------------ */
@@ -79,6 +83,19 @@ typedef struct System {
  */
 System * sys_init( const int Nstate, const int Nin, const int Nout );
 
+//! Carve a system with empty matrices from an arena.
+/*!
+    The matrices follow the System struct, see mat_carve().
+    
+    \param a        The arena.
+    \param Nstate   The number of states the new system will have.
+    \param Nin      The number of inputs the new system will have.
+    \param Nout     The number of outputs the new system will have.
+    
+    \return     The system, NULL if the arena only counts. It is released with the arena.
+ */
+System * sys_carve( mem_arena * a, const int Nstate, const int Nin, const int Nout );
+
 //! Initialize a system from the given matrices.
 /*!
     The values of the given matrices are copied in to new instances referenced 
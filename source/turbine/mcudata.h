@@ -27,79 +27,70 @@
 
 /*! \struct mcu_data_static
     \brief Struct containing static data for the MCU. I.e. Controller parameters, etc.
+
+    The struct is split in two blocks, which both start on a cache line:
+
+    - the hot block holds the scalars and small arrays which the modules read
+      in the run samples, packed in as few cache lines as possible;
+    - the cold block holds the gain schedules and lookup tables, of which a
+      lookup only touches the first entries, and the configuration and
+      initialization-only data, e.g. the paths of the files.
+
+    The fields which each module of the run samples reads, and the block they
+    are in, are listed by the target mcusreport of make_linux.mk. A new
+    parameter goes in the hot block only when it is read in the run samples.
  */
 typedef struct mcu_data_static{
 
-    //! \name   Configuration settings
-    //@{
-    char      LogDir        [FILENAMESIZE]              ;   //!<    The directory in which the log and parameter output files are placed.
-    char      ParFile       [FILENAMESIZE]              ;   //!<    The location of the parameter file for the Main Controller Unit.
-    char      ParFileDNPC   [FILENAMESIZE]              ;   //!<    The location of the DNPC parameter file.
-    char      ParStamp      [FILENAMESIZE]              ;   //!<    A date and time stamp of the parameter file.
-    char      DatDir        [FILENAMESIZE]              ;   //!<    The directory in which the aerodynamic data is located.
-    char      dllDNPC       [FILENAMESIZE]              ;   //!<    The DLL for the DNPC library.
-    char      dllGUI        [FILENAMESIZE]              ;   //!<    The DLL for the GUI Interface Server.
-    //@}
-    
+    /* ---- Hot block ------------------------------------------------------------ */
+
     //! \name   General fixed Parameters.
     //@{
-    int       Log_ON                                    ;   //!<    Generate logfile, yes (1) or no (0).
-    REAL      Ts                                        ;   //!<    The time step between to iterations of the controller.     
-    REAL      iGB                                       ;   //!<    Gearbox Ratio.  
-    REAL      ToptCoef                                  ;   //!<    Optimal coefficient in variable speed reg. 
-    REAL      Wmax                                      ;   //!<    Maximum generator speed.                    
-    REAL      Wmin                                      ;   //!<    Minimum generator speed.                    
-    REAL      OmgRat                                    ;   //!<    Rated generator speed.                      
-    REAL      Prat                                      ;   //!<    Rated power.                                
+    _Alignas( PLAT_CACHELINE )
+    REAL      Ts                                        ;   //!<    The time step between to iterations of the controller.
+    REAL      iGB                                       ;   //!<    Gearbox Ratio.
+    REAL      ToptCoef                                  ;   //!<    Optimal coefficient in variable speed reg.
+    REAL      Wmax                                      ;   //!<    Maximum generator speed.
+    REAL      Wmin                                      ;   //!<    Minimum generator speed.
+    REAL      OmgRat                                    ;   //!<    Rated generator speed.
+    REAL      Prat                                      ;   //!<    Rated power.
     REAL      Trat                                      ;   //!<    Rated generator torque.
-    int       ToptCurveN                                ;   //!<    Optimal curve in variable speed reg. look-up table
-    REAL      ToptCurveOmg[ MAX_SCHED_SIZE ]            ;   //!<    Optimal curve in variable speed reg. look-up table 
-    REAL      ToptCurveTor[ MAX_SCHED_SIZE ]            ;   //!<    Optimal curve in variable speed reg. look-up table
     REAL      CutOffPitchRateMax                        ;   //!<    Maximum pitch rate (cutoff).
     REAL      CutOffPitchRateMin                        ;   //!<    Minimum pitch rate (cutoff).
     REAL      CutOffPitchAngleMax                       ;   //!<    Maximum pitch rate (cutoff).
     REAL      CutOffPitchAngleMin                       ;   //!<    Minimum pitch rate (cutoff).
-    int       StepResponse_Mode                         ;   //!<    Step response mode
     REAL      StepResponse_Amplitude                    ;   //!<    Step response amplitude
     REAL      StepResponse_Time                         ;   //!<    Step response time
     REAL      pitchOffset[3]                            ;   //!<    Pitch Offset (For simulation)
-    
+    REAL      Shed_Budget                               ;   //!<    Time budget of a sample [s], low-criticality tasks are deferred when it is exceeded (0 disables the load shedding).
+    int       ToptCurveN                                ;   //!<    Optimal curve in variable speed reg. look-up table
+    int       StepResponse_Mode                         ;   //!<    Step response mode
+    int       Log_ON                                    ;   //!<    Generate logfile, yes (1) or no (0).
+    int       Log_Decimation[2]                         ;   //!<    Rate divisor and phase offset of the logfile, i.e. one line every Log_Decimation[0] samples.
+    int       Shed_Recovery                             ;   //!<    Number of samples within the budget before the last deferred task is resumed.
     //@}
-    
+
     //! \name   Rotor-speed and power controller
     //@{
-    REAL      RotSpd_Pit_damp[ N_NFP_FILTERS ]          ;   //!<    Damping factor in variable frequency notch filter in pitch controller 
+    REAL      RotSpd_Pit_damp[ N_NFP_FILTERS ]          ;   //!<    Damping factor in variable frequency notch filter in pitch controller
     REAL      RotSpd_Tor_damp[ N_NFP_FILTERS ]          ;   //!<    Damping factor in variable frequency notch filter in torque controller
     REAL      RotSpd_Torq_RateMax                       ;   //!<    The maximum allowable torque rate output of the rotor speed torque controller.
     REAL      RotSpd_Torq_RateMin                       ;   //!<    The minimum allowable torque rate output of the rotor speed torque controller.
     REAL      RotSpd_Torq_Min                           ;   //!<    The minimum allowable torque to overcome generator losses .
-    int       RotSpd_Torq_Sched_N                       ;   //!<    The number of elements in the torque gain scheduale.
-    REAL      RotSpd_Torq_Schedule[ MAX_SCHED_SIZE ]    ;   //!<    The x axis of the torque gain scheduale on the basis of power.
-    REAL      RotSpd_Torq_Kp[ MAX_SCHED_SIZE ]          ;   //!<    The proportional gain scheduale of the torque controller.
-    REAL      RotSpd_Torq_Ti[ MAX_SCHED_SIZE ]          ;   //!<    The integral gain scheduale of the torque controller.
-    REAL      RotSpd_Torq_Td[ MAX_SCHED_SIZE ]          ;   //!<    The differential gain scheduale of the torque controller.
-    REAL      RotSpd_Pit_Max                            ;   //!<    The maximum pitch angle output of the rotor speed pitch controller. 
+    REAL      RotSpd_Pit_Max                            ;   //!<    The maximum pitch angle output of the rotor speed pitch controller.
     REAL      RotSpd_Pit_Min                            ;   //!<    The minimum pitch angle output of the rotor speed pitch controller.
-    REAL      RotSpd_Pit_RateMax                        ;   //!<    The maximum pitch rate output of the rotor speed pitch controller. 
-    REAL      RotSpd_Pit_RateMin                        ;   //!<    The minimum pitch rate output of the rotor speed pitch controller. 
+    REAL      RotSpd_Pit_RateMax                        ;   //!<    The maximum pitch rate output of the rotor speed pitch controller.
+    REAL      RotSpd_Pit_RateMin                        ;   //!<    The minimum pitch rate output of the rotor speed pitch controller.
+    REAL      RotSpd_TorqSlope                          ;   //!<    Slope in switch between torque + pitch.
+    int       RotSpd_Torq_Sched_N                       ;   //!<    The number of elements in the torque gain scheduale.
     int       RotSpd_Pit_Sched_N                        ;   //!<    The number of elements in the pitch gain schedule.
-    REAL      RotSpd_Pit_Schedule[ MAX_SCHED_SIZE ]     ;   //!<    The x axis of the pitch gain schedule on the basis of power.
-    REAL      RotSpd_Pit_Kp[ MAX_SCHED_SIZE ]           ;   //!<    The proportional gain schedule of the pitch controller.
-    REAL      RotSpd_Pit_Ti[ MAX_SCHED_SIZE ]           ;   //!<    The integral gain schedule of the pitch controller.
-    REAL      RotSpd_Pit_Td[ MAX_SCHED_SIZE ]           ;   //!<    The differential gain schedule of the pitch controller.
     int       RotSpd_FinePit_Sched_N                    ;   //!<    The number of elements in the fine pitch schedule.
-    REAL      RotSpd_FinePit_Schedule[ MAX_SCHED_SIZE ] ;   //!<    The x axis of the pitch gain schedule on the basis of pitch angle.
-    REAL      RotSpd_FinePit_Angle[ MAX_SCHED_SIZE ]    ;   //!<    The fine pitch angle schedule. 
     int       RotSpd_PowFlag                            ;   //!<    Constant power flag, used in powerproduction() to which to a mode which attamtes to reduce overpoewer.
-    REAL      RotSpd_TorqSlope                          ;   //!<    Slope in switch between torque + pitch.
-
-
-
-    //@}  
+    int       RotSpd_SchedRate[2]                       ;   //!<    Rate divisor and phase offset of the gain and fine pitch schedule lookups.
+    //@}
 
     //! \name   Active damping of tower drivetrain oscillations by Torque.
-    //@{        
-    int       DTdamp_ON                                 ;   //!<    Drivetrain damping on [1] or off [0]
+    //@{
     REAL      RotSpd_DT_damp[ N_NFP_FILTERS ]           ;   //!<    Damping factors in variable frequency notch filter in DT-damper
     REAL      DTdamp_Min                                ;   //!<    Minimum torque for Drivetrain Damping Controller
     REAL      DTdamp_Max                                ;   //!<    Maximum torque for Drivetrain Damping Controller
@@ -108,35 +99,19 @@ typedef struct mcu_data_static{
     REAL      DTdamp_Kp                                 ;   //!<    Proportional gain of Drivetrain Damping Controller
     REAL      DTdamp_Ki                                 ;   //!<    Integral gain of Drivetrain Damping Controller
     REAL      DTdamp_Kd                                 ;   //!<    Differential gain of Drivetrain Damping Controller
-    //@} 
+    int       DTdamp_ON                                 ;   //!<    Drivetrain damping on [1] or off [0]
+    //@}
 
-    //! \name   Active damping of tower FA motion by collective pitch.    
-    //@{        
-    int       FAdamp_ON                                 ;   //!<    On/Off switch of the Fore-Aft. damping controller base_fa_damping().
+    //! \name   Active damping of tower FA motion by collective pitch.
+    //@{
     REAL      FAAcc_damp[ N_NFP_FILTERS ]               ;   //!<    Damping factors in variable frequency notch filter in FA-damper
+    int       FAdamp_ON                                 ;   //!<    On/Off switch of the Fore-Aft. damping controller base_fa_damping().
     int       FAdamp_Sched_N                            ;   //!<    The number of elements in the PID gain schedule of the FA controller.
-    REAL      FAdamp_Schedule[ MAX_SCHED_SIZE ]         ;   //!<    The x axis of the PID gain schedule based on the collective pitch angle.
-    REAL      FAdamp_Kp[ MAX_SCHED_SIZE ]               ;   //!<    The proportional gain schedule of the FA controller.
-    REAL      FAdamp_Ki[ MAX_SCHED_SIZE ]               ;   //!<    The integral gain schedule of the FA controller.
-    REAL      FAdamp_Kd[ MAX_SCHED_SIZE ]               ;   //!<    The differential gain schedule of the FA controller.
     int       FAdamp_AmpSched_N                         ;   //!<    The number of eleements in the activation schedule of the FA controller.
-    REAL      FAdamp_AmpSchedule[ MAX_SCHED_SIZE ]      ;   //!<    The x axis of the activation schedule of the FA controller, power based.
-    REAL      FAdamp_Amplitude[ MAX_SCHED_SIZE ]        ;   //!<    The amplitude, varies between 0 and 1 to switch on the FA controller depending on the power output.
     //@}
 
-
-    
-    //! \name  Pitch-follow controller settings.
-    //@{    
-    int       PitFollow_ON                              ;   //!<    On/Off switch of the base_pitfollow() controller. 
-    REAL      PitFollowGain [3]                         ;   //!<    The proportional, Integal and differential controller gains.
-    REAL      PitFollowCons [4]                         ;   //!<    The maximum and minimum pitch angle [rad] and pitch rate [rad/s] outputs of the pitch follow controllers.
-    //@}
-    
     //! \name  Yaw controler settings.
     //@{
-    int       Yaw_ON                                    ;   //!<    On/Off switch of the base_yaw_control() controller. 
-    int       Yaw_Mode                                  ;   //!<    Switch between yaw by IPC base on yaw rate (2), yaw by IPC original (1) or yaw by motors (0).
     REAL      Yaw_Setpoint                              ;   //!<    The fixed setpoint of the yaw controller.
     REAL      YawMot_HystFrac                           ;   //!<    Hysteresis fraction yaw misalignment deadband used in yaw by motors.
     REAL      YawMot_ErDB                               ;   //!<    Yaw misalignment deadband used in yaw by motors.
@@ -145,36 +120,144 @@ typedef struct mcu_data_static{
     REAL      YawIPC_Min                                ;   //!<    The minimum moment the yaw by IPC controller can output.
     REAL      YawIPC_RateMax                            ;   //!<    The maximum moment rate the yaw by IPC controller can output.
     REAL      YawIPC_RateMin                            ;   //!<    The minimum moment rate the yaw by IPC controller can output.
+    int       Yaw_ON                                    ;   //!<    On/Off switch of the base_yaw_control() controller.
+    int       Yaw_Rate[2]                               ;   //!<    Rate divisor and phase offset of the base_yaw_control() controller, its filters and PID run at Ts*Yaw_Rate[0].
+    int       Yaw_Mode                                  ;   //!<    Switch between yaw by IPC base on yaw rate (2), yaw by IPC original (1) or yaw by motors (0).
     int       YawIPC_Sched_N                            ;   //!<    The number of elements in the yaw by IPC gain schedule.
-    REAL      YawIPC_Schedule[ MAX_SCHED_SIZE ]         ;   //!<    The x axis of the yaw by IPC gain schedule.    
-    REAL      YawIPC_Kp[ MAX_SCHED_SIZE ]               ;   //!<    The proportional gain schedule of the yaw by IPC controller.
-    REAL      YawIPC_Ti[ MAX_SCHED_SIZE ]               ;   //!<    The integral time constant schedule of the yaw by IPC controller.
-    REAL      YawIPC_Td[ MAX_SCHED_SIZE ]               ;   //!<    The differential time constant schedule of the yaw by IPC controller.
-    //@}        
+    //@}
 
     //! \name Fast shutdown parameters
-    //@{    
+    //@{
     REAL    Shutdown_PitchRate                          ;   //!<    Pitch rate for open-loop shutdown (positive)
     REAL    Shutdown_TorqueRate                         ;   //!<    Torque rate for open-loop shutdown (negative)
     //@}
 
+    //! \name Derived constants, computed from the parameters by mcu_derive()
+    //@{
+    REAL      FAdamp_Fade                               ;   //!<    Decay per sample of the demanded pitch of the FA damping controller, exp(-Ts/Tfade).
+    REAL      Yaw_Ts                                    ;   //!<    Sample time of the base_yaw_control() controller, Ts*Yaw_Rate[0].
+    //@}
+
+    /* ---- Cold block ----------------------------------------------------------- */
+
+    //! \name   Gain schedules and lookup tables, the number of entries is in the hot block.
+    //@{
+    _Alignas( PLAT_CACHELINE )
+    REAL      ToptCurveOmg[ MAX_SCHED_SIZE ]            ;   //!<    Optimal curve in variable speed reg. look-up table
+    REAL      ToptCurveTor[ MAX_SCHED_SIZE ]            ;   //!<    Optimal curve in variable speed reg. look-up table
+    REAL      RotSpd_Torq_Schedule[ MAX_SCHED_SIZE ]    ;   //!<    The x axis of the torque gain scheduale on the basis of power.
+    REAL      RotSpd_Torq_Kp[ MAX_SCHED_SIZE ]          ;   //!<    The proportional gain scheduale of the torque controller.
+    REAL      RotSpd_Torq_Ti[ MAX_SCHED_SIZE ]          ;   //!<    The integral gain scheduale of the torque controller.
+    REAL      RotSpd_Torq_Td[ MAX_SCHED_SIZE ]          ;   //!<    The differential gain scheduale of the torque controller.
+    REAL      RotSpd_Pit_Schedule[ MAX_SCHED_SIZE ]     ;   //!<    The x axis of the pitch gain schedule on the basis of power.
+    REAL      RotSpd_Pit_Kp[ MAX_SCHED_SIZE ]           ;   //!<    The proportional gain schedule of the pitch controller.
+    REAL      RotSpd_Pit_Ti[ MAX_SCHED_SIZE ]           ;   //!<    The integral gain schedule of the pitch controller.
+    REAL      RotSpd_Pit_Td[ MAX_SCHED_SIZE ]           ;   //!<    The differential gain schedule of the pitch controller.
+    REAL      RotSpd_FinePit_Schedule[ MAX_SCHED_SIZE ] ;   //!<    The x axis of the pitch gain schedule on the basis of pitch angle.
+    REAL      RotSpd_FinePit_Angle[ MAX_SCHED_SIZE ]    ;   //!<    The fine pitch angle schedule.
+    REAL      FAdamp_Schedule[ MAX_SCHED_SIZE ]         ;   //!<    The x axis of the PID gain schedule based on the collective pitch angle.
+    REAL      FAdamp_Kp[ MAX_SCHED_SIZE ]               ;   //!<    The proportional gain schedule of the FA controller.
+    REAL      FAdamp_Ki[ MAX_SCHED_SIZE ]               ;   //!<    The integral gain schedule of the FA controller.
+    REAL      FAdamp_Kd[ MAX_SCHED_SIZE ]               ;   //!<    The differential gain schedule of the FA controller.
+    REAL      FAdamp_AmpSchedule[ MAX_SCHED_SIZE ]      ;   //!<    The x axis of the activation schedule of the FA controller, power based.
+    REAL      FAdamp_Amplitude[ MAX_SCHED_SIZE ]        ;   //!<    The amplitude, varies between 0 and 1 to switch on the FA controller depending on the power output.
+    REAL      YawIPC_Schedule[ MAX_SCHED_SIZE ]         ;   //!<    The x axis of the yaw by IPC gain schedule.
+    REAL      YawIPC_Kp[ MAX_SCHED_SIZE ]               ;   //!<    The proportional gain schedule of the yaw by IPC controller.
+    REAL      YawIPC_Ti[ MAX_SCHED_SIZE ]               ;   //!<    The integral time constant schedule of the yaw by IPC controller.
+    REAL      YawIPC_Td[ MAX_SCHED_SIZE ]               ;   //!<    The differential time constant schedule of the yaw by IPC controller.
+    //@}
+
+    //! \name   Configuration settings
+    //@{
+    char      LogDir        [FILENAMESIZE]              ;   //!<    The directory in which the log and parameter output files are placed.
+    char      ParFile       [FILENAMESIZE]              ;   //!<    The location of the parameter file for the Main Controller Unit.
+    char      ParFileDNPC   [FILENAMESIZE]              ;   //!<    The location of the DNPC parameter file.
+    char      ParStamp      [FILENAMESIZE]              ;   //!<    A date and time stamp of the parameter file.
+    char      DatDir        [FILENAMESIZE]              ;   //!<    The directory in which the aerodynamic data is located.
+    char      dllDNPC       [FILENAMESIZE]              ;   //!<    The DLL for the DNPC library.
+    char      dllGUI        [FILENAMESIZE]              ;   //!<    The DLL for the GUI Interface Server.
+    char      ShadowConfig  [FILENAMESIZE]              ;   //!<    The configuration file of a shadow controller, "none" to run without.
+    REAL      Init_Budget                               ;   //!<    Time budget of the initialization [s], a warning is given when it is exceeded (0 disables the warning).
+    //@}
+
+    //! \name  Pitch-follow controller settings.
+    //@{
+    int       PitFollow_ON                              ;   //!<    On/Off switch of the base_pitfollow() controller.
+    REAL      PitFollowGain [3]                         ;   //!<    The proportional, Integal and differential controller gains.
+    REAL      PitFollowCons [4]                         ;   //!<    The maximum and minimum pitch angle [rad] and pitch rate [rad/s] outputs of the pitch follow controllers.
+    //@}
+
 } mcu_data_static; 
 
 
 /*! \struct mcu_data_dynamic
     \brief  Struct containing dynamic data for the MCU. I.e. Filters with states, etc.
+
+    The struct and all its filters, PIDs and matrices are one contiguous block
+    of memory (an \ref arena) in the arena of the instance, with the objects 
+    behind the struct in the order in which the run samples access them, see 
+    init_mcudatadynamic().
+
+    The members from iSample on are the image of the run-time state: a
+    checkpoint transfers them with a single copy, after which the pointers to
+    the objects are restored by carving the block again. A new member which
+    is passed on from sample to sample belongs in the image, a member which
+    belongs to the instance (e.g. the schedule, or memory outside the block)
+    in front of it.
  */
 typedef struct mcu_data_dynamic{
 
+    //! \name Memory block
+    //@{
+    size_t    Mem_Size                                  ;   //!<    Size of the block of the struct and its objects [bytes].
+    int       Mem_Blocks                                ;   //!<    Bit per block of #MCU_BLOCKS: its objects are part of the block, see compact_mcudatadynamic().
+    matrix    Startup_Ramp                              ;   //!<    Third order pitch ramp of the start-up procedure, outside the block, memory is allocated by thirdord().
+    //@}
+
+    //! \name Static schedule
+    //@{
+    int       Block_Active[ MCU_NR_BLOCKS ]             ;   //!<    Flag per block of #MCU_BLOCKS: executed in the run samples (1) or removed from the schedule (0).
+    int       Block_Count                               ;   //!<    Number of blocks executed in the run samples.
+    //@}
+
+    //! \name Shared input preprocessing
+    //@{
+    const struct mcu_data_dynamic * Pre_Lead            ;   //!<    Controller of which the filtered rotor speed is reused (shadow controller), NULL to filter it here.
+    int       Pre_Batch                                 ;   //!<    Flag indicating that the rotor speed of this sample has been filtered by base_controller_batch().
+    REAL      Pre_OmR_P[ N_FILTERS + 1 ]                ;   //!<    Rotor speed after each filter of the pitch controller series, in this sample.
+    REAL      Pre_OmR_T[ N_FILTERS + 1 ]                ;   //!<    Rotor speed after each filter of the torque controller series, in this sample.
+    //@}
+
+    //! \name Multi-rate scheduling
+    //@{
+    unsigned long long iSample                          ;   //!<    Number of run samples since initialization, see #RATE_DUE. 64 bits, a 32-bit long wraps after 2^31 samples.
+    //@}
+
+    //! \name Load shedding
+    //@{
+    int       Shed_Level                                ;   //!<    Number of deferred tasks, the first Shed_Level tasks of #MCU_SHEDTASKS are skipped.
+    int       Shed_Within                               ;   //!<    Number of consecutive samples within the budget.
+    long      Shed_Overruns                             ;   //!<    Number of samples which exceeded the budget.
+    long      Shed_Count[ MCU_NR_SHEDTASKS ]            ;   //!<    Number of samples in which each task was deferred.
+    //@}
+
+    //! \name Numerical health
+    //@{
+    long      Health_Count[ HEALTH_NR_EVENTS ]          ;   //!<    Number of reset and snapped states per event of #health_event.
+    //@}
+
     //! \name Optimal rotor speed and power controller
     //@{    
     Filter  * RotSpd_Pit[ N_FILTERS ]                   ;   //!<    Optional series of filter for rotor speed used by the rotor speed pitch controller.
     Filter  * RotSpd_Tor[ N_FILTERS ]                   ;   //!<    Optional series of filter for rotor speed used by the rotor speed torque controller.
+    FilterChain RotSpd_Pit_Chain                        ;   //!<    Active filters of RotSpd_Pit.
+    FilterChain RotSpd_Tor_Chain                        ;   //!<    Active filters of RotSpd_Tor.
     Filter  * RotSpd_SCHED                              ;   //!<    Rotor speed filter used for schedules.
     Filter  * RotSpd_FDBCK                              ;   //!<    Rotor speed filter used for feedback in variable speed region.
     REAL      RotSpd_SchedSpd                           ;   //!<    The filtered rotor speed used for schedules.
     REAL      RotSpd_FdbckSpd                           ;   //!<    The filtered rotor speed used for feedback in variable speed region.
     REAL 	  RotSpd_FinePitch    						;
+    int       RotSpd_StepFinished                       ;   //!<    Flag indicating that the step response experiment has been completed.
 
     Filter  * Power_LPF                                 ;   //!<    Power filter used for schedules.
     Filter  * Pitch_LPF                                 ;   //!<    Collective pitch angle filter used for schedules. 
@@ -182,6 +265,8 @@ typedef struct mcu_data_dynamic{
     PID     * PID_RotSpd_Pitch                          ;   //!<    The rotor speed pitch PID controller.    
     REAL      RotSpd_Dem_Pitch                          ;   //!<    The demanded collective pitch angle of the pitch rotor speed controller.
     REAL      RotSpd_Dem_Torq                           ;   //!<    The demanded torque output by the torque rotor speed controller.
+    REAL      RotSpd_Torq_Gains[3]                      ;   //!<    Discrete Kp, Ki and Kd of the torque controller from the last schedule lookup.
+    REAL      RotSpd_Pit_Gains[3]                       ;   //!<    Discrete Kp, Ki and Kd of the pitch controller from the last schedule lookup.
     //@}
 
     //! \name 
@@ -189,15 +274,18 @@ typedef struct mcu_data_dynamic{
     Filter  * FA_SpdMinLim_LPF                          ;   //!<    Filter on speed limits in FA damping.
     Filter  * FA_SpdMaxLim_LPF                          ;   //!<    Filter on speed limits in FA damping.    
     Filter  * FAAcc[ N_FILTERS ]                        ;   //!<    Filters on FA Acceleration.
+    FilterChain FAAcc_Chain                             ;   //!<    Active filters of FAAcc.
     PID     * PID_FAdamp                                ;   //!<    FA damping PID for collective pitch
     REAL      FAdamp_Dem_Pitch                          ;   //!<    Demand collective pitch of FA damping controller.
     REAL      FAdamp_Dem_Pitch_Filt                          ;   //!<    Demand collective pitch of FA damping controller.
+    Filter  * FAdamp_HPF                                ;   //!<    Second order highpass filter ensuring a zero-mean FA damping output.
     //@}
 
 
     //! \name Drivetrain damping data
     //@{      
     Filter  * DTrtsp[ N_FILTERS ]                       ;   //!<    Filter series for the drivetrain damper
+    FilterChain DTrtsp_Chain                            ;   //!<    Active filters of DTrtsp.
     PID     * PID_DTdamp                                ;   //!<    DT damping PID for torque.
     REAL      DTdamp_Dem_Torq                           ;   //!<    The output of the drivetrain damping PID controller.
     REAL      DTdamp_Dem_Torq_FILT                      ;   //!<    Filtered version of the demanded torque of the drivetrain damping PID controller.
@@ -220,8 +308,19 @@ typedef struct mcu_data_dynamic{
     REAL       DemYawMoment                             ;   //!<    Demanded IPC yaw moment.
     //@}
 
+    //! \name Start-up procedure
+    //@{   
+    int        Startup_SubState                         ;   //!<    Internal substate of the start-up procedure.
+    int        Startup_ThirdFlag                        ;   //!<    Flag indicating that the third order pitch ramp has been generated.
+    int        Startup_ThirdCount                       ;   //!<    Index of the next set point of the third order pitch ramp, the ramp is Startup_Ramp.
+    //@}
+
 } mcu_data_dynamic; 
 
+//! Size of the block of mcu_data_dynamic and its objects [bytes]: 4 filter sequences and 10 filters, 5 PIDs and the pitch demand.
+#define MCUD_BLOCK_SIZE     ( ARENA_SIZE( sizeof(mcu_data_dynamic) ) + ( 4 * (N_FILTERS) + 10 ) * FILTER_ARENA_SIZE + \
+                              5 * PID_ARENA_SIZE + MAT_ARENA_SIZE( NR_BLADES, 1 ) )
+
 #endif
 
 /* ------------------------------------------------------------------------------ */
@@ -229,15 +328,16 @@ typedef struct mcu_data_dynamic{
  
 //! Allocation of memory for the mcu_data_static struct.
 /*!
+    \param a        [in+out]    The arena of the instance, the struct starts on a cache line.
     \param pInputs  [in]    An array with all required inputs into the controller. The properties of the array and indexes of individual variables are described in signal_definitions_internal.h underneath \"IO of the MCU\".
-    \return A new instance of the mcu_data_static struct is returned.
+    \return A new instance of the mcu_data_static struct is returned, NULL if the arena only counts or is exhausted.
 */
-mcu_data_static * init_mcudatastatic( const REAL * pInputs );
+mcu_data_static * init_mcudatastatic( mem_arena * a, const REAL * pInputs );
 
 
 //! Freeing the memory occupied by the mcu_data_static struct.
 /*!
-    \param MCUS        Pointer to the mcu_data_static struct of which the memory should be released.
+    \param MCUS        Pointer to the mcu_data_static struct of which the memory should be released. The struct itself is part of the arena of the instance.
     
     \return        A non zero int will be returned in the case an error occurred.
 */
@@ -246,23 +346,61 @@ int free_mcudatastatic( mcu_data_static * MCUS );
 
 //! Allocation of memory for the mcu_data_dynamic struct.
 /*!
+    \param a        [in+out]    The arena of the instance, the block starts on a cache line.
     \param MCUS     [in]    The dynamic struct is based on the parameters defined in the static struct.
     \param pInputs  [in]    An array with all required inputs into the controller. The properties of the array and indexes of individual variables are described in signal_definitions_internal.h underneath \"IO of the MCU\".
     
-    \return A new instance of the mcu_data_dynamic struct is returned.
+    The struct and all its filters, PIDs and matrices are carved as one 
+    block, of which the size is counted by a first pass over the objects.
+    The objects of all blocks of #MCU_BLOCKS are carved, since the 
+    parameter files are read before the schedule is known.
+
+    \return A new instance of the mcu_data_dynamic struct is returned, NULL if the arena only counts or is exhausted.
 */
-mcu_data_dynamic * init_mcudatadynamic( mcu_data_static * MCUS, const REAL * pInputs );
+mcu_data_dynamic * init_mcudatadynamic( mem_arena * a, mcu_data_static * MCUS, const REAL * pInputs );
+
+
+//! Move the struct to a new arena, without the objects of the blocks which are removed from the schedule.
+/*!
+    After the schedule is built (see mcu_schedule()), the filters and PIDs of 
+    the drivetrain damping, the fore-aft damping and the yaw control are only
+    needed when their block is executed in the run samples, and when their 
+    module is compiled. The struct and the objects which are still needed 
+    are copied to a new block in the arena a, the pointers to the left out 
+    objects are set to NULL. A block without objects is never executed 
+    again, not even at the exit (see mcu_block()). The old block is 
+    released with the old arena of the instance.
+
+    \param a       [in+out]    The new arena of the instance, the block starts on a cache line.
+    \param MCUD    [in]        The dynamic struct, with a complete schedule.
+    \return        The dynamic struct in its new block, which replaces MCUD. NULL if the arena only counts or is exhausted.
+*/
+mcu_data_dynamic * compact_mcudatadynamic( mem_arena * a, const mcu_data_dynamic * MCUD );
 
 
 //! Freeing the memory occupied by the mcu_data_dynamic struct.
 /*!
-    \param MCUD    Pointer to the mcu_data_dynamic struct of which the memory should be released.    
+    \param MCUD    Pointer to the mcu_data_dynamic struct of which the memory should be released. The block itself is part of the arena of the instance, only the start-up ramp is released.
     
     \return        A non zero int will be returned in the case an error occurred.
 */
 int free_mcudatadynamic( mcu_data_dynamic * MCUD );
 
 
+//! Save or restore the mcu_data_dynamic struct with a checkpoint.
+/*!
+    The image of the run-time state (see #mcu_data_dynamic) is transferred
+    as one block of bytes, followed by the start-up ramp. #CKPT_VERSION needs 
+    to be incremented when the members or the objects of the image change.
+
+    \param s       [in,out]    The checkpoint stream, its mode sets the direction.
+    \param MCUD    [in,out]    The dynamic struct to save or restore.
+
+    \return        A non zero int will be returned in the case the checkpoint does not fit.
+*/
+int mcu_checkpoint( ckpt_stream * s, mcu_data_dynamic * MCUD );
+
+
 //! Read the mcu input file
 /*!
 
@@ -301,6 +439,73 @@ int  mcureadplc(
 
 );
 
+//! Check if a low-criticality task is deferred in the current sample.
+/*!
+    \param MCUD     [in]    The dynamic data of the MCU.
+    \param iTask    [in]    The task, see #MCU_SHEDTASKS.
+    \param iStatus  [in]    Simulation status, tasks are only deferred during #MCU_STATUS_RUN.
+    \return         TRUE if the task should be skipped.
+*/
+int mcu_shed( const mcu_data_dynamic * MCUD, const int iTask, const int iStatus );
+
+//! Update the load shedding after a run sample.
+/*!
+    Each sample which exceeds MCUS->Shed_Budget defers one more task of 
+    #MCU_SHEDTASKS in the following samples, the pitch and torque control and
+    the supervisory triggers are never deferred. After MCUS->Shed_Recovery
+    consecutive samples within the budget the last deferred task is resumed.
+
+    \param MCUS     [in]        The static data of the MCU.
+    \param MCUD     [in+out]    The dynamic data of the MCU.
+    \param dElapsed [in]        Execution time of the sample [s].
+*/
+void mcu_shed_update( const mcu_data_static * MCUS, mcu_data_dynamic * MCUD, const REAL dElapsed );
+
+//! Build the static schedule of the controller blocks at initialization.
+/*!
+    The blocks of #MCU_BLOCKS form a graph: each block reads and writes a set
+    of signals, the actuator outputs and the log array are the sinks. Going
+    back from the sinks, a block is kept when one of its outputs is read by a
+    kept block or reaches a sink. The graph depends on the configuration: the 
+    drivetrain damping, fore-aft damping and yaw actions only reach the 
+    actuators when DTdamp_ON, FAdamp_ON and Yaw_ON are set, and the log array 
+    is only a sink when it is written to the log file (Log_ON) or read by 
+    the simulation package (Bladed and Matlab). The objects of the removed 
+    blocks are left out by compact_mcudatadynamic().
+
+    \param MCUS     [in]        The static data of the MCU.
+    \param MCUD     [in+out]    The dynamic data of the MCU.
+    \param iDevice  [in]        System which is running the simulation.
+    \param cMessage [in+out]    The schedule is appended to the message.
+    \return         The number of blocks in the schedule.
+*/
+int mcu_schedule( const mcu_data_static * MCUS, mcu_data_dynamic * MCUD, const int iDevice, char * cMessage );
+
+//! Compute the constants which only depend on the parameters.
+/*!
+    The step functions use the values which are derived from the parameters 
+    and the sample time, e.g. the fade of the FA damping, the sample time of 
+    the yaw controller and the gains and constraints of the drivetrain 
+    damping PID, instead of evaluating them every sample. The function is 
+    called after the parameter files are read, and again when a parameter is 
+    changed by mcureadplc(), so the derived values stay consistent with the 
+    parameters.
+
+    \param MCUS     [in+out]    The static data of the MCU.
+    \param MCUD     [in+out]    The dynamic data of the MCU.
+    \return         A non zero int will be returned in the case an error occurred.
+*/
+int mcu_derive( mcu_data_static * MCUS, mcu_data_dynamic * MCUD );
+
+//! Check if a block is executed in the current sample.
+/*!
+    \param MCUD     [in]    The dynamic data of the MCU.
+    \param iBlock   [in]    The block, see #MCU_BLOCKS.
+    \param iStatus  [in]    Simulation status, all blocks of which the objects are allocated are executed outside #MCU_STATUS_RUN.
+    \return         TRUE if the block should be executed.
+*/
+int mcu_block( const mcu_data_dynamic * MCUD, const int iBlock, const int iStatus );
+
 #endif
 
 /** @}*/
@@ -14,47 +14,127 @@
 #include "./mcudata.h"
 
 
+/* Start of the image of the run-time state, see mcu_data_dynamic */
+#define MCUD_IMAGE      offsetof( mcu_data_dynamic, iSample )
+
+/* The objects of a block are part of the memory block */
+#define MCUD_HAS( iBlocks, iBlock )     ( ( (iBlocks) >> (iBlock) ) & 1 )
+
+/* All blocks, the objects of every block are part of the memory block */
+#define MCUD_ALL_BLOCKS ( ( 1 << MCU_NR_BLOCKS ) - 1 )
+
+/* Groups of consecutive objects in the memory block */
+enum mcud_groups {
+
+    MCUD_GROUP_BASE     ,   /* The struct, the rotor speed controller and the scheduling filters */
+    MCUD_GROUP_DTDAMP   ,   /* Objects of the drivetrain damping block */
+    MCUD_GROUP_FADAMP   ,   /* Objects of the fore-aft damping block */
+    MCUD_GROUP_YAW      ,   /* Objects of the yaw control block */
+    MCUD_GROUP_TAIL     ,   /* The demanded pitch angles */
+    MCUD_NR_GROUPS
+};
+
+
+/* ---------------------------------------------------------------------------------
+ Carve a filter or a PID from the block, at initialization with its initial values
+--------------------------------------------------------------------------------- */
+static Filter * mcud_filter( mem_arena * a, const int bInit )
+{
+    return bInit ? filter_initArena( a ) : filter_carve( a );
+}
+
+static PID * mcud_pid( mem_arena * a, const int bInit )
+{
+    return bInit ? pid_initArena( a ) : pid_carve( a );
+}
+
+/* ---------------------------------------------------------------------------------
+ Layout of the block: the struct, followed by its filters, PIDs and matrices in
+ the order in which the modules access them in a run sample. Carving again on a 
+ copy of the block restores its pointers, without touching the data. Only the 
+ objects of iBlocks are carved, the start of every group is stored in nGroup.
+--------------------------------------------------------------------------------- */
+static void mcud_layout( mem_arena * a, mcu_data_dynamic * MCUD, const int bInit, const int iBlocks, 
+    size_t nGroup[ MCUD_NR_GROUPS + 1 ] )
+{
+    int i, bHas;
+
+    /* The struct itself */
+    nGroup[ MCUD_GROUP_BASE ] = a->nUsed;
+    arena_carve( a, sizeof(mcu_data_dynamic) );
+
+    /* Rotor speed filter sequences of the pitch and torque controllers */
+    for ( i = 0; i < N_FILTERS; ++i ) {
+        MCUD->RotSpd_Pit[ i ] = mcud_filter( a, bInit );
+        MCUD->RotSpd_Tor[ i ] = mcud_filter( a, bInit );
+    }
+    /* Filters for scheduling */
+    MCUD->RotSpd_SCHED      = mcud_filter( a, bInit );
+    MCUD->RotSpd_FDBCK      = mcud_filter( a, bInit );
+    MCUD->Power_LPF         = mcud_filter( a, bInit );
+    MCUD->Pitch_LPF         = mcud_filter( a, bInit );
+    /* PIDs for rotor speed controller */
+    MCUD->PID_RotSpd_Torq   = mcud_pid( a, bInit );
+    MCUD->PID_RotSpd_Pitch  = mcud_pid( a, bInit );
+
+    /* Drivetrain damping: filter sequence, PID and post processing filter */
+    nGroup[ MCUD_GROUP_DTDAMP ] = a->nUsed;
+    bHas = MCUD_HAS( iBlocks, MCU_BLOCK_DTDAMP );
+    for ( i = 0; i < N_FILTERS; ++i )
+        MCUD->DTrtsp[ i ]   = bHas ? mcud_filter( a, bInit ) : NULL;
+    MCUD->PID_DTdamp        = bHas ? mcud_pid( a, bInit )    : NULL;
+    MCUD->DTpost_NF1F       = bHas ? mcud_filter( a, bInit ) : NULL;
+
+    /* FA damping: filter sequence, speed limits, zero-mean highpass filter and PID */
+    nGroup[ MCUD_GROUP_FADAMP ] = a->nUsed;
+    bHas = MCUD_HAS( iBlocks, MCU_BLOCK_FADAMP );
+    for ( i = 0; i < N_FILTERS; ++i )
+        MCUD->FAAcc[ i ]    = bHas ? mcud_filter( a, bInit ) : NULL;
+    MCUD->FA_SpdMinLim_LPF  = bHas ? mcud_filter( a, bInit ) : NULL;
+    MCUD->FA_SpdMaxLim_LPF  = bHas ? mcud_filter( a, bInit ) : NULL;
+    MCUD->FAdamp_HPF        = bHas ? mcud_filter( a, bInit ) : NULL;
+    MCUD->PID_FAdamp        = bHas ? mcud_pid( a, bInit )    : NULL;
+
+    /* Yaw control */
+    nGroup[ MCUD_GROUP_YAW ] = a->nUsed;
+    bHas = MCUD_HAS( iBlocks, MCU_BLOCK_YAW );
+    MCUD->YawMot_Err_LPF    = bHas ? mcud_filter( a, bInit ) : NULL;
+    MCUD->YawIPC_Err_LPF    = bHas ? mcud_filter( a, bInit ) : NULL;
+    MCUD->PID_YawIPC        = bHas ? mcud_pid( a, bInit )    : NULL;
+
+    /* Storage for total demanded pitch angles */
+    nGroup[ MCUD_GROUP_TAIL ] = a->nUsed;
+    MCUD->DemPitch          = mat_carve( a, NR_BLADES, 1 );
+
+    nGroup[ MCUD_NR_GROUPS ] = a->nUsed;
+}
+
+
 /* ---------------------------------------------------------------------------------
  Constructor of the mcu_data_dynamic struct. Here all memory for data arrays needs 
- to be allocated.
+ to be carved from the arena of the instance.
 --------------------------------------------------------------------------------- */
-mcu_data_dynamic * init_mcudatadynamic( mcu_data_static * MCUS, const REAL * pInputs )
+mcu_data_dynamic * init_mcudatadynamic( mem_arena * a, mcu_data_static * MCUS, const REAL * pInputs )
 {
+    mcu_data_dynamic   Count;
+    mcu_data_dynamic * MCUD;
+    mem_arena          b = { NULL, 0, 0 };
+    size_t             nGroup[ MCUD_NR_GROUPS + 1 ];
     int i;
     
-    /* Allocate memory for the struct */
-    mcu_data_dynamic * MCUD = (mcu_data_dynamic*) calloc( 1, sizeof(mcu_data_dynamic) );
+    /* Count the size of the block, with the objects of all blocks */
+    mcud_layout( &b, &Count, FALSE, MCUD_ALL_BLOCKS, nGroup );
     
-    /* Initialize filter sequences*/
-    for ( i = 0; i < N_FILTERS; ++i ) {
-        MCUD->RotSpd_Pit[ i ] = filter_initEmpty( );
-        MCUD->RotSpd_Tor[ i ] = filter_initEmpty( );
-        MCUD->DTrtsp[ i ]     = filter_initEmpty( );
-        MCUD->FAAcc[ i ]      = filter_initEmpty( );
-    }
-    /* Initialize filters for scheduling */
-    MCUD->RotSpd_SCHED      = filter_initEmpty( );
-    MCUD->RotSpd_FDBCK      = filter_initEmpty( );
-    MCUD->Power_LPF         = filter_initEmpty( );
-    MCUD->Pitch_LPF         = filter_initEmpty( );
-    /* Initialize filters for speed limits in FA damping */
-    MCUD->FA_SpdMinLim_LPF  = filter_initEmpty();
-    MCUD->FA_SpdMaxLim_LPF  = filter_initEmpty();
-    /* Initalize post procesing filter */
-    MCUD->DTpost_NF1F       = filter_initEmpty( );
-
-    /* Initialize filters for yaw control */
-    MCUD->YawMot_Err_LPF    = filter_initEmpty();
-    MCUD->YawIPC_Err_LPF    = filter_initEmpty();
+    /* Carve the block of the struct and its objects */
+    MCUD = (mcu_data_dynamic*) arena_carve_line( a, b.nUsed );
+    if ( MCUD == NULL ) return NULL;
     
-    /* PIDs for rotor speed controller */
-    MCUD->PID_RotSpd_Torq   = pid_initEmpty( );
-    MCUD->PID_RotSpd_Pitch  = pid_initEmpty( );
-    MCUD->PID_FAdamp        = pid_initEmpty( );
-    MCUD->PID_DTdamp        = pid_initEmpty( );
-    /* Initialize PID for yaw control */
-    MCUD->PID_YawIPC        = pid_initEmpty();
-
+    b.pBase = (char*) MCUD;
+    b.nSize = b.nUsed;
+    b.nUsed = 0;
+    mcud_layout( &b, MCUD, TRUE, MCUD_ALL_BLOCKS, nGroup );
+    MCUD->Mem_Size   = b.nSize;
+    MCUD->Mem_Blocks = MCUD_ALL_BLOCKS;
     
     /* Demanded values of rotor speed controller (this is overwritten later) */
     MCUD->RotSpd_Dem_Pitch  = pInputs[ I_MCU_IN_MEAS_PITCHANGLE1 ] / R_(NR_BLADES) ;
@@ -71,7 +151,6 @@ mcu_data_dynamic * init_mcudatadynamic( mcu_data_static * MCUS, const REAL * pIn
     /* Intialize DT damping demanded value */
     MCUD->DTdamp_Dem_Torq   = R_(0.0);
     /* Initialize storage for total demanded pitch angles */
-    MCUD->DemPitch          = mat_initEmpty( NR_BLADES, 1 );
     MCUD->DemPitch->Mat[0]  = pInputs[ I_MCU_IN_MEAS_PITCHANGLE1 ] ;
     MCUD->DemPitch->Mat[1]  = pInputs[ I_MCU_IN_MEAS_PITCHANGLE2 ] ;
 #if NR_BLADES == 3          
@@ -82,6 +161,19 @@ mcu_data_dynamic * init_mcudatadynamic( mcu_data_static * MCUS, const REAL * pIn
     /* Initialize demanded values for yaw control */
     MCUD->DemYawRate        = R_(0.0);  
     MCUD->DemYawMoment      = R_(0.0);  
+    /* Multi-rate tasks count from the first run sample */
+    MCUD->iSample             = 0;
+    /* Nothing is deferred by the load shedding, the counters are cleared by calloc */
+    MCUD->Shed_Level          = 0;
+    /* All blocks are executed until the schedule is built */
+    for ( i = 0; i < MCU_NR_BLOCKS; ++i ) MCUD->Block_Active[i] = 1;
+    MCUD->Block_Count         = MCU_NR_BLOCKS;
+    /* Step response and start-up procedure start from scratch */
+    MCUD->RotSpd_StepFinished = 0;
+    MCUD->Startup_SubState    = 0;
+    MCUD->Startup_ThirdFlag   = 0;
+    MCUD->Startup_ThirdCount  = 0;
+    MCUD->Startup_Ramp.Mat    = NULL;
     
     /* Return allocated memory */
     
@@ -90,46 +182,103 @@ mcu_data_dynamic * init_mcudatadynamic( mcu_data_static * MCUS, const REAL * pIn
 } /* end of constructer for the mcu_data_dynamic struct */
 
 
+/* ---------------------------------------------------------------------------------
+ Copy the struct and the objects of the scheduled blocks to a block in a new arena
+--------------------------------------------------------------------------------- */
+mcu_data_dynamic * compact_mcudatadynamic( mem_arena * a, const mcu_data_dynamic * MCUD )
+{
+    mcu_data_dynamic   Count;
+    mcu_data_dynamic * pNew;
+    mem_arena          b = { NULL, 0, 0 };
+    size_t             nOld[ MCUD_NR_GROUPS + 1 ], nNew[ MCUD_NR_GROUPS + 1 ];
+    int                iBlocks = MCUD->Mem_Blocks, g;
+
+    /* The objects of the removed blocks, and of the modules which are not compiled */
+    for ( g = 0; g < MCU_NR_BLOCKS; ++g )
+        if ( !MCUD->Block_Active[g] ) iBlocks &= ~( 1 << g );
+#ifndef _DTDAMP
+    iBlocks &= ~( 1 << MCU_BLOCK_DTDAMP );
+#endif
+#ifndef _FADAMP
+    iBlocks &= ~( 1 << MCU_BLOCK_FADAMP );
+#endif
+#ifndef _YAW
+    iBlocks &= ~( 1 << MCU_BLOCK_YAW );
+#endif
+
+    /* Blocks without objects are always part of the memory block */
+    iBlocks |= MCUD_ALL_BLOCKS & ~( ( 1 << MCU_BLOCK_DTDAMP ) | ( 1 << MCU_BLOCK_FADAMP ) | ( 1 << MCU_BLOCK_YAW ) );
+
+    /* Groups of the current and the new block */
+    mcud_layout( &b, &Count, FALSE, MCUD->Mem_Blocks, nOld );
+    b.nUsed = 0;
+    mcud_layout( &b, &Count, FALSE, iBlocks, nNew );
+
+    pNew = (mcu_data_dynamic*) arena_carve_line( a, b.nUsed );
+    if ( pNew == NULL ) return NULL;
+
+    /* The groups which are kept have the same layout in both blocks */
+    for ( g = 0; g < MCUD_NR_GROUPS; ++g )
+        memcpy( (char*) pNew + nNew[g], (const char*) MCUD + nOld[g], nNew[g+1] - nNew[g] );
+
+    b.pBase = (char*) pNew;
+    b.nSize = b.nUsed;
+    b.nUsed = 0;
+    mcud_layout( &b, pNew, FALSE, iBlocks, nNew );
+    pNew->Mem_Size   = b.nSize;
+    pNew->Mem_Blocks = iBlocks;
+
+    /* The start-up ramp is outside the arena, the copy of the struct refers to it */
+    return pNew;
+
+} /* end of compaction of the mcu_data_dynamic struct */
+
+
 /* ---------------------------------------------------------------------------------
  Destructor of mcu_data_dynamic struct. Here all memory for data arrays needs to
  be released.
 --------------------------------------------------------------------------------- */
 int free_mcudatadynamic( mcu_data_dynamic * MCUD )
 {
-    int i ;
-    
-    for ( i =0; i < N_FILTERS; ++i ) {
-        filter_free ( MCUD->RotSpd_Pit[ i ] );
-        filter_free ( MCUD->RotSpd_Tor[ i ] );
-        filter_free ( MCUD->DTrtsp[ i ]     );
-        filter_free ( MCUD->FAAcc[ i ]      );
-    }
-    filter_free( MCUD->RotSpd_SCHED     );
-    filter_free( MCUD->RotSpd_FDBCK     );
-    filter_free( MCUD->Power_LPF        );
-    filter_free( MCUD->Pitch_LPF        );
-    filter_free( MCUD->FA_SpdMinLim_LPF );
-    filter_free( MCUD->FA_SpdMaxLim_LPF );
-    filter_free( MCUD->DTpost_NF1F      );
-    filter_free( MCUD->YawMot_Err_LPF   );
-    filter_free( MCUD->YawIPC_Err_LPF   );
-    
-    pid_free( MCUD->PID_RotSpd_Torq     );
-    pid_free( MCUD->PID_RotSpd_Pitch    );
-    pid_free( MCUD->PID_FAdamp          );
-    pid_free( MCUD->PID_DTdamp          );
-    pid_free( MCUD->PID_YawIPC          );
-
+    /* The filters, PIDs and matrices are part of the block of the struct */
     
-    mat_free( MCUD->DemPitch );
+    /* Ramp of the start-up procedure is allocated by thirdord() */
+    if ( MCUD->Startup_Ramp.Mat != NULL ) free( MCUD->Startup_Ramp.Mat );
 
-    free( MCUD );
+    /* The block itself is released with the arena */
     
     return MCU_OK;
     
 } /* end of destructor for the mcu_data_static struct */
 
 
+/* ---------------------------------------------------------------------------------
+ Transfer the mcu_data_dynamic struct to or from a checkpoint. The image of the 
+ run-time state is transferred as a whole, its pointers are restored from the 
+ layout of the block.
+--------------------------------------------------------------------------------- */
+int mcu_checkpoint( ckpt_stream * s, mcu_data_dynamic * MCUD )
+{
+    mem_arena a = { (char*) MCUD, MCUD->Mem_Size, 0 };
+    size_t    nGroup[ MCUD_NR_GROUPS + 1 ];
+    int iError = MCU_OK;
+
+    /* The layout of the objects is fixed by the blocks, the size of the image checks it */
+    iError += ckpt_check( s, MCUD->Mem_Blocks );
+    iError += ckpt_check( s, (int)( MCUD->Mem_Size - MCUD_IMAGE ) );
+    if ( iError > MCU_OK ) return iError;
+
+    iError += ckpt_bytes( s, (char*) MCUD + MCUD_IMAGE, MCUD->Mem_Size - MCUD_IMAGE );
+    if ( s->iMode == CKPT_RESTORE ) mcud_layout( &a, MCUD, FALSE, MCUD->Mem_Blocks, nGroup );
+
+    /* Start-up procedure, the length of the ramp is only known at run time */
+    iError += ckpt_matrix_alloc( s, &MCUD->Startup_Ramp );
+
+    return iError;
+
+} /* end of checkpoint of the mcu_data_dynamic struct */
+
+
 /* ---------------------------------------------------------------------------------
  end mcudatadynamic.c
 --------------------------------------------------------------------------------- */
@@ -16,14 +16,15 @@
 
 /* ---------------------------------------------------------------------------------
  Constructor of mcu_data_static struct. Here all memory for data arrays needs to
- be allocated.
+ be carved from the arena of the instance.
 --------------------------------------------------------------------------------- */
-mcu_data_static * init_mcudatastatic( const REAL * pInputs )
+mcu_data_static * init_mcudatastatic( mem_arena * a, const REAL * pInputs )
 {
 
-    /* Allocate memory for the struct */
+    /* Carve the struct, the hot block starts on a cache line */
     
-    mcu_data_static * MCUS = (mcu_data_static*) calloc( 1, sizeof(mcu_data_static) );
+    mcu_data_static * MCUS = (mcu_data_static*) arena_carve_line( a, sizeof(mcu_data_static) );
+    if ( MCUS == NULL ) return NULL;
     
     /* Set values from input array */
     
@@ -45,7 +46,19 @@ mcu_data_static * init_mcudatastatic( const REAL * pInputs )
     MCUS->PitFollow_ON              = 0 ;
     MCUS->StepResponse_Mode         = MCU_STEP_NONE;
 
-    MCUS->pitchOffset[3]			    = R_(0.0);
+    /* All tasks run every sample unless the parameter file defines a rate divisor */
+    MCUS->Log_Decimation[0]         = 1 ;
+    MCUS->RotSpd_SchedRate[0]       = 1 ;
+    MCUS->Yaw_Rate[0]               = 1 ;
+
+    /* No load shedding unless the parameter file defines a budget */
+    MCUS->Shed_Budget               = R_(0.0);
+    MCUS->Shed_Recovery             = 100 ;
+    MCUS->Init_Budget               = R_(0.0);
+
+    MCUS->pitchOffset[0]            = R_(0.0);
+    MCUS->pitchOffset[1]            = R_(0.0);
+    MCUS->pitchOffset[2]            = R_(0.0);
 
     /* Return the pointer to the created struct */
     
@@ -55,8 +68,8 @@ mcu_data_static * init_mcudatastatic( const REAL * pInputs )
 
 
 /* ---------------------------------------------------------------------------------
- Destructor of mcu_data_static struct. Here all memory for data arrays needs to
- be released.
+ Destructor of mcu_data_static struct. Here all memory outside the arena of the
+ instance needs to be released.
 --------------------------------------------------------------------------------- */
 int free_mcudatastatic( mcu_data_static * MCUS )
 {
@@ -64,8 +77,7 @@ int free_mcudatastatic( mcu_data_static * MCUS )
     
     /* The static struct defines not other variables besides standard types */
 
-    /* Release memory of the struct itself */
-    free( MCUS );
+    /* The struct itself is released with the arena */
     
     return MCU_OK;
     
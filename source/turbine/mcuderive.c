@@ -0,0 +1,61 @@
+/* ---------------------------------------------------------------------------------
+ *          file : mcuderive.c                                                    *
+ *   description : C-source file, constants derived from the MCU parameters       *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+
+#include "./../signals/signal_definitions_internal.h"
+#include "./../signals/signal_definitions_custom.h"
+
+#include "./../suplib/suplib.h"
+
+#include "./mcudata.h"
+
+
+#define FADAMP_TFADE    R_(50.0)    /* Time constant of the fade of the FA damping demand [s] */
+
+/* ---------------------------------------------------------------------------------
+ Compute the constants which only depend on the parameters
+--------------------------------------------------------------------------------- */
+int mcu_derive( mcu_data_static * MCUS, mcu_data_dynamic * MCUD )
+{
+    int iError = MCU_OK;
+
+    /* Fade of the FA damping demand */
+    MCUS->FAdamp_Fade = R_EXP( (-MCUS->Ts) / FADAMP_TFADE );
+
+    /* The yaw controller runs once every Yaw_Rate[0] samples */
+    MCUS->Yaw_Ts = MCUS->Ts * MCUS->Yaw_Rate[0];
+
+    /* The drivetrain damping PID has fixed gains and constraints */
+    if ( MCUD->PID_DTdamp == NULL ) return iError;
+
+    iError += pid_setGains_sca(
+
+        MCUD->PID_DTdamp     ,
+        MCUS->DTdamp_Kp      ,
+        MCUS->DTdamp_Ki      ,
+        MCUS->DTdamp_Kd      ,
+        MCUS->Ts
+
+    );
+
+    iError += pid_setConstraints_sca(
+
+        MCUD->PID_DTdamp     ,
+        MCUS->DTdamp_Min     ,
+        MCUS->DTdamp_Max     ,
+        MCUS->DTdamp_RateMin ,
+        MCUS->DTdamp_RateMax
+
+    );
+
+    return iError;
+
+} /* end mcu_derive() */
+
+/* ---------------------------------------------------------------------------------
+ end mcuderive.c
+--------------------------------------------------------------------------------- */
@@ -35,7 +35,7 @@ int mcu_readfile (
     FILE *fidInFile, *fidOutFile;
     char cInFile[200], cOutFile[200];
     char cDate [13];
-    struct tm * clock;    
+    struct tm * clock, tmDate;    
     struct stat attrib; 
     time_t now;
 
@@ -53,7 +53,7 @@ int mcu_readfile (
     /* Obtain modification time of par-file */
 
     stat( cInFile, &attrib );
-    clock = gmtime(&(attrib.st_mtime));
+    clock = plat_gmtime( &(attrib.st_mtime), &tmDate );
     strftime( cDate, 20, "%d/%m/%Y at %H:%M", clock);
     
     strcat( cMessage, "[mcu]  Loaded <" );
@@ -78,7 +78,7 @@ int mcu_readfile (
     strcat( cOutFile, ".PAR" );
     iCall++;
     
-    if ( ( fidOutFile = fopen ( cOutFile, "w" ) ) == NULL ) {
+    if ( ( fidOutFile = par_echo_open( cOutFile ) ) == NULL ) {
     
         strcat( cMessage, "[mcu]  <err> Unable to open <" );
         strcat( cMessage, cOutFile );
@@ -101,6 +101,10 @@ int mcu_readfile (
     fprintf( fidOutFile, "\n");
     
     iError += par_readline_i ( fidInFile, fidOutFile, &MCUS->Log_ON   , "LogFile"      );
+    iError += par_readline_rate ( fidInFile, fidOutFile, MCUS->Log_Decimation, "Log_Decimation" );
+    iError += par_readline_d ( fidInFile, fidOutFile, &MCUS->Shed_Budget   , "Shed_Budget"   );
+    iError += par_readline_i ( fidInFile, fidOutFile, &MCUS->Shed_Recovery , "Shed_Recovery" );
+    iError += par_readline_d ( fidInFile, fidOutFile, &MCUS->Init_Budget   , "Init_Budget"   );
 
     iError += par_readline_d ( fidInFile, fidOutFile, &MCUS->iGB      , "GearboxRatio" );
     iError += par_readline_d ( fidInFile, fidOutFile, &MCUS->ToptCoef , "ToptCoef"     );
@@ -174,6 +178,8 @@ int mcu_readfile (
     iError += par_readline_i ( fidInFile, fidOutFile, &MCUS->RotSpd_PowFlag,   "ConstantPowerFlag" );
     iError += par_readline_d ( fidInFile, fidOutFile, &MCUS->RotSpd_TorqSlope, "SwitchSlopeTorq"   );
     
+    iError += par_readline_rate ( fidInFile, fidOutFile, MCUS->RotSpd_SchedRate, "RotSpd_SchedRate" );
+    
     fprintf( fidOutFile,"\n\n");
     fprintf( fidOutFile, "* DT-damping controller settings * \n");
     fprintf( fidOutFile, "\n");
@@ -225,12 +231,14 @@ int mcu_readfile (
     fprintf( fidOutFile, "\n");
     
     iError += par_readline_i ( fidInFile, fidOutFile, &MCUS->Yaw_ON          , "YAWCONTROL"            );
+    iError += par_readline_rate ( fidInFile, fidOutFile, MCUS->Yaw_Rate     , "Yaw_Rate"              );
 
     iError += par_readline_i ( fidInFile, fidOutFile, &MCUS->Yaw_Mode        , "Yaw_Mode"              );
     iError += par_readline_d ( fidInFile, fidOutFile, &MCUS->Yaw_Setpoint    , "Yaw_Setpoint"          );
     
-    iError += par_readfilt_fxd ( fidInFile, fidOutFile,  MCUD->YawMot_Err_LPF , "YawMot_Err_LPF", T_LOWPASS,  MCUS->Ts );
-    iError += par_readfilt_fxd ( fidInFile, fidOutFile,  MCUD->YawIPC_Err_LPF , "YawIPC_Err_LPF", T_LOWPASS,  MCUS->Ts );
+    /* The yaw filters are discretized at the rate of the yaw controller */
+    iError += par_readfilt_fxd ( fidInFile, fidOutFile,  MCUD->YawMot_Err_LPF , "YawMot_Err_LPF", T_LOWPASS,  MCUS->Ts * MCUS->Yaw_Rate[0] );
+    iError += par_readfilt_fxd ( fidInFile, fidOutFile,  MCUD->YawIPC_Err_LPF , "YawIPC_Err_LPF", T_LOWPASS,  MCUS->Ts * MCUS->Yaw_Rate[0] );
     
     iError += par_readline_d ( fidInFile, fidOutFile, &MCUS->YawMot_HystFrac    , "YawMot_HystFrac"       );
     iError += par_readline_d ( fidInFile, fidOutFile, &MCUS->YawMot_ErDB        , "YawMot_ErDB"           );
@@ -262,7 +270,7 @@ int mcu_readfile (
     /* Close file */
     
     fclose( fidInFile );
-    fclose( fidOutFile );
+    par_echo_close( fidOutFile );
     
     return 0;
     
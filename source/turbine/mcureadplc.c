@@ -179,6 +179,9 @@ int  mcureadplc(
 	}
 
 
+	/* Recompute the constants which are derived from the changed parameter */
+	if ( iError == MCU_OK ) iError += mcu_derive( g_MCUS, g_MCUD );
+
 	mita_free( text_input->alltext );
 	mita_free( text_input );
 	return iError;
@@ -0,0 +1,153 @@
+/* ---------------------------------------------------------------------------------
+ *          file : mcuschedule.c                                                  *
+ *   description : C-source file, static schedule of the controller blocks        *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+
+#include "./../signals/signal_definitions_internal.h"
+#include "./../signals/signal_definitions_custom.h"
+#include "./../signals/signal_definitions_external.h"
+
+#include "./../suplib/suplib.h"
+
+#include "./mcudata.h"
+
+
+/* Signals which connect the blocks, one bit each */
+enum mcu_block_signals {
+
+    SIG_MEASUREMENTS    = 0x001 ,   /* Measured inputs of the controller */
+    SIG_ROTSPD          = 0x002 ,   /* Filtered rotor speed and the scheduling speed */
+    SIG_SCHED           = 0x004 ,   /* Filtered power and pitch for the gain schedules */
+    SIG_ROTSPD_DEM      = 0x008 ,   /* Demanded pitch and torque of the rotor speed controller */
+    SIG_DTDAMP_DEM      = 0x010 ,   /* Demanded torque of the drivetrain damping */
+    SIG_FADAMP_DEM      = 0x020 ,   /* Demanded pitch of the fore-aft damping */
+    SIG_YAW_DEM         = 0x040 ,   /* Demanded yaw rate and moment */
+    SIG_ACTUATORS       = 0x080 ,   /* Sink: the outputs of the controller */
+    SIG_LOG             = 0x100     /* Sink: the log array */
+};
+
+/* LOGB_<Block> is 1 when the block stores one of its log channels in this build, the
+   channels of LOG_STORE() in the block. A block without a stored channel does not
+   write the log array, its other outputs decide whether it is scheduled. */
+#define LOGB_ROTORSPEED   ( LOGS_BASE_SPD_TORQ_MIN || LOGS_BASE_SPD_TORQ_MAX || LOGS_BASE_SPD_TORQ_MIN_SPD || \
+                            LOGS_BASE_SPD_TORQ_MAX_SPD || LOGS_BASE_SPD_TORQ_KP || LOGS_BASE_SPD_TORQ_KI || \
+                            LOGS_BASE_SPD_TORQ_KD || LOGS_BASE_SPD_TORQ_ERROR || LOGS_BASE_SPD_TORQ_SETPOINT || \
+                            LOGS_BASE_SPD_TORQ_PIDOUT || LOGS_BASE_SPD_PIT_MIN || LOGS_BASE_SPD_PIT_MAX || \
+                            LOGS_BASE_SPD_PIT_MIN_SPD || LOGS_BASE_SPD_PIT_MAX_SPD || LOGS_BASE_SPD_PIT_KP || \
+                            LOGS_BASE_SPD_PIT_KI || LOGS_BASE_SPD_PIT_KD || LOGS_BASE_SPD_PIT_ERROR || \
+                            LOGS_BASE_SPD_PIT_SETPOINT || LOGS_BASE_SPD_PIT_PIDOUT || LOGS_BASE_TP_SELECT )
+#define LOGB_BASE_LOG     ( LOGS_BASE_SPD_RTSP || LOGS_BASE_SPD_RTSP_P_HPF || LOGS_BASE_SPD_RTSP_P_NFP || \
+                            LOGS_BASE_SPD_RTSP_P_NFF || LOGS_BASE_SPD_RTSP_P_LPF || LOGS_BASE_SPD_RTSP_T_HPF || \
+                            LOGS_BASE_SPD_RTSP_T_NFP || LOGS_BASE_SPD_RTSP_T_NFF || LOGS_BASE_SPD_RTSP_T_LPF || \
+                            LOGS_BASE_SPD_RTSP_SCHED || LOGS_BASE_SPD_POW || LOGS_BASE_SPD_POW_LPF || LOGS_BASE_SPD_PITCH || \
+                            LOGS_BASE_SPD_PITCH_LPF || LOGS_BASE_SPD_DEM_TORQ || LOGS_BASE_SPD_DEM_PITCH )
+#define LOGB_DTDAMP       ( LOGS_BASE_DTD_OMR || LOGS_BASE_DTD_OMR_HPF || LOGS_BASE_DTD_OMR_NFP || LOGS_BASE_DTD_OMR_NFF || \
+                            LOGS_BASE_DTD_OMR_LPF || LOGS_BASE_DTD_MIN || LOGS_BASE_DTD_MAX || LOGS_BASE_DTD_MIN_SPD || \
+                            LOGS_BASE_DTD_MAX_SPD || LOGS_BASE_DTD_KP || LOGS_BASE_DTD_KI || LOGS_BASE_DTD_KD || \
+                            LOGS_BASE_DTD_ERROR || LOGS_BASE_DTD_SETPOINT || LOGS_BASE_DTD_PIDOUT || LOGS_BASE_DTD_DEM_TORQ || \
+                            LOGS_BASE_DTD_DEM_TORQ_FILT )
+#define LOGB_FADAMP       ( LOGS_BASE_FAD_FOREAFTACC || LOGS_BASE_FAD_FOREAFTACC_HPF || LOGS_BASE_FAD_FOREAFTACC_NFP || \
+                            LOGS_BASE_FAD_FOREAFTACC_NFF || LOGS_BASE_FAD_FOREAFTACC_LPF || LOGS_BASE_FAD_PITSPD_MIN || \
+                            LOGS_BASE_FAD_PITSPD_MAX || LOGS_BASE_FAD_PITSPD_MIN_LPF || LOGS_BASE_FAD_PITSPD_MAX_LPF || \
+                            LOGS_BASE_FAD_MIN || LOGS_BASE_FAD_MAX || LOGS_BASE_FAD_MIN_SPD || LOGS_BASE_FAD_MAX_SPD || \
+                            LOGS_BASE_FAD_KP || LOGS_BASE_FAD_KI || LOGS_BASE_FAD_KD || LOGS_BASE_FAD_ERROR || \
+                            LOGS_BASE_FAD_SETPOINT || LOGS_BASE_FAD_PIDOUT || LOGS_BASE_FAD_AMPLITUDE || \
+                            LOGS_BASE_FAD_DEM_PIT )
+#define LOGB_YAW          ( LOGS_BASE_YAWIPC_ERR || LOGS_BASE_YAWIPC_ERR_LPF || LOGS_BASE_YAWIPC_MAX || LOGS_BASE_YAWIPC_MIN || \
+                            LOGS_BASE_YAWIPC_RATEMAX || LOGS_BASE_YAWIPC_RATEMIN || LOGS_BASE_YAWIPC_KP || \
+                            LOGS_BASE_YAWIPC_KI || LOGS_BASE_YAWIPC_KD || LOGS_BASE_YAWMOT_ERR || LOGS_BASE_YAWMOT_ERR_LPF || \
+                            LOGS_BASE_YAWMOT_ACTIVE || LOGS_BASE_YAW_SETPOINT || LOGS_BASE_YAW_MODE || \
+                            LOGS_BASE_YAW_DEMYAWRATE || LOGS_BASE_YAW_DEMYAWMOMENT )
+#define LOGB_OPER_LOG     ( LOGS_OPER_MEAS_GENSPEED || LOGS_OPER_MEAS_AZIMUTH || LOGS_OPER_MEAS_FAACC || \
+                            LOGS_OPER_MEAS_SWACC || LOGS_OPER_MEAS_GENTORQUE || LOGS_OPER_MEAS_TIME || \
+                            LOGS_OPER_MEAS_ELECPOWER || LOGS_OPER_MEAS_YAWERROR || LOGS_OPER_MEAS_TIMESTEP || \
+                            LOGS_OPER_MEAS_GRIDCONT || LOGS_OPER_MEAS_ACTTYPE || LOGS_OPER_MEAS_BENOUT1 || \
+                            LOGS_OPER_MEAS_BENOUT2 || LOGS_OPER_MEAS_BENIN1 || LOGS_OPER_MEAS_BENIN2 || \
+                            LOGS_OPER_MEAS_PITCH1 || LOGS_OPER_MEAS_PITCH2 || LOGS_OPER_MEAS_HUBWIND || \
+                            LOGS_OPER_DEM_GENTORQUE || LOGS_OPER_DEM_YAWRATE || LOGS_OPER_DEM_PITCH1 || LOGS_OPER_DEM_PITCH2 || \
+                            LOGS_OPER_DEM_PITCH3 || LOGS_OPER_MEAS_BENOUT3 || LOGS_OPER_MEAS_BENIN3 || LOGS_OPER_MEAS_PITCH3 || \
+                            LOGS_OPER_SHED_LEVEL || LOGS_OPER_SHED_OVERRUNS )
+
+#define SIG_LOG_IF(LogB)    ( (LogB) ? SIG_LOG : 0 )
+
+/* A block and the signals it reads and writes */
+typedef struct mcu_block_def {
+    const char    * cName       ;
+    unsigned int    iInputs     ;
+    unsigned int    iOutputs    ;
+} mcu_block_def;
+
+/* The graph of #MCU_BLOCKS, in the order of execution */
+static const mcu_block_def sBlocks[ MCU_NR_BLOCKS ] = {
+
+    { "ROTSPD_FILTERS" , SIG_MEASUREMENTS                                  , SIG_ROTSPD                      },
+    { "SCHED_FILTERS"  , SIG_ROTSPD | SIG_ROTSPD_DEM                       , SIG_SCHED                       },
+    { "ROTORSPEED"     , SIG_ROTSPD | SIG_SCHED                            , SIG_ROTSPD_DEM | SIG_LOG_IF( LOGB_ROTORSPEED ) },
+    { "BASE_LOG"       , SIG_MEASUREMENTS | SIG_ROTSPD | SIG_SCHED | SIG_ROTSPD_DEM , SIG_LOG_IF( LOGB_BASE_LOG ) },
+    { "DTDAMP"         , SIG_MEASUREMENTS | SIG_ROTSPD                     , SIG_DTDAMP_DEM | SIG_LOG_IF( LOGB_DTDAMP )     },
+    { "FADAMP"         , SIG_MEASUREMENTS | SIG_ROTSPD | SIG_SCHED | SIG_ROTSPD_DEM , SIG_FADAMP_DEM | SIG_LOG_IF( LOGB_FADAMP ) },
+    { "YAW"            , SIG_MEASUREMENTS | SIG_SCHED                      , SIG_YAW_DEM | SIG_LOG_IF( LOGB_YAW )           },
+    { "ACTUATORS"      , SIG_ROTSPD_DEM | SIG_DTDAMP_DEM | SIG_FADAMP_DEM | SIG_YAW_DEM , SIG_ACTUATORS  },
+    { "OPER_LOG"       , SIG_MEASUREMENTS | SIG_ACTUATORS                  , SIG_LOG_IF( LOGB_OPER_LOG )                    }
+};
+
+/* ---------------------------------------------------------------------------------
+ Build the static schedule of the controller blocks
+--------------------------------------------------------------------------------- */
+int mcu_schedule( const mcu_data_static * MCUS, mcu_data_dynamic * MCUD, const int iDevice, char * cMessage )
+{
+    unsigned int iInputs[ MCU_NR_BLOCKS ], iRead;
+    int k;
+
+    for ( k = 0; k < MCU_NR_BLOCKS; ++k ) iInputs[k] = sBlocks[k].iInputs;
+
+    /* Switched off actions do not reach the actuators */
+    if ( !MCUS->DTdamp_ON ) iInputs[ MCU_BLOCK_ACTUATORS ] &= ~SIG_DTDAMP_DEM;
+    if ( !MCUS->FAdamp_ON ) iInputs[ MCU_BLOCK_ACTUATORS ] &= ~SIG_FADAMP_DEM;
+    if ( !MCUS->Yaw_ON    ) iInputs[ MCU_BLOCK_ACTUATORS ] &= ~SIG_YAW_DEM;
+
+    /* The sinks, the log array is only read by the log file and by some simulation packages. The
+    blocks only write it when they have a channel which is stored in this build, see LOGB_<Block>. */
+    iRead = SIG_ACTUATORS;
+    if ( MCUS->Log_ON || iDevice == BLADED || iDevice == MATLAB ) iRead |= SIG_LOG;
+
+    /* A block is kept when another kept block or a sink reads one of its outputs */
+    MCUD->Block_Count = 0;
+    for ( k = MCU_NR_BLOCKS - 1; k >= 0; --k ) {
+        MCUD->Block_Active[k] = ( sBlocks[k].iOutputs & iRead ) != 0;
+        if ( MCUD->Block_Active[k] ) {
+            iRead |= iInputs[k];
+            MCUD->Block_Count++;
+        }
+    }
+
+    sprintf( cMessage + strlen( cMessage ), "[mcu]  Schedule: %d of %d blocks", MCUD->Block_Count, MCU_NR_BLOCKS );
+    if ( MCUD->Block_Count < MCU_NR_BLOCKS ) {
+        strcat( cMessage, ", removed" );
+        for ( k = 0; k < MCU_NR_BLOCKS; ++k )
+            if ( !MCUD->Block_Active[k] ) sprintf( cMessage + strlen( cMessage ), " %s", sBlocks[k].cName );
+    }
+    strcat( cMessage, "\t\n" );
+
+    return MCUD->Block_Count;
+
+} /* end mcu_schedule() */
+
+/* ---------------------------------------------------------------------------------
+ Check if a block is executed in the current sample
+--------------------------------------------------------------------------------- */
+int mcu_block( const mcu_data_dynamic * MCUD, const int iBlock, const int iStatus )
+{
+    /* Initialization and exit execute all blocks of which the objects are allocated */
+    if ( iStatus != MCU_STATUS_RUN ) return ( MCUD->Mem_Blocks >> iBlock ) & 1;
+
+    return MCUD->Block_Active[ iBlock ];
+
+} /* end mcu_block() */
+
+/* ---------------------------------------------------------------------------------
+ end mcuschedule.c
+--------------------------------------------------------------------------------- */
@@ -0,0 +1,56 @@
+/* ---------------------------------------------------------------------------------
+ *          file : mcushed.c                                                      *
+ *   description : C-source file, deadline-aware load shedding of the MCU         *
+ *       toolbox : DotX Wind Turbine Control Software                             *
+ *        author : DotX Control Solutions, www.dotxcontrol.com                    *
+--------------------------------------------------------------------------------- */
+
+
+#include "./../signals/signal_definitions_internal.h"
+#include "./../signals/signal_definitions_custom.h"
+
+#include "./../suplib/suplib.h"
+
+#include "./mcudata.h"
+
+
+/* ---------------------------------------------------------------------------------
+ Check if a low-criticality task is deferred in the current sample
+--------------------------------------------------------------------------------- */
+int mcu_shed( const mcu_data_dynamic * MCUD, const int iTask, const int iStatus )
+{
+    /* Initialization and exit are never shed */
+    if ( iStatus != MCU_STATUS_RUN ) return FALSE;
+
+    return ( iTask < MCUD->Shed_Level );
+
+} /* end mcu_shed() */
+
+/* ---------------------------------------------------------------------------------
+ Update the load shedding after a run sample
+--------------------------------------------------------------------------------- */
+void mcu_shed_update( const mcu_data_static * MCUS, mcu_data_dynamic * MCUD, const REAL dElapsed )
+{
+    int k;
+
+    /* Count the tasks which were deferred in this sample */
+    for ( k = 0; k < MCUD->Shed_Level; ++k ) MCUD->Shed_Count[k]++;
+
+    /* Over budget: defer one more task in the next samples */
+    if ( dElapsed > MCUS->Shed_Budget ) {
+        MCUD->Shed_Overruns++;
+        MCUD->Shed_Within = 0;
+        MCUD->Shed_Level  = MIN( MCUD->Shed_Level + 1, MCU_NR_SHEDTASKS );
+    }
+
+    /* Within budget: resume the last deferred task after Shed_Recovery samples */
+    else if ( MCUD->Shed_Level > 0 && ++MCUD->Shed_Within >= MCUS->Shed_Recovery ) {
+        MCUD->Shed_Within = 0;
+        MCUD->Shed_Level--;
+    }
+
+} /* end mcu_shed_update() */
+
+/* ---------------------------------------------------------------------------------
+ end mcushed.c
+--------------------------------------------------------------------------------- */